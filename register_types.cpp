@@ -45,4 +45,5 @@ void register_rtile_map_types() {
 }
 
 void unregister_rtile_map_types() {
+    RTileMap::finish_quadrant_update_work_pool();
 }
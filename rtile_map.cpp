@@ -30,11 +30,80 @@
 
 #include "rtile_map.h"
 
+#include "core/io/compression.h"
 #include "core/io/marshalls.h"
 
 #include "servers/navigation_2d_server.h"
 #include "servers/physics_2d_server.h"
 #include "core/engine.h"
+#include "core/os/os.h"
+#include "core/sort_array.h"
+#include "geometry_2d.h"
+#include "scene/resources/rectangle_shape_2d.h"
+
+int RTileMapQuadrant::find_cell(const Vector2i &p_coords, const Vector2i &p_world_position) const {
+	// Binary search on the world position.
+	Cell cell;
+	cell.coords = p_coords;
+	cell.world_position = p_world_position;
+	uint32_t low = 0;
+	uint32_t high = cells.size();
+	CellWorldComparator compare;
+	while (low < high) {
+		uint32_t middle = (low + high) / 2;
+		if (compare(cells[middle], cell)) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+	if (low < cells.size() && cells[low].coords == p_coords) {
+		return low;
+	}
+
+	// The world positions may be outdated if the tileset changed, fallback to a linear search.
+	for (uint32_t i = 0; i < cells.size(); i++) {
+		if (cells[i].coords == p_coords) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+void RTileMapQuadrant::insert_cell(const Vector2i &p_coords, const Vector2i &p_world_position) {
+	Cell cell;
+	cell.coords = p_coords;
+	cell.world_position = p_world_position;
+
+	// Find the insertion position, keeping the cells sorted by world position.
+	uint32_t low = 0;
+	uint32_t high = cells.size();
+	CellWorldComparator compare;
+	while (low < high) {
+		uint32_t middle = (low + high) / 2;
+		if (compare(cells[middle], cell)) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+	if (low < cells.size() && cells[low].coords == p_coords) {
+		return;
+	}
+	cells.insert(low, cell);
+}
+
+void RTileMapQuadrant::erase_cell(const Vector2i &p_coords, const Vector2i &p_world_position) {
+	int index = find_cell(p_coords, p_world_position);
+	if (index >= 0) {
+		cells.remove(index);
+	}
+}
+
+void RTileMapQuadrant::sort_cells() {
+	SortArray<Cell, CellWorldComparator> sorter;
+	sorter.sort(cells.ptr(), cells.size());
+}
 
 Map<Vector2i, RTileSet::CellNeighbor> RTileMap::TerrainConstraint::get_overlapping_coords_and_peering_bits() const {
 	Map<Vector2i, RTileSet::CellNeighbor> output;
@@ -490,9 +559,19 @@ void RTileMap::_notification(int p_what) {
 		case NOTIFICATION_ENTER_TREE: {
 			_clear_internals();
 			_recreate_internals();
+			_streaming_start();
 		} break;
 		case NOTIFICATION_EXIT_TREE: {
+			_streaming_stop();
 			_clear_internals();
+			_free_rid_pools();
+		} break;
+		case NOTIFICATION_INTERNAL_PROCESS: {
+			// Continue the time-sliced updates. Animated tiles are handled by the rendering notification.
+			_streaming_update();
+			_rendering_update_culling();
+			_physics_update_activation();
+			_update_dirty_quadrants();
 		} break;
 	}
 
@@ -526,6 +605,7 @@ void RTileMap::set_tileset(const Ref<RTileSet> &p_tileset) {
 
 	if (tile_set.is_valid()) {
 		tile_set->connect("changed", this, "_tile_set_changed");
+		tile_set_changes_version = tile_set->get_tile_changes_version();
 		_clear_internals();
 		_recreate_internals();
 	}
@@ -536,9 +616,12 @@ void RTileMap::set_tileset(const Ref<RTileSet> &p_tileset) {
 void RTileMap::set_quadrant_size(int p_size) {
 	ERR_FAIL_COND_MSG(p_size < 1, "RTileMapQuadrant size cannot be smaller than 1.");
 
+	// Regions are sized in quadrants, write them back before their bounds change.
+	_streaming_stop();
 	quadrant_size = p_size;
 	_clear_internals();
 	_recreate_internals();
+	_streaming_start();
 	emit_signal("changed");
 }
 
@@ -687,6 +770,34 @@ void RTileMap::set_layer_z_index(int p_layer, int p_z_index) {
 	update_configuration_warning();
 }
 
+void RTileMap::set_layer_base_file(int p_layer, const String &p_path) {
+	ERR_FAIL_INDEX(p_layer, (int)layers.size());
+	if (p_path == layers[p_layer].base_file) {
+		return;
+	}
+
+	clear_layer(p_layer);
+	layers[p_layer].base_file = p_path;
+	if (!p_path.empty()) {
+		Error err = layers[p_layer].tile_map.open_base(p_path);
+		if (err != OK) {
+			ERR_PRINT(vformat("Cannot open the base file of the TileMap layer %d: %s.", p_layer, p_path));
+		}
+		_recreate_layer_internals(p_layer);
+	}
+	emit_signal("changed");
+}
+
+String RTileMap::get_layer_base_file(int p_layer) const {
+	ERR_FAIL_INDEX_V(p_layer, (int)layers.size(), String());
+	return layers[p_layer].base_file;
+}
+
+Error RTileMap::save_layer_base_file(int p_layer, const String &p_path) const {
+	ERR_FAIL_INDEX_V(p_layer, (int)layers.size(), ERR_INVALID_PARAMETER);
+	return layers[p_layer].tile_map.save_base(p_path);
+}
+
 int RTileMap::get_layer_z_index(int p_layer) const {
 	ERR_FAIL_INDEX_V(p_layer, (int)layers.size(), false);
 	return layers[p_layer].z_index;
@@ -705,6 +816,186 @@ bool RTileMap::is_collision_animatable() const {
 	return collision_animatable;
 }
 
+void RTileMap::set_collision_use_quadrant_bodies(bool p_use_quadrant_bodies) {
+	collision_use_quadrant_bodies = p_use_quadrant_bodies;
+	_clear_internals();
+	_recreate_internals();
+	emit_signal("changed");
+}
+
+bool RTileMap::is_collision_using_quadrant_bodies() const {
+	return collision_use_quadrant_bodies;
+}
+
+void RTileMap::set_collision_merge_shapes(bool p_merge_shapes) {
+	collision_merge_shapes = p_merge_shapes;
+	_clear_internals();
+	_recreate_internals();
+	emit_signal("changed");
+}
+
+bool RTileMap::is_collision_merging_shapes() const {
+	return collision_merge_shapes;
+}
+
+void RTileMap::set_use_mesh_batching(bool p_use_mesh_batching) {
+	use_mesh_batching = p_use_mesh_batching;
+	_clear_internals();
+	_recreate_internals();
+	emit_signal("changed");
+}
+
+bool RTileMap::is_using_mesh_batching() const {
+	return use_mesh_batching;
+}
+
+void RTileMap::set_use_physics_activation(bool p_use_physics_activation) {
+	if (p_use_physics_activation == use_physics_activation) {
+		return;
+	}
+	use_physics_activation = p_use_physics_activation;
+
+	if (use_physics_activation) {
+		// Start from the existing bodies, the ones out of range are released on the next update.
+		for (unsigned int layer = 0; layer < layers.size(); layer++) {
+			for (Map<Vector2i, RTileMapQuadrant>::Element *E = layers[layer].quadrant_map.front(); E; E = E->next()) {
+				physics_active_quadrant_list.add(&E->get().physics_active_list_element);
+			}
+		}
+		physics_activation_dirty = true;
+		if (is_inside_tree()) {
+			set_process_internal(true);
+		}
+	} else {
+		while (physics_active_quadrant_list.first()) {
+			physics_active_quadrant_list.remove(physics_active_quadrant_list.first());
+		}
+		for (unsigned int layer = 0; layer < layers.size(); layer++) {
+			for (Map<Vector2i, RTileMapQuadrant>::Element *E = layers[layer].quadrant_map.front(); E; E = E->next()) {
+				RTileMapQuadrant &q = E->get();
+				if (q.physics_active_mask != 0xFFFFFFFF) {
+					q.physics_active_mask = 0xFFFFFFFF;
+					_make_quadrant_fully_dirty(q, RTileSet::TILE_CHANGE_PHYSICS);
+				}
+			}
+		}
+	}
+}
+
+bool RTileMap::is_using_physics_activation() const {
+	return use_physics_activation;
+}
+
+void RTileMap::set_physics_activation_distance(real_t p_distance) {
+	physics_activation_distance = MAX(p_distance, 0.0);
+	physics_activation_dirty = true;
+}
+
+real_t RTileMap::get_physics_activation_distance() const {
+	return physics_activation_distance;
+}
+
+void RTileMap::set_physics_activation_release_distance(real_t p_distance) {
+	physics_activation_release_distance = MAX(p_distance, 0.0);
+	physics_activation_dirty = true;
+}
+
+real_t RTileMap::get_physics_activation_release_distance() const {
+	return physics_activation_release_distance;
+}
+
+void RTileMap::add_physics_activator(Node2D *p_node, uint32_t p_collision_mask) {
+	ERR_FAIL_NULL(p_node);
+	for (uint32_t i = 0; i < physics_activators.size(); i++) {
+		if (physics_activators[i].node_id == p_node->get_instance_id()) {
+			physics_activators[i].collision_mask = p_collision_mask;
+			physics_activation_dirty = true;
+			return;
+		}
+	}
+
+	PhysicsActivator activator;
+	activator.node_id = p_node->get_instance_id();
+	activator.collision_mask = p_collision_mask;
+	physics_activators.push_back(activator);
+	physics_activation_dirty = true;
+}
+
+void RTileMap::remove_physics_activator(Node2D *p_node) {
+	ERR_FAIL_NULL(p_node);
+	for (uint32_t i = 0; i < physics_activators.size(); i++) {
+		if (physics_activators[i].node_id == p_node->get_instance_id()) {
+			physics_activators.remove(i);
+			physics_activation_dirty = true;
+			return;
+		}
+	}
+}
+
+Array RTileMap::get_physics_activators() const {
+	Array activators;
+	for (uint32_t i = 0; i < physics_activators.size(); i++) {
+		Object *node = ObjectDB::get_instance(physics_activators[i].node_id);
+		if (node) {
+			activators.push_back(node);
+		}
+	}
+	return activators;
+}
+
+void RTileMap::set_use_viewport_culling(bool p_use_viewport_culling) {
+	if (p_use_viewport_culling == use_viewport_culling) {
+		return;
+	}
+	use_viewport_culling = p_use_viewport_culling;
+
+	if (use_viewport_culling) {
+		// Start from the rendered quadrants, the ones out of range are released on the next update.
+		for (unsigned int layer = 0; layer < layers.size(); layer++) {
+			for (Map<Vector2i, RTileMapQuadrant>::Element *E = layers[layer].quadrant_map.front(); E; E = E->next()) {
+				rendered_quadrant_list.add(&E->get().rendered_list_element);
+			}
+		}
+		viewport_culling_dirty = true;
+		if (is_inside_tree()) {
+			set_process_internal(true);
+		}
+	} else {
+		while (rendered_quadrant_list.first()) {
+			rendered_quadrant_list.remove(rendered_quadrant_list.first());
+		}
+		for (unsigned int layer = 0; layer < layers.size(); layer++) {
+			for (Map<Vector2i, RTileMapQuadrant>::Element *E = layers[layer].quadrant_map.front(); E; E = E->next()) {
+				if (E->get().rendering_culled) {
+					_rendering_uncull_quadrant(E->get());
+				}
+			}
+		}
+	}
+}
+
+bool RTileMap::is_using_viewport_culling() const {
+	return use_viewport_culling;
+}
+
+void RTileMap::set_viewport_culling_margin(real_t p_margin) {
+	viewport_culling_margin = MAX(p_margin, 0.0);
+	viewport_culling_dirty = true;
+}
+
+real_t RTileMap::get_viewport_culling_margin() const {
+	return viewport_culling_margin;
+}
+
+void RTileMap::set_viewport_culling_release_margin(real_t p_margin) {
+	viewport_culling_release_margin = MAX(p_margin, 0.0);
+	viewport_culling_dirty = true;
+}
+
+real_t RTileMap::get_viewport_culling_release_margin() const {
+	return viewport_culling_release_margin;
+}
+
 void RTileMap::set_collision_visibility_mode(RTileMap::VisibilityMode p_show_collision) {
 	collision_visibility_mode = p_show_collision;
 	_clear_internals();
@@ -727,6 +1018,85 @@ RTileMap::VisibilityMode RTileMap::get_navigation_visibility_mode() {
 	return navigation_visibility_mode;
 }
 
+void RTileMap::set_navigation_merge_regions(bool p_merge_regions) {
+	navigation_merge_regions = p_merge_regions;
+	_clear_internals();
+	_recreate_internals();
+	emit_signal("changed");
+}
+
+bool RTileMap::is_navigation_merging_regions() const {
+	return navigation_merge_regions;
+}
+
+void RTileMap::set_tile_data_compression(TileDataCompression p_compression) {
+	tile_data_compression = p_compression;
+}
+
+RTileMap::TileDataCompression RTileMap::get_tile_data_compression() const {
+	return tile_data_compression;
+}
+
+void RTileMap::set_streaming_directory(const String &p_directory) {
+	if (p_directory == streaming_directory) {
+		return;
+	}
+	_streaming_stop();
+	streaming_directory = p_directory;
+	_streaming_start();
+}
+
+String RTileMap::get_streaming_directory() const {
+	return streaming_directory;
+}
+
+void RTileMap::set_streaming_region_size(int p_size) {
+	ERR_FAIL_COND_MSG(p_size < 1, "Streaming region size cannot be smaller than 1.");
+	if (p_size == streaming_region_size) {
+		return;
+	}
+	_streaming_stop();
+	streaming_region_size = p_size;
+	_streaming_start();
+}
+
+int RTileMap::get_streaming_region_size() const {
+	return streaming_region_size;
+}
+
+void RTileMap::set_streaming_load_distance(real_t p_distance) {
+	streaming_load_distance = MAX(p_distance, 0.0);
+}
+
+real_t RTileMap::get_streaming_load_distance() const {
+	return streaming_load_distance;
+}
+
+void RTileMap::set_streaming_unload_distance(real_t p_distance) {
+	streaming_unload_distance = MAX(p_distance, 0.0);
+}
+
+real_t RTileMap::get_streaming_unload_distance() const {
+	return streaming_unload_distance;
+}
+
+bool RTileMap::is_streaming() const {
+	return streamer != nullptr;
+}
+
+void RTileMap::save_streamed_regions() {
+	if (!streamer) {
+		return;
+	}
+	for (Map<Vector2i, StreamedRegion>::Element *E = streamed_regions.front(); E; E = E->next()) {
+		if (E->get().loaded && E->get().dirty) {
+			_streaming_save_region(E->key());
+			E->get().dirty = false;
+		}
+	}
+	streamer->wait_for_requests();
+}
+
 bool RTileMap::is_y_sort_enabled() const {
 	return _y_sort_enabled;
 }
@@ -740,6 +1110,128 @@ void RTileMap::set_y_sort_enabled(bool p_enable) {
 	emit_signal("changed");
 }
 
+void RTileMap::set_pathfinding_custom_data_layer(const String &p_layer_name) {
+	pathfinding_custom_data_layer = p_layer_name;
+	for (unsigned int layer = 0; layer < layers.size(); layer++) {
+		_pathfinding_clear_layer(layer);
+	}
+}
+
+String RTileMap::get_pathfinding_custom_data_layer() const {
+	return pathfinding_custom_data_layer;
+}
+
+PoolVector2Array RTileMap::find_path(int p_layer, const Vector2 &p_from, const Vector2 &p_to) const {
+	ERR_FAIL_COND_V_MSG(Thread::get_caller_id() != Thread::get_main_id(), PoolVector2Array(), "Pathfinding queries must be made from the main thread.");
+	RTileMapPathfinding *pathfinding = _pathfinding_get_layer(p_layer);
+	ERR_FAIL_COND_V(!pathfinding, PoolVector2Array());
+	return pathfinding->find_path(p_from, p_to);
+}
+
+Array RTileMap::find_paths(int p_layer, const PoolVector2Array &p_from, const PoolVector2Array &p_to) const {
+	Array output;
+	ERR_FAIL_COND_V_MSG(Thread::get_caller_id() != Thread::get_main_id(), output, "Pathfinding queries must be made from the main thread.");
+	ERR_FAIL_COND_V_MSG(p_from.size() != p_to.size(), output, "The start and goal arrays must have the same size.");
+	RTileMapPathfinding *pathfinding = _pathfinding_get_layer(p_layer);
+	ERR_FAIL_COND_V(!pathfinding, output);
+
+	LocalVector<RTileMapPathfinding::PathQuery> queries;
+	queries.resize(p_from.size());
+	for (int i = 0; i < p_from.size(); i++) {
+		queries[i].from = p_from[i];
+		queries[i].to = p_to[i];
+	}
+
+	// The graph is updated once, the queries then only read it. The shared pool is only used from the main thread.
+	pathfinding->prepare_queries();
+	_get_quadrant_update_work_pool()->do_work(queries.size(), pathfinding, &RTileMapPathfinding::process_query, queries.ptr());
+
+	output.resize(queries.size());
+	for (uint32_t i = 0; i < queries.size(); i++) {
+		output[i] = queries[i].path;
+	}
+	return output;
+}
+
+PoolByteArray RTileMap::get_flow_field(int p_layer, const Rect2 &p_region, const PoolVector2Array &p_goals) const {
+	ERR_FAIL_COND_V_MSG(Thread::get_caller_id() != Thread::get_main_id(), PoolByteArray(), "Pathfinding queries must be made from the main thread.");
+	RTileMapPathfinding *pathfinding = _pathfinding_get_layer(p_layer);
+	ERR_FAIL_COND_V(!pathfinding, PoolByteArray());
+
+	Vector<Vector2i> goals;
+	for (int i = 0; i < p_goals.size(); i++) {
+		goals.push_back(p_goals[i]);
+	}
+	PoolByteArray directions;
+	pathfinding->get_flow_field(Rect2i(p_region.position, p_region.size), goals, &directions, nullptr);
+	return directions;
+}
+
+PoolRealArray RTileMap::get_flow_field_integration(int p_layer, const Rect2 &p_region, const PoolVector2Array &p_goals) const {
+	ERR_FAIL_COND_V_MSG(Thread::get_caller_id() != Thread::get_main_id(), PoolRealArray(), "Pathfinding queries must be made from the main thread.");
+	RTileMapPathfinding *pathfinding = _pathfinding_get_layer(p_layer);
+	ERR_FAIL_COND_V(!pathfinding, PoolRealArray());
+
+	Vector<Vector2i> goals;
+	for (int i = 0; i < p_goals.size(); i++) {
+		goals.push_back(p_goals[i]);
+	}
+	PoolRealArray integration;
+	pathfinding->get_flow_field(Rect2i(p_region.position, p_region.size), goals, nullptr, &integration);
+	return integration;
+}
+
+void RTileMap::set_update_budget_msec(real_t p_budget_msec) {
+	update_budget_msec = MAX(p_budget_msec, 0.0);
+}
+
+real_t RTileMap::get_update_budget_msec() const {
+	return update_budget_msec;
+}
+
+void RTileMap::set_update_budget_quadrants(int p_budget_quadrants) {
+	update_budget_quadrants = MAX(p_budget_quadrants, 0);
+}
+
+int RTileMap::get_update_budget_quadrants() const {
+	return update_budget_quadrants;
+}
+
+void RTileMap::set_use_update_focus_point(bool p_use_update_focus_point) {
+	use_update_focus_point = p_use_update_focus_point;
+}
+
+bool RTileMap::is_using_update_focus_point() const {
+	return use_update_focus_point;
+}
+
+void RTileMap::set_update_focus_point(const Vector2 &p_update_focus_point) {
+	update_focus_point = p_update_focus_point;
+}
+
+Vector2 RTileMap::get_update_focus_point() const {
+	return update_focus_point;
+}
+
+ThreadWorkPool *RTileMap::quadrant_update_work_pool = nullptr;
+
+ThreadWorkPool *RTileMap::_get_quadrant_update_work_pool() {
+	// Created on first use, shared by all the tile maps.
+	if (!quadrant_update_work_pool) {
+		quadrant_update_work_pool = memnew(ThreadWorkPool);
+		quadrant_update_work_pool->init();
+	}
+	return quadrant_update_work_pool;
+}
+
+void RTileMap::finish_quadrant_update_work_pool() {
+	if (quadrant_update_work_pool) {
+		quadrant_update_work_pool->finish();
+		memdelete(quadrant_update_work_pool);
+		quadrant_update_work_pool = nullptr;
+	}
+}
+
 Vector2i RTileMap::_coords_to_quadrant_coords(int p_layer, const Vector2i &p_coords) const {
 	int quadrant_size = get_effective_quadrant_size(p_layer);
 
@@ -749,6 +1241,14 @@ Vector2i RTileMap::_coords_to_quadrant_coords(int p_layer, const Vector2i &p_coo
 			p_coords.y > 0 ? p_coords.y / quadrant_size : (p_coords.y - (quadrant_size - 1)) / quadrant_size);
 }
 
+Vector2i RTileMap::_get_cell_world_position(const Vector2i &p_coords) const {
+	// Without tileset, the positions are computed once the quadrants are recreated.
+	if (!tile_set.is_valid()) {
+		return Vector2i();
+	}
+	return map_to_world(p_coords);
+}
+
 Map<Vector2i, RTileMapQuadrant>::Element *RTileMap::_create_quadrant(int p_layer, const Vector2i &p_qk) {
 	ERR_FAIL_INDEX_V(p_layer, (int)layers.size(), nullptr);
 
@@ -760,10 +1260,16 @@ Map<Vector2i, RTileMapQuadrant>::Element *RTileMap::_create_quadrant(int p_layer
 
 	// Create the debug canvas item.
 	VisualServer *rs = VisualServer::get_singleton();
-	q.debug_canvas_item = rs->canvas_item_create();
+	q.debug_canvas_item = _acquire_canvas_item();
 	rs->canvas_item_set_z_index(q.debug_canvas_item, VS::CANVAS_ITEM_Z_MAX - 1);
 	rs->canvas_item_set_parent(q.debug_canvas_item, get_canvas_item());
 
+	// New quadrants get bodies once found near an activator.
+	if (use_physics_activation) {
+		q.physics_active_mask = 0;
+		physics_activation_dirty = true;
+	}
+
 	// Call the create_quadrant method on plugins
 	if (tile_set.is_valid()) {
 		_rendering_create_quadrant(&q);
@@ -775,6 +1281,22 @@ Map<Vector2i, RTileMapQuadrant>::Element *RTileMap::_create_quadrant(int p_layer
 void RTileMap::_make_quadrant_dirty(Map<Vector2i, RTileMapQuadrant>::Element *Q) {
 	// Make the given quadrant dirty, then trigger an update later.
 	RTileMapQuadrant &q = Q->get();
+	q.full_update = true;
+	q.dirty_cells.clear();
+	q.dirty_aspects = RTileSet::TILE_CHANGE_ALL;
+	if (!q.dirty_list_element.in_list()) {
+		layers[q.layer].dirty_quadrant_list.add(&q.dirty_list_element);
+	}
+	_queue_update_dirty_quadrants();
+}
+
+void RTileMap::_make_quadrant_cell_dirty(Map<Vector2i, RTileMapQuadrant>::Element *Q, const Vector2i &p_coords, uint32_t p_aspects) {
+	// Only the given cell will be updated, unless the whole quadrant already needs an update.
+	RTileMapQuadrant &q = Q->get();
+	if (!q.full_update) {
+		q.dirty_cells.insert(p_coords);
+	}
+	q.dirty_aspects |= p_aspects;
 	if (!q.dirty_list_element.in_list()) {
 		layers[q.layer].dirty_quadrant_list.add(&q.dirty_list_element);
 	}
@@ -786,6 +1308,9 @@ void RTileMap::_make_all_quadrants_dirty() {
 	for (unsigned int layer = 0; layer < layers.size(); layer++) {
 
 		for (Map<Vector2i, RTileMapQuadrant>::Element *E = layers[layer].quadrant_map.front(); E; E = E->next()) {
+			E->value().full_update = true;
+			E->value().dirty_cells.clear();
+			E->value().dirty_aspects = RTileSet::TILE_CHANGE_ALL;
 			if (!E->value().dirty_list_element.in_list()) {
 				layers[layer].dirty_quadrant_list.add(&E->value().dirty_list_element);
 			}
@@ -794,6 +1319,70 @@ void RTileMap::_make_all_quadrants_dirty() {
 	_queue_update_dirty_quadrants();
 }
 
+void RTileMap::_make_quadrant_fully_dirty(RTileMapQuadrant &r_quadrant, uint32_t p_aspects) {
+	r_quadrant.full_update = true;
+	r_quadrant.dirty_cells.clear();
+	r_quadrant.dirty_aspects |= p_aspects;
+	if (!r_quadrant.dirty_list_element.in_list()) {
+		layers[r_quadrant.layer].dirty_quadrant_list.add(&r_quadrant.dirty_list_element);
+	}
+	_queue_update_dirty_quadrants();
+}
+
+bool RTileMap::_is_internal_process_needed() const {
+	return pending_update || animated_quadrant_list.first() || streamer || use_viewport_culling || use_physics_activation;
+}
+
+Rect2 RTileMap::_get_quadrant_rect(const RTileMapQuadrant &p_quadrant) const {
+	int effective_quadrant_size = get_effective_quadrant_size(p_quadrant.layer);
+	Vector2i origin = p_quadrant.coords * effective_quadrant_size;
+	Rect2 rect(map_to_world(origin), Size2());
+	rect.expand_to(map_to_world(origin + Vector2i(effective_quadrant_size, 0)));
+	rect.expand_to(map_to_world(origin + Vector2i(0, effective_quadrant_size)));
+	rect.expand_to(map_to_world(origin + Vector2i(effective_quadrant_size, effective_quadrant_size)));
+
+	// Tiles are centered on their cell, and may overflow it.
+	Size2 tile_size = tile_set->get_tile_size();
+	return rect.grow(MAX(tile_size.x, tile_size.y));
+}
+
+void RTileMap::_find_quadrants_in_rect(int p_layer, const Rect2 &p_rect, LocalVector<RTileMapQuadrant *> &r_quadrants) {
+	Map<Vector2i, RTileMapQuadrant> &quadrant_map = layers[p_layer].quadrant_map;
+
+	// The range of cells covered by the rect.
+	Vector2i cells_from = world_to_map(p_rect.position);
+	Vector2i cells_to = cells_from;
+	const Vector2 corners[3] = { Vector2(p_rect.size.x, 0), Vector2(0, p_rect.size.y), p_rect.size };
+	for (int i = 0; i < 3; i++) {
+		Vector2i coords = world_to_map(p_rect.position + corners[i]);
+		cells_from = Vector2i(MIN(cells_from.x, coords.x), MIN(cells_from.y, coords.y));
+		cells_to = Vector2i(MAX(cells_to.x, coords.x), MAX(cells_to.y, coords.y));
+	}
+	cells_from -= Vector2i(1, 1);
+	cells_to += Vector2i(1, 1);
+
+	Vector2i quadrants_from = _coords_to_quadrant_coords(p_layer, cells_from);
+	Vector2i quadrants_to = _coords_to_quadrant_coords(p_layer, cells_to);
+	int64_t range_size = int64_t(quadrants_to.x - quadrants_from.x + 1) * int64_t(quadrants_to.y - quadrants_from.y + 1);
+	if (range_size > quadrant_map.size()) {
+		// Large rect, checking every quadrant is cheaper.
+		for (Map<Vector2i, RTileMapQuadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
+			if (_get_quadrant_rect(E->get()).intersects(p_rect)) {
+				r_quadrants.push_back(&E->get());
+			}
+		}
+	} else {
+		for (int y = quadrants_from.y; y <= quadrants_to.y; y++) {
+			for (int x = quadrants_from.x; x <= quadrants_to.x; x++) {
+				Map<Vector2i, RTileMapQuadrant>::Element *E = quadrant_map.find(Vector2i(x, y));
+				if (E && _get_quadrant_rect(E->get()).intersects(p_rect)) {
+					r_quadrants.push_back(&E->get());
+				}
+			}
+		}
+	}
+}
+
 void RTileMap::_queue_update_dirty_quadrants() {
 	if (pending_update || !is_inside_tree()) {
 		return;
@@ -808,63 +1397,254 @@ void RTileMap::_update_dirty_quadrants() {
 	}
 	if (!is_inside_tree() || !tile_set.is_valid()) {
 		pending_update = false;
+		set_process_internal(_is_internal_process_needed());
 		return;
 	}
 
-	for (unsigned int layer = 0; layer < layers.size(); layer++) {
-		SelfList<RTileMapQuadrant>::List &dirty_quadrant_list = layers[layer].dirty_quadrant_list;
+	// Release or create the render resources and bodies of the quadrants moving out of or into range, before updating them.
+	_rendering_update_culling();
+	_physics_update_activation();
 
-		// Update the coords cache.
-		for (SelfList<RTileMapQuadrant> *q = dirty_quadrant_list.first(); q; q = q->next()) {
-			q->self()->map_to_world.clear();
-			q->self()->world_to_map.clear();
-			for (Set<Vector2i>::Element *E = q->self()->cells.front(); E; E = E->next()) {
-				Vector2i pk = E->get();
-				Vector2i pk_world_coords = map_to_world(pk);
-				q->self()->map_to_world[pk] = pk_world_coords;
-				q->self()->world_to_map[pk_world_coords] = pk;
+	SelfList<RTileMapQuadrant>::List update_list;
+
+	if (update_budget_msec <= 0.0 && update_budget_quadrants <= 0) {
+		// No budget, update all dirty quadrants at once.
+		for (unsigned int layer = 0; layer < layers.size(); layer++) {
+			SelfList<RTileMapQuadrant>::List &dirty_quadrant_list = layers[layer].dirty_quadrant_list;
+			while (dirty_quadrant_list.first()) {
+				SelfList<RTileMapQuadrant> *q = dirty_quadrant_list.first();
+				dirty_quadrant_list.remove(q);
+				update_list.add(q);
 			}
 		}
-
-		// Find TileData that need a runtime modification.
-		_build_runtime_update_tile_data(dirty_quadrant_list);
-
-		// Call the update_dirty_quadrant method on plugins.
-		_rendering_update_dirty_quadrants(dirty_quadrant_list);
-		_physics_update_dirty_quadrants(dirty_quadrant_list);
-		_navigation_update_dirty_quadrants(dirty_quadrant_list);
-		_scenes_update_dirty_quadrants(dirty_quadrant_list);
-
-		// Redraw the debug canvas_items.
-		VisualServer *rs = VisualServer::get_singleton();
-		for (SelfList<RTileMapQuadrant> *q = dirty_quadrant_list.first(); q; q = q->next()) {
-			rs->canvas_item_clear(q->self()->debug_canvas_item);
-			Transform2D xform;
-			xform.set_origin(map_to_world(q->self()->coords * get_effective_quadrant_size(layer)));
-			rs->canvas_item_set_transform(q->self()->debug_canvas_item, xform);
-
-			_rendering_draw_quadrant_debug(q->self());
-			_physics_draw_quadrant_debug(q->self());
-			_navigation_draw_quadrant_debug(q->self());
-			_scenes_draw_quadrant_debug(q->self());
+		_update_quadrants(update_list);
+	} else {
+		// Sort the dirty quadrants by distance to the focus point, so that visible quadrants are updated first.
+		Vector2 focus_point = _get_update_focus_point();
+		Vector<QuadrantUpdatePriority> priorities;
+		for (unsigned int layer = 0; layer < layers.size(); layer++) {
+			int effective_quadrant_size = get_effective_quadrant_size(layer);
+			for (SelfList<RTileMapQuadrant> *q = layers[layer].dirty_quadrant_list.first(); q; q = q->next()) {
+				QuadrantUpdatePriority priority;
+				priority.quadrant = q->self();
+				Vector2 quadrant_center = map_to_world(q->self()->coords * effective_quadrant_size + Vector2i(effective_quadrant_size / 2, effective_quadrant_size / 2));
+				priority.distance_squared = focus_point.distance_squared_to(quadrant_center);
+				priorities.push_back(priority);
+			}
 		}
-
-		// Clear the list
-		while (dirty_quadrant_list.first()) {
-			// Clear the runtime tile data.
-			for (Map<Vector2i, RTileData *>::Element *kv = dirty_quadrant_list.first()->self()->runtime_tile_data_cache.front(); kv; kv = kv->next()) {
-				memdelete(kv->value());
+		priorities.sort();
+
+		// Update the quadrants in slices, feeding every worker thread, until the budget is exhausted.
+		// At least one slice is updated per call, so the updates always progress.
+		int slice_size = MAX(1, OS::get_singleton()->get_processor_count());
+		uint64_t start_usec = OS::get_singleton()->get_ticks_usec();
+		int updated = 0;
+		while (updated < priorities.size()) {
+			int slice_end = MIN(updated + slice_size, priorities.size());
+			if (update_budget_quadrants > 0) {
+				slice_end = MIN(slice_end, update_budget_quadrants);
 			}
+			for (int i = updated; i < slice_end; i++) {
+				RTileMapQuadrant *q = priorities[i].quadrant;
+				layers[q->layer].dirty_quadrant_list.remove(&q->dirty_list_element);
+				update_list.add(&q->dirty_list_element);
+			}
+			_update_quadrants(update_list);
+			updated = slice_end;
 
-			dirty_quadrant_list.remove(dirty_quadrant_list.first());
-		}
+			if (update_budget_quadrants > 0 && updated >= update_budget_quadrants) {
+				break;
+			}
+			if (update_budget_msec > 0.0 && (OS::get_singleton()->get_ticks_usec() - start_usec) >= update_budget_msec * 1000.0) {
+				break;
+			}
+		}
 	}
 
+	// Continue on the next frames if some quadrants are still dirty.
 	pending_update = false;
+	for (unsigned int layer = 0; layer < layers.size(); layer++) {
+		if (layers[layer].dirty_quadrant_list.first()) {
+			pending_update = true;
+			break;
+		}
+	}
+	set_process_internal(_is_internal_process_needed());
 
 	_recompute_rect_cache();
 }
 
+void RTileMap::_update_quadrants(SelfList<RTileMapQuadrant>::List &r_update_list) {
+	// Find TileData that need a runtime modification. This calls scripts, so it has to run on the main thread.
+	_build_runtime_update_tile_data(r_update_list);
+
+	// Resolve the quadrants data on the worker threads.
+	quadrant_update_list.clear();
+	for (SelfList<RTileMapQuadrant> *q = r_update_list.first(); q; q = q->next()) {
+		quadrant_update_list.push_back(q->self());
+	}
+	_get_quadrant_update_work_pool()->do_work(quadrant_update_list.size(), this, &RTileMap::_compute_quadrant_update, quadrant_update_list.ptr());
+	quadrant_update_list.clear();
+
+	// Call the update_dirty_quadrant method on plugins.
+	_rendering_update_dirty_quadrants(r_update_list);
+	_physics_update_dirty_quadrants(r_update_list);
+	_navigation_update_dirty_quadrants(r_update_list);
+	_scenes_update_dirty_quadrants(r_update_list);
+
+	// Redraw the debug canvas_items.
+	VisualServer *rs = VisualServer::get_singleton();
+	for (SelfList<RTileMapQuadrant> *q = r_update_list.first(); q; q = q->next()) {
+		rs->canvas_item_clear(q->self()->debug_canvas_item);
+		Transform2D xform;
+		xform.set_origin(map_to_world(q->self()->coords * get_effective_quadrant_size(q->self()->layer)));
+		rs->canvas_item_set_transform(q->self()->debug_canvas_item, xform);
+
+		_rendering_draw_quadrant_debug(q->self());
+		_physics_draw_quadrant_debug(q->self());
+		_navigation_draw_quadrant_debug(q->self());
+		_scenes_draw_quadrant_debug(q->self());
+	}
+
+	// Clear the list
+	while (r_update_list.first()) {
+		// Reset the changed cells.
+		RTileMapQuadrant &quadrant = *r_update_list.first()->self();
+		quadrant.dirty_cells.clear();
+		quadrant.full_update = false;
+		quadrant.dirty_aspects = 0;
+		quadrant.cells_to_update.clear();
+		quadrant.cells_resolution.clear();
+		quadrant.cells_tile_data.clear();
+		quadrant.next_rendering_batches.clear();
+
+		r_update_list.remove(r_update_list.first());
+	}
+}
+
+Vector2 RTileMap::_get_update_focus_point() const {
+	// The focus point is given in global coordinates, convert it to the local ones.
+	if (use_update_focus_point) {
+		return get_global_transform().affine_inverse().xform(update_focus_point);
+	}
+
+	// Otherwise, use the center of the viewport, as seen by the active camera.
+	return get_global_transform_with_canvas().affine_inverse().xform(get_viewport_rect().size / 2.0);
+}
+
+void RTileMap::flush_dirty_quadrants() {
+	// Ignore the budget, and update everything now.
+	real_t budget_msec = update_budget_msec;
+	int budget_quadrants = update_budget_quadrants;
+	update_budget_msec = 0.0;
+	update_budget_quadrants = 0;
+	_update_dirty_quadrants();
+	update_budget_msec = budget_msec;
+	update_budget_quadrants = budget_quadrants;
+}
+
+Dictionary RTileMap::get_rid_pools_statistics() const {
+	const char *names[3] = { "canvas_items", "occluders", "bodies" };
+	const RIDPool *pools[3] = { &canvas_item_pool, &occluder_pool, &body_pool };
+
+	Dictionary statistics;
+	for (int i = 0; i < 3; i++) {
+		Dictionary pool_statistics;
+		pool_statistics["created"] = pools[i]->created_count;
+		pool_statistics["reused"] = pools[i]->reused_count;
+		pool_statistics["released"] = pools[i]->released_count;
+		pool_statistics["pooled"] = pools[i]->rids.size();
+		statistics[names[i]] = pool_statistics;
+	}
+	return statistics;
+}
+
+void RTileMap::_compute_quadrant_update(uint32_t p_index, RTileMapQuadrant **p_quadrants) const {
+	// Runs on a worker thread: only read the map and the tileset, and only write to the given quadrant.
+	RTileMapQuadrant &quadrant = *p_quadrants[p_index];
+
+	// Update the world positions. Modified cells already got their position when inserted.
+	if (quadrant.full_update) {
+		for (uint32_t i = 0; i < quadrant.cells.size(); i++) {
+			quadrant.cells[i].world_position = map_to_world(quadrant.cells[i].coords);
+		}
+		quadrant.sort_cells();
+	}
+
+	// Find the modified cells.
+	quadrant.cells_to_update.clear();
+	if (quadrant.full_update) {
+		for (uint32_t i = 0; i < quadrant.cells.size(); i++) {
+			quadrant.cells_to_update.push_back(i);
+		}
+	} else {
+		for (const Set<Vector2i>::Element *E = quadrant.dirty_cells.front(); E; E = E->next()) {
+			int index = quadrant.find_cell(E->get(), map_to_world(E->get()));
+			if (index >= 0) {
+				quadrant.cells_to_update.push_back(index);
+			}
+		}
+	}
+
+	// Resolve the tile data of every atlas tile in the quadrant.
+	const TileMapLayer &layer = layers[quadrant.layer];
+	quadrant.cells_resolution.resize(quadrant.cells.size());
+	quadrant.cells_tile_data.resize(quadrant.cells.size());
+	for (uint32_t cell_index = 0; cell_index < quadrant.cells.size(); cell_index++) {
+		const Vector2i &pk = quadrant.cells[cell_index].coords;
+		quadrant.cells_resolution[cell_index] = nullptr;
+		quadrant.cells_tile_data[cell_index] = nullptr;
+
+		const RTileMapCell *cell = layer.tile_map.get_cell(pk);
+		const RTileSet::TileResolution *resolution = cell ? tile_set->resolve_tile(*cell) : nullptr;
+		if (!resolution || !resolution->atlas_source) {
+			continue;
+		}
+
+		quadrant.cells_resolution[cell_index] = resolution;
+		const Map<Vector2i, RTileData *>::Element *E_runtime = quadrant.runtime_tile_data_cache.find(pk);
+		quadrant.cells_tile_data[cell_index] = E_runtime ? E_runtime->value() : resolution->tile_data;
+	}
+
+	// Group the cells per material or z-index, in world order.
+	quadrant.next_rendering_batches.clear();
+	if (quadrant.rendering_culled) {
+		return;
+	}
+	Vector2 quadrant_position = map_to_world(quadrant.coords * get_effective_quadrant_size(quadrant.layer));
+	bool y_sorted = is_y_sort_enabled() && layers[quadrant.layer].y_sort_enabled;
+	for (uint32_t cell_index = 0; cell_index < quadrant.cells.size(); cell_index++) {
+		const RTileData *tile_data = quadrant.cells_tile_data[cell_index];
+		if (!tile_data) {
+			continue;
+		}
+
+		Ref<ShaderMaterial> mat = tile_data->get_material();
+		int z_index = tile_data->get_z_index();
+		const RTileSet::TileResolution *resolution = quadrant.cells_resolution[cell_index];
+		bool animated = resolution->atlas_source->get_tile_animation_frames_count(resolution->cell.get_atlas_coords()) > 1;
+
+		// Check if the material, the z_index or the animated state changed.
+		uint32_t batches_count = quadrant.next_rendering_batches.size();
+		if (batches_count == 0 || quadrant.next_rendering_batches[batches_count - 1].material != mat || quadrant.next_rendering_batches[batches_count - 1].z_index != z_index || quadrant.next_rendering_batches[batches_count - 1].animated != animated) {
+			RTileMapQuadrant::RenderingBatch batch;
+			batch.position = quadrant_position;
+			if (y_sorted) {
+				// When Y-sorting, the quandrant size is sure to be 1, we can thus offset the CanvasItem.
+				batch.position.y += layers[quadrant.layer].y_sort_origin + tile_data->get_y_sort_origin();
+			}
+			batch.material = mat;
+			batch.z_index = z_index;
+			batch.animated = animated;
+			batch.cells_begin = cell_index;
+			quadrant.next_rendering_batches.push_back(batch);
+		}
+		RTileMapQuadrant::RenderingBatch &batch = quadrant.next_rendering_batches[quadrant.next_rendering_batches.size() - 1];
+		batch.cells.push_back(quadrant.cells[cell_index].coords);
+		batch.cells_end = cell_index + 1;
+	}
+}
+
 void RTileMap::_recreate_layer_internals(int p_layer) {
 	ERR_FAIL_INDEX(p_layer, (int)layers.size());
 
@@ -879,21 +1659,31 @@ void RTileMap::_recreate_layer_internals(int p_layer) {
 	_rendering_update_layer(p_layer);
 
 	// Recreate the quadrants.
-	const Map<Vector2i, RTileMapCell> &tile_map = layers[p_layer].tile_map;
+	const RTileMapCellStorage &tile_map = layers[p_layer].tile_map;
+
+	for (uint32_t chunk_index = 0; chunk_index < tile_map.get_chunks_count(); chunk_index++) {
+		const RTileMapCellStorage::Chunk *chunk = tile_map.get_chunk_by_index(chunk_index);
+		for (uint32_t i = 0; i < RTileMapCellStorage::CHUNK_CELLS_COUNT; i++) {
+			if (!chunk->is_used(i)) {
+				continue;
+			}
 
-	for (Map<Vector2i, RTileMapCell>::Element *E = tile_map.front(); E; E = E->next()) {
-		Vector2i qk = _coords_to_quadrant_coords(p_layer, Vector2i(E->key().x, E->key().y));
+			Vector2i pk = chunk->get_cell_coords(i);
+			Vector2i qk = _coords_to_quadrant_coords(p_layer, pk);
 
-		Map<Vector2i, RTileMapQuadrant>::Element *Q = layers[p_layer].quadrant_map.find(qk);
-		if (!Q) {
-			Q = _create_quadrant(p_layer, qk);
-			layers[p_layer].dirty_quadrant_list.add(&Q->get().dirty_list_element);
-		}
+			Map<Vector2i, RTileMapQuadrant>::Element *Q = layers[p_layer].quadrant_map.find(qk);
+			if (!Q) {
+				Q = _create_quadrant(p_layer, qk);
+				layers[p_layer].dirty_quadrant_list.add(&Q->get().dirty_list_element);
+			}
 
-		Vector2i pk = E->key();
-		Q->get().cells.insert(pk);
+			// New quadrants are fully updated, which sorts their cells.
+			RTileMapQuadrant::Cell cell;
+			cell.coords = pk;
+			Q->get().cells.push_back(cell);
 
-		_make_quadrant_dirty(Q);
+			_make_quadrant_dirty(Q);
+		}
 	}
 
 	_queue_update_dirty_quadrants();
@@ -922,9 +1712,14 @@ void RTileMap::_erase_quadrant(Map<Vector2i, RTileMapQuadrant>::Element *Q) {
 		layers[q->layer].dirty_quadrant_list.remove(&(q->dirty_list_element));
 	}
 
-	// Free the debug canvas item.
-	VisualServer *rs = VisualServer::get_singleton();
-	rs->free(q->debug_canvas_item);
+	// Free the runtime tile data.
+	for (Map<Vector2i, RTileData *>::Element *E = q->runtime_tile_data_cache.front(); E; E = E->next()) {
+		memdelete(E->value());
+	}
+	q->runtime_tile_data_cache.clear();
+
+	// Release the debug canvas item.
+	_release_canvas_item(q->debug_canvas_item);
 
 	layers[q->layer].quadrant_map.erase(Q);
 	rect_cache_dirty = true;
@@ -940,6 +1735,9 @@ void RTileMap::_clear_layer_internals(int p_layer) {
 
 	// Clear the layers internals.
 	_rendering_cleanup_layer(p_layer);
+	_pathfinding_clear_layer(p_layer);
+	layers[p_layer].tiles_quadrants.clear();
+	layers[p_layer].tiles_quadrants_valid = false;
 
 	// Clear the dirty quadrants list.
 	while (layers[p_layer].dirty_quadrant_list.first()) {
@@ -954,6 +1752,88 @@ void RTileMap::_clear_internals() {
 	}
 }
 
+RID RTileMap::_acquire_canvas_item() {
+	if (canvas_item_pool.rids.empty()) {
+		canvas_item_pool.created_count++;
+		return VisualServer::get_singleton()->canvas_item_create();
+	}
+	canvas_item_pool.reused_count++;
+	RID canvas_item = canvas_item_pool.rids[canvas_item_pool.rids.size() - 1];
+	canvas_item_pool.rids.resize(canvas_item_pool.rids.size() - 1);
+	return canvas_item;
+}
+
+void RTileMap::_release_canvas_item(RID p_canvas_item) {
+	// Reset the canvas item to its default state, detached from the tree.
+	VisualServer *rs = VisualServer::get_singleton();
+	rs->canvas_item_clear(p_canvas_item);
+	rs->canvas_item_set_parent(p_canvas_item, RID());
+	rs->canvas_item_set_material(p_canvas_item, RID());
+	rs->canvas_item_set_use_parent_material(p_canvas_item, false);
+	rs->canvas_item_set_transform(p_canvas_item, Transform2D());
+	rs->canvas_item_set_light_mask(p_canvas_item, 1);
+	rs->canvas_item_set_z_index(p_canvas_item, 0);
+	rs->canvas_item_set_draw_index(p_canvas_item, 0);
+	canvas_item_pool.rids.push_back(p_canvas_item);
+	canvas_item_pool.released_count++;
+}
+
+RID RTileMap::_acquire_occluder() {
+	if (occluder_pool.rids.empty()) {
+		occluder_pool.created_count++;
+		return VisualServer::get_singleton()->canvas_light_occluder_create();
+	}
+	occluder_pool.reused_count++;
+	RID occluder = occluder_pool.rids[occluder_pool.rids.size() - 1];
+	occluder_pool.rids.resize(occluder_pool.rids.size() - 1);
+	return occluder;
+}
+
+void RTileMap::_release_occluder(RID p_occluder) {
+	VisualServer *rs = VisualServer::get_singleton();
+	rs->canvas_light_occluder_attach_to_canvas(p_occluder, RID());
+	rs->canvas_light_occluder_set_polygon(p_occluder, RID());
+	rs->canvas_light_occluder_set_enabled(p_occluder, false);
+	occluder_pool.rids.push_back(p_occluder);
+	occluder_pool.released_count++;
+}
+
+RID RTileMap::_acquire_body() {
+	if (body_pool.rids.empty()) {
+		body_pool.created_count++;
+		return Physics2DServer::get_singleton()->body_create();
+	}
+	body_pool.reused_count++;
+	RID body = body_pool.rids[body_pool.rids.size() - 1];
+	body_pool.rids.resize(body_pool.rids.size() - 1);
+	return body;
+}
+
+void RTileMap::_release_body(RID p_body) {
+	// Out of the space and without shapes, the body does not cost anything to the physics server.
+	Physics2DServer *ps = Physics2DServer::get_singleton();
+	ps->body_set_space(p_body, RID());
+	ps->body_clear_shapes(p_body);
+	ps->body_attach_object_instance_id(p_body, 0);
+	body_pool.rids.push_back(p_body);
+	body_pool.released_count++;
+}
+
+void RTileMap::_free_rid_pools() {
+	for (uint32_t i = 0; i < canvas_item_pool.rids.size(); i++) {
+		VisualServer::get_singleton()->free(canvas_item_pool.rids[i]);
+	}
+	canvas_item_pool.rids.clear();
+	for (uint32_t i = 0; i < occluder_pool.rids.size(); i++) {
+		VisualServer::get_singleton()->free(occluder_pool.rids[i]);
+	}
+	occluder_pool.rids.clear();
+	for (uint32_t i = 0; i < body_pool.rids.size(); i++) {
+		Physics2DServer::get_singleton()->free(body_pool.rids[i]);
+	}
+	body_pool.rids.clear();
+}
+
 void RTileMap::_recompute_rect_cache() {
 	// Compute the displayed area of the tilemap.
 #ifdef DEBUG_ENABLED
@@ -998,13 +1878,10 @@ void RTileMap::_rendering_notification(int p_what) {
 
 					RTileMapQuadrant &q = E_quadrant->value();
 
-					// Update occluders transform.
-					for (Map<Vector2i, Vector2i, RTileMapQuadrant::CoordsWorldComparator>::Element *E_cell = q.world_to_map.front(); E_cell; E_cell = E_cell->next()) {
-						Transform2D xform;
-						xform.set_origin(E_cell->key());
-
-						for (List<RID>::Element *occluder = q.occluders.front(); occluder; occluder = occluder->next()) {
-							VS::get_singleton()->canvas_light_occluder_set_enabled(occluder->get(), visible);
+					// Update occluders visibility.
+					for (Map<Vector2i, Vector<RID>>::Element *E_cell = q.occluders.front(); E_cell; E_cell = E_cell->next()) {
+						for (int i = 0; i < E_cell->value().size(); i++) {
+							VS::get_singleton()->canvas_light_occluder_set_enabled(E_cell->value()[i], visible);
 						}
 					}
 				}
@@ -1023,13 +1900,12 @@ void RTileMap::_rendering_notification(int p_what) {
 					RTileMapQuadrant &q = E_quadrant->value();
 
 					// Update occluders transform.
-
-					for (Map<Vector2i, Vector2i, RTileMapQuadrant::CoordsWorldComparator>::Element *E_cell = q.world_to_map.front(); E_cell; E_cell = E_cell->next()) {
+					for (Map<Vector2i, Vector<RID>>::Element *E_cell = q.occluders.front(); E_cell; E_cell = E_cell->next()) {
 						Transform2D xform;
-						xform.set_origin(E_cell->key());
+						xform.set_origin(map_to_world(E_cell->key()));
 
-						for (List<RID>::Element *occluder = q.occluders.front(); occluder; occluder = occluder->next()) {
-							VS::get_singleton()->canvas_light_occluder_set_transform(occluder->get(), get_global_transform() * xform);
+						for (int i = 0; i < E_cell->value().size(); i++) {
+							VS::get_singleton()->canvas_light_occluder_set_transform(E_cell->value()[i], get_global_transform() * xform);
 						}
 					}
 				}
@@ -1040,6 +1916,24 @@ void RTileMap::_rendering_notification(int p_what) {
 				VisualServer::get_singleton()->canvas_item_set_sort_children_by_y(get_canvas_item(), is_y_sort_enabled());
 			}
 		} break;
+		case NOTIFICATION_INTERNAL_PROCESS: {
+			if (!is_visible_in_tree()) {
+				return;
+			}
+
+			// Only redraw the animated batches whose visible frame changed.
+			double time = get_animation_time();
+			for (SelfList<RTileMapQuadrant> *E = animated_quadrant_list.first(); E; E = E->next()) {
+				RTileMapQuadrant &q = *E->self();
+				for (uint32_t batch_index = 0; batch_index < q.rendering_batches.size(); batch_index++) {
+					RTileMapQuadrant::RenderingBatch &batch = q.rendering_batches[batch_index];
+					if (batch.animated && time >= batch.next_frame_change) {
+						VisualServer::get_singleton()->canvas_item_clear(batch.canvas_item);
+						_rendering_draw_animated_batch(q, batch, _rendering_get_layer_modulate(q.layer));
+					}
+				}
+			}
+		} break;
 	}
 }
 
@@ -1087,129 +1981,140 @@ void RTileMap::_rendering_update_dirty_quadrants(SelfList<RTileMapQuadrant>::Lis
 	SelfList<RTileMapQuadrant> *q_list_element = r_dirty_quadrant_list.first();
 	while (q_list_element) {
 		RTileMapQuadrant &q = *q_list_element->self();
+		if (!(q.dirty_aspects & RTileSet::TILE_CHANGE_RENDERING) || q.rendering_culled) {
+			// Culled quadrants are fully redrawn once back in the viewport.
+			q_list_element = q_list_element->next();
+			continue;
+		}
 
 		VisualServer *rs = VisualServer::get_singleton();
+		LocalVector<RTileMapQuadrant::RenderingBatch> &batches = q.next_rendering_batches;
 
-		// Free the canvas items.
-		for (List<RID>::Element *ci = q.canvas_items.front(); ci; ci = ci->next()) {
-			rs->free(ci->get());
+		// Free the occluders of the modified cells.
+		if (q.full_update) {
+			for (Map<Vector2i, Vector<RID>>::Element *E = q.occluders.front(); E; E = E->next()) {
+				for (int i = 0; i < E->value().size(); i++) {
+					_release_occluder(E->value()[i]);
+				}
+			}
+			q.occluders.clear();
+		} else {
+			for (Set<Vector2i>::Element *E_cell = q.dirty_cells.front(); E_cell; E_cell = E_cell->next()) {
+				Map<Vector2i, Vector<RID>>::Element *E = q.occluders.find(E_cell->get());
+				if (E) {
+					for (int i = 0; i < E->value().size(); i++) {
+						_release_occluder(E->value()[i]);
+					}
+					q.occluders.erase(E);
+				}
+			}
 		}
-		q.canvas_items.clear();
 
-		// Free the occluders.
-		for (List<RID>::Element *occluder = q.occluders.front(); occluder; occluder = occluder->next()) {
-			rs->free(occluder->get());
-		}
-		q.occluders.clear();
+		Color modulate = _rendering_get_layer_modulate(q.layer);
 
-		// Those allow to group cell per material or z-index.
-		Ref<ShaderMaterial> prev_material;
-		int prev_z_index = 0;
-		RID prev_canvas_item;
+		// Create the occluders of the modified cells.
+		for (uint32_t i = 0; i < q.cells_to_update.size(); i++) {
+			uint32_t cell_index = q.cells_to_update[i];
+			const RTileData *tile_data = q.cells_tile_data[cell_index];
+			if (!tile_data) {
+				// Not an atlas tile.
+				continue;
+			}
+			const RTileMapQuadrant::Cell &cell = q.cells[cell_index];
 
-		Color modulate = get_self_modulate();
-		modulate *= get_layer_modulate(q.layer);
-		if (selected_layer >= 0) {
-			int z1 = get_layer_z_index(q.layer);
-			int z2 = get_layer_z_index(selected_layer);
-			if (z1 < z2 || (z1 == z2 && q.layer < selected_layer)) {
-				modulate = modulate.darkened(0.5);
-			} else if (z1 > z2 || (z1 == z2 && q.layer > selected_layer)) {
-				modulate = modulate.darkened(0.5);
-				modulate.a *= 0.3;
+			Transform2D xform;
+			xform.set_origin(cell.world_position);
+			for (int i = 0; i < tile_set->get_occlusion_layers_count(); i++) {
+				if (tile_data->get_occluder(i).is_valid()) {
+					RID occluder_id = _acquire_occluder();
+					rs->canvas_light_occluder_set_enabled(occluder_id, visible);
+					rs->canvas_light_occluder_set_transform(occluder_id, get_global_transform() * xform);
+					rs->canvas_light_occluder_set_polygon(occluder_id, tile_data->get_occluder(i)->get_rid());
+					rs->canvas_light_occluder_attach_to_canvas(occluder_id, get_canvas());
+					rs->canvas_light_occluder_set_light_mask(occluder_id, tile_set->get_occlusion_layer_light_mask(i));
+					q.occluders[cell.coords].push_back(occluder_id);
+				}
 			}
 		}
 
-		// Iterate over the cells of the quadrant.
-		for (Map<Vector2i, Vector2i, RTileMapQuadrant::CoordsWorldComparator>::Element *E_cell = q.world_to_map.front(); E_cell; E_cell = E_cell->next()) {
-			RTileMapCell c = get_cell(q.layer, E_cell->value(), true);
+		// Update the canvas items, reusing the previous ones where possible.
+		bool batches_structure_changed = batches.size() != q.rendering_batches.size();
+		for (uint32_t batch_index = 0; batch_index < batches.size(); batch_index++) {
+			RTileMapQuadrant::RenderingBatch &batch = batches[batch_index];
 
-			RTileSetSource *source;
-			if (tile_set->has_source(c.source_id)) {
-				source = *tile_set->get_source(c.source_id);
+			if (batch_index < q.rendering_batches.size()) {
+				RTileMapQuadrant::RenderingBatch &prev_batch = q.rendering_batches[batch_index];
+				batch.canvas_item = prev_batch.canvas_item;
 
-				if (!source->has_tile(c.get_atlas_coords()) || !source->has_alternative_tile(c.get_atlas_coords(), c.alternative_tile)) {
+				// Keep the canvas item untouched if none of its cells changed.
+				bool batch_changed = q.full_update || prev_batch.material != batch.material || prev_batch.z_index != batch.z_index || prev_batch.animated != batch.animated || prev_batch.cells.size() != batch.cells.size();
+				for (uint32_t i = 0; !batch_changed && i < batch.cells.size(); i++) {
+					batch_changed = prev_batch.cells[i] != batch.cells[i] || q.dirty_cells.has(batch.cells[i]);
+				}
+				if (!batch_changed) {
+					batch.next_frame_change = prev_batch.next_frame_change;
 					continue;
 				}
+				rs->canvas_item_clear(batch.canvas_item);
+			} else {
+				batch.canvas_item = _acquire_canvas_item();
+				rs->canvas_item_set_parent(batch.canvas_item, layers[q.layer].canvas_item);
+				batches_structure_changed = true;
+			}
 
-				RTileSetAtlasSource *atlas_source = Object::cast_to<RTileSetAtlasSource>(source);
-				if (atlas_source) {
-					// Get the tile data.
-					const RTileData *tile_data;
-					if (q.runtime_tile_data_cache.has(E_cell->value())) {
-						tile_data = q.runtime_tile_data_cache[E_cell->value()];
-					} else {
-						tile_data = Object::cast_to<RTileData>(atlas_source->get_tile_data(c.get_atlas_coords(), c.alternative_tile));
-					}
-
-					Ref<ShaderMaterial> mat = tile_data->get_material();
-					int z_index = tile_data->get_z_index();
-
-					// Quandrant pos.
-					Vector2 position = map_to_world(q.coords * get_effective_quadrant_size(q.layer));
-					if (is_y_sort_enabled() && layers[q.layer].y_sort_enabled) {
-						// When Y-sorting, the quandrant size is sure to be 1, we can thus offset the CanvasItem.
-						position.y += layers[q.layer].y_sort_origin + tile_data->get_y_sort_origin();
-					}
-
-					// --- CanvasItems ---
-					// Create two canvas items, for rendering and debug.
-					RID canvas_item;
-
-					// Check if the material or the z_index changed.
-					if (prev_canvas_item == RID() || prev_material != mat || prev_z_index != z_index) {
-						// If so, create a new CanvasItem.
-						canvas_item = rs->canvas_item_create();
-						if (mat.is_valid()) {
-							rs->canvas_item_set_material(canvas_item, mat->get_rid());
-						}
-						rs->canvas_item_set_parent(canvas_item, layers[q.layer].canvas_item);
-						rs->canvas_item_set_use_parent_material(canvas_item, get_use_parent_material() || get_material().is_valid());
-
-						Transform2D xform;
-						xform.set_origin(position);
-						rs->canvas_item_set_transform(canvas_item, xform);
-
-						rs->canvas_item_set_light_mask(canvas_item, get_light_mask());
-						rs->canvas_item_set_z_index(canvas_item, z_index);
-
-						//TODO
-						//rs->canvas_item_set_default_texture_filter(canvas_item, VS::CanvasItemTextureFilter(get_texture_filter()));
-						//rs->canvas_item_set_default_texture_repeat(canvas_item, VS::CanvasItemTextureRepeat(get_texture_repeat()));
-
-						q.canvas_items.push_back(canvas_item);
-
-						prev_canvas_item = canvas_item;
-						prev_material = mat;
-						prev_z_index = z_index;
+			// --- CanvasItems ---
+			rs->canvas_item_set_material(batch.canvas_item, batch.material.is_valid() ? batch.material->get_rid() : RID());
+			rs->canvas_item_set_use_parent_material(batch.canvas_item, get_use_parent_material() || get_material().is_valid());
 
-					} else {
-						// Keep the same canvas_item to draw on.
-						canvas_item = prev_canvas_item;
-					}
+			Transform2D xform;
+			xform.set_origin(batch.position);
+			rs->canvas_item_set_transform(batch.canvas_item, xform);
 
-					// Drawing the tile in the canvas item.
-					draw_tile(canvas_item, E_cell->key() - position, tile_set, c.source_id, c.get_atlas_coords(), c.alternative_tile, -1, modulate, tile_data);
+			rs->canvas_item_set_light_mask(batch.canvas_item, get_light_mask());
+			rs->canvas_item_set_z_index(batch.canvas_item, batch.z_index);
 
-					// --- Occluders ---
-					for (int i = 0; i < tile_set->get_occlusion_layers_count(); i++) {
-						Transform2D xform;
-						xform.set_origin(E_cell->key());
-						if (tile_data->get_occluder(i).is_valid()) {
-							RID occluder_id = rs->canvas_light_occluder_create();
-							rs->canvas_light_occluder_set_enabled(occluder_id, visible);
-							rs->canvas_light_occluder_set_transform(occluder_id, get_global_transform() * xform);
-							rs->canvas_light_occluder_set_polygon(occluder_id, tile_data->get_occluder(i)->get_rid());
-							rs->canvas_light_occluder_attach_to_canvas(occluder_id, get_canvas());
-							rs->canvas_light_occluder_set_light_mask(occluder_id, tile_set->get_occlusion_layer_light_mask(i));
-							q.occluders.push_back(occluder_id);
-						}
+			//TODO
+			//rs->canvas_item_set_default_texture_filter(canvas_item, VS::CanvasItemTextureFilter(get_texture_filter()));
+			//rs->canvas_item_set_default_texture_repeat(canvas_item, VS::CanvasItemTextureRepeat(get_texture_repeat()));
+
+			// Drawing the tiles in the canvas item.
+			if (batch.animated) {
+				_rendering_draw_animated_batch(q, batch, modulate);
+			} else if (use_mesh_batching && !tile_set->is_uv_clipping()) {
+				_rendering_draw_batch_mesh(q, batch, modulate);
+			} else {
+				for (uint32_t cell_index = batch.cells_begin; cell_index < batch.cells_end; cell_index++) {
+					const RTileData *tile_data = q.cells_tile_data[cell_index];
+					if (!tile_data) {
+						continue;
 					}
+					const RTileMapCell &c = q.cells_resolution[cell_index]->cell;
+					draw_tile(batch.canvas_item, q.cells[cell_index].world_position - batch.position, tile_set, c.source_id, c.get_atlas_coords(), c.alternative_tile, -1, modulate, tile_data);
 				}
 			}
 		}
 
-		_rendering_quadrant_order_dirty = true;
+		// Release the canvas items that are not needed anymore.
+		for (uint32_t batch_index = batches.size(); batch_index < q.rendering_batches.size(); batch_index++) {
+			_release_canvas_item(q.rendering_batches[batch_index].canvas_item);
+		}
+		q.rendering_batches = batches;
+		batches.clear();
+
+		// Track the quadrants with animated tiles.
+		bool animated = false;
+		for (uint32_t batch_index = 0; !animated && batch_index < q.rendering_batches.size(); batch_index++) {
+			animated = q.rendering_batches[batch_index].animated;
+		}
+		if (animated && !q.animated_list_element.in_list()) {
+			animated_quadrant_list.add(&q.animated_list_element);
+		} else if (!animated && q.animated_list_element.in_list()) {
+			animated_quadrant_list.remove(&q.animated_list_element);
+		}
+
+		if (batches_structure_changed) {
+			_rendering_quadrant_order_dirty = true;
+		}
 		q_list_element = q_list_element->next();
 	}
 
@@ -1229,8 +2134,8 @@ void RTileMap::_rendering_update_dirty_quadrants(SelfList<RTileMapQuadrant>::Lis
 			for (Map<Vector2i, Vector2i, RTileMapQuadrant::CoordsWorldComparator>::Element *E = world_to_map.front(); E; E = E->next()) {
 				RTileMapQuadrant &q = layers[layer].quadrant_map[E->value()];
 
-				for (List<RID>::Element *ci = q.canvas_items.front(); ci; ci = ci->next()) {
-					VS::get_singleton()->canvas_item_set_draw_index(ci->get(), index++);
+				for (uint32_t i = 0; i < q.rendering_batches.size(); i++) {
+					VS::get_singleton()->canvas_item_set_draw_index(q.rendering_batches[i].canvas_item, index++);
 				}
 			}
 		}
@@ -1242,20 +2147,90 @@ void RTileMap::_rendering_create_quadrant(RTileMapQuadrant *p_quadrant) {
 	ERR_FAIL_COND(!tile_set.is_valid());
 
 	_rendering_quadrant_order_dirty = true;
+
+	// New quadrants are rendered once found in the viewport.
+	if (use_viewport_culling) {
+		p_quadrant->rendering_culled = true;
+		viewport_culling_dirty = true;
+	}
 }
 
 void RTileMap::_rendering_cleanup_quadrant(RTileMapQuadrant *p_quadrant) {
-	// Free the canvas items.
-	for (List<RID>::Element *ci = p_quadrant->canvas_items.front(); ci; ci = ci->next()) {
-		VisualServer::get_singleton()->free(ci->get());
+	// Release the canvas items.
+	for (uint32_t i = 0; i < p_quadrant->rendering_batches.size(); i++) {
+		_release_canvas_item(p_quadrant->rendering_batches[i].canvas_item);
+	}
+	p_quadrant->rendering_batches.clear();
+	if (p_quadrant->animated_list_element.in_list()) {
+		animated_quadrant_list.remove(&p_quadrant->animated_list_element);
 	}
-	p_quadrant->canvas_items.clear();
 
-	// Free the occluders.
-	for (List<RID>::Element *occluder = p_quadrant->occluders.front(); occluder; occluder = occluder->next()) {
-		VisualServer::get_singleton()->free(occluder->get());
+	// Release the occluders.
+	for (Map<Vector2i, Vector<RID>>::Element *E = p_quadrant->occluders.front(); E; E = E->next()) {
+		for (int i = 0; i < E->value().size(); i++) {
+			_release_occluder(E->value()[i]);
+		}
 	}
 	p_quadrant->occluders.clear();
+
+	if (p_quadrant->rendered_list_element.in_list()) {
+		rendered_quadrant_list.remove(&p_quadrant->rendered_list_element);
+	}
+}
+
+Rect2 RTileMap::_rendering_get_visible_rect() const {
+	// The viewport, as seen by the active camera, in local coordinates.
+	return get_global_transform_with_canvas().affine_inverse().xform(get_viewport_rect());
+}
+
+void RTileMap::_rendering_uncull_quadrant(RTileMapQuadrant &r_quadrant) {
+	r_quadrant.rendering_culled = false;
+	if (use_viewport_culling) {
+		rendered_quadrant_list.add(&r_quadrant.rendered_list_element);
+	}
+
+	// Redraw the whole quadrant.
+	_make_quadrant_fully_dirty(r_quadrant, RTileSet::TILE_CHANGE_RENDERING);
+}
+
+void RTileMap::_rendering_update_culling() {
+	if (!use_viewport_culling || !is_inside_tree() || !tile_set.is_valid()) {
+		return;
+	}
+
+	// Only check the quadrants when the camera moved, or quadrants were created.
+	Rect2 visible_rect = _rendering_get_visible_rect();
+	if (!viewport_culling_dirty && visible_rect == viewport_culling_rect) {
+		return;
+	}
+	viewport_culling_rect = visible_rect;
+	viewport_culling_dirty = false;
+
+	Rect2 show_rect = visible_rect.grow(viewport_culling_margin);
+	Rect2 release_rect = visible_rect.grow(MAX(viewport_culling_release_margin, viewport_culling_margin));
+
+	// Release the quadrants out of the release rect. The distance between both rects avoids churn when the camera jitters.
+	SelfList<RTileMapQuadrant> *E = rendered_quadrant_list.first();
+	while (E) {
+		SelfList<RTileMapQuadrant> *next = E->next();
+		RTileMapQuadrant &q = *E->self();
+		if (!_get_quadrant_rect(q).intersects(release_rect)) {
+			_rendering_cleanup_quadrant(&q);
+			q.rendering_culled = true;
+		}
+		E = next;
+	}
+
+	// Create the ones entering the show rect.
+	LocalVector<RTileMapQuadrant *> quadrants;
+	for (unsigned int layer = 0; layer < layers.size(); layer++) {
+		_find_quadrants_in_rect(layer, show_rect, quadrants);
+	}
+	for (uint32_t i = 0; i < quadrants.size(); i++) {
+		if (quadrants[i]->rendering_culled) {
+			_rendering_uncull_quadrant(*quadrants[i]);
+		}
+	}
 }
 
 void RTileMap::_rendering_draw_quadrant_debug(RTileMapQuadrant *p_quadrant) {
@@ -1268,8 +2243,10 @@ void RTileMap::_rendering_draw_quadrant_debug(RTileMapQuadrant *p_quadrant) {
 	// Draw a placeholder for scenes needing one.
 	VisualServer *rs = VisualServer::get_singleton();
 	Vector2 quadrant_pos = map_to_world(p_quadrant->coords * get_effective_quadrant_size(p_quadrant->layer));
-	for (Set<Vector2i>::Element *E_cell = p_quadrant->cells.front(); E_cell; E_cell = E_cell->next()) {
-		const RTileMapCell &c = get_cell(p_quadrant->layer, E_cell->get(), true);
+	for (uint32_t cell_index = 0; cell_index < p_quadrant->cells.size(); cell_index++) {
+		const Vector2i &pk = p_quadrant->cells[cell_index].coords;
+
+		const RTileMapCell &c = get_cell(p_quadrant->layer, pk, true);
 
 		RTileSetSource *source;
 		if (tile_set->has_source(c.source_id)) {
@@ -1299,7 +2276,7 @@ void RTileMap::_rendering_draw_quadrant_debug(RTileMapQuadrant *p_quadrant) {
 
 					// Draw a placeholder tile.
 					Transform2D xform;
-					xform.set_origin(map_to_world(E_cell->get()) - quadrant_pos);
+					xform.set_origin(map_to_world(pk) - quadrant_pos);
 					rs->canvas_item_add_set_transform(p_quadrant->debug_canvas_item, xform);
 					rs->canvas_item_add_circle(p_quadrant->debug_canvas_item, Vector2(), MIN(tile_set->get_tile_size().x, tile_set->get_tile_size().y) / 4.0, color);
 				}
@@ -1308,6 +2285,151 @@ void RTileMap::_rendering_draw_quadrant_debug(RTileMapQuadrant *p_quadrant) {
 	}
 }
 
+Color RTileMap::_rendering_get_layer_modulate(int p_layer) const {
+	Color modulate = get_self_modulate();
+	modulate *= get_layer_modulate(p_layer);
+	if (selected_layer >= 0) {
+		int z1 = get_layer_z_index(p_layer);
+		int z2 = get_layer_z_index(selected_layer);
+		if (z1 < z2 || (z1 == z2 && p_layer < selected_layer)) {
+			modulate = modulate.darkened(0.5);
+		} else if (z1 > z2 || (z1 == z2 && p_layer > selected_layer)) {
+			modulate = modulate.darkened(0.5);
+			modulate.a *= 0.3;
+		}
+	}
+	return modulate;
+}
+
+void RTileMap::_rendering_draw_animated_batch(const RTileMapQuadrant &p_quadrant, RTileMapQuadrant::RenderingBatch &r_batch, const Color &p_modulation) {
+	// Draw the frames visible now, and remember when the first of them changes.
+	// The tiles are resolved again, as this is also called outside of quadrant updates.
+	double time = get_animation_time();
+	r_batch.next_frame_change = Math_INF;
+
+	const TileMapLayer &layer = layers[p_quadrant.layer];
+	for (uint32_t i = 0; i < r_batch.cells.size(); i++) {
+		const Vector2i &coords = r_batch.cells[i];
+		const RTileMapCell *cell = layer.tile_map.get_cell(coords);
+		const RTileSet::TileResolution *resolution = cell ? tile_set->resolve_tile(*cell) : nullptr;
+		if (!resolution || !resolution->atlas_source) {
+			continue;
+		}
+		const Map<Vector2i, RTileData *>::Element *E_runtime = p_quadrant.runtime_tile_data_cache.find(coords);
+		const RTileData *tile_data = E_runtime ? E_runtime->value() : resolution->tile_data;
+
+		const RTileMapCell &c = resolution->cell;
+		double time_left = 0.0;
+		int frame = resolution->atlas_source->get_tile_animation_frame_at_time(c.get_atlas_coords(), time, &time_left);
+		draw_tile(r_batch.canvas_item, _get_cell_world_position(coords) - r_batch.position, tile_set, c.source_id, c.get_atlas_coords(), c.alternative_tile, frame, p_modulation, tile_data);
+		if (time_left >= 0.0) {
+			r_batch.next_frame_change = MIN(r_batch.next_frame_change, time + time_left);
+		}
+	}
+}
+
+void RTileMap::_rendering_draw_batch_mesh(const RTileMapQuadrant &p_quadrant, const RTileMapQuadrant::RenderingBatch &p_batch, const Color &p_modulation) {
+	TileMesh mesh;
+	for (uint32_t cell_index = p_batch.cells_begin; cell_index < p_batch.cells_end; cell_index++) {
+		const RTileData *tile_data = p_quadrant.cells_tile_data[cell_index];
+		if (!tile_data) {
+			continue;
+		}
+		const RTileSet::TileResolution *resolution = p_quadrant.cells_resolution[cell_index];
+		RTileSetAtlasSource *atlas_source = resolution->atlas_source;
+		const RTileMapCell &c = resolution->cell;
+		Vector2i atlas_coords = c.get_atlas_coords();
+		Vector2i position = p_quadrant.cells[cell_index].world_position - p_batch.position;
+
+		Ref<Texture> tex = atlas_source->get_runtime_texture();
+		if (!tex.is_valid()) {
+			continue;
+		}
+		Vector2i grid_size = atlas_source->get_atlas_grid_size();
+		if (atlas_coords.x >= grid_size.x || atlas_coords.y >= grid_size.y) {
+			continue;
+		}
+
+		// Same rects as draw_tile().
+		Vector2i tile_offset = atlas_source->get_tile_effective_texture_offset(atlas_coords, c.alternative_tile);
+		Rect2 dest_rect;
+		dest_rect.size = resolution->texture_region.size;
+		dest_rect.size.x += FP_ADJUST;
+		dest_rect.size.y += FP_ADJUST;
+
+		bool transpose = tile_data->get_transpose();
+		if (transpose) {
+			dest_rect.position = (position - Vector2(dest_rect.size.y, dest_rect.size.x) / 2 - tile_offset);
+		} else {
+			dest_rect.position = (position - dest_rect.size / 2 - tile_offset);
+		}
+		bool flip_h = tile_data->get_flip_h();
+		if (flip_h) {
+			dest_rect.size.x = -dest_rect.size.x;
+		}
+		bool flip_v = tile_data->get_flip_v();
+		if (flip_v) {
+			dest_rect.size.y = -dest_rect.size.y;
+		}
+
+		// Let the texture remap the rects (for example for atlas textures).
+		Rect2 source_rect = resolution->texture_region;
+		if (!tex->get_rect_region(dest_rect, source_rect, dest_rect, source_rect)) {
+			continue;
+		}
+
+		RID texture_rid = tex->get_rid();
+		if (texture_rid != mesh.texture || mesh.points.size() >= TILE_MESH_MAX_TILES * 4) {
+			_rendering_flush_tile_mesh(p_batch.canvas_item, mesh);
+			if (texture_rid != mesh.texture) {
+				VisualServer *rs = VisualServer::get_singleton();
+				mesh.texture = texture_rid;
+				mesh.texture_pixel_size = Vector2(1.0 / MAX(rs->texture_get_width(texture_rid), 1u), 1.0 / MAX(rs->texture_get_height(texture_rid), 1u));
+			}
+		}
+
+		// Match the canvas texture rect: flips mirror the destination, transposing swaps the source axes.
+		Vector2 size = dest_rect.size.abs();
+		if (transpose) {
+			SWAP(size.x, size.y);
+		}
+		Color modulate = tile_data->get_modulate() * p_modulation;
+		static const Vector2 corners[4] = { Vector2(0, 0), Vector2(1, 0), Vector2(1, 1), Vector2(0, 1) };
+
+		int base = mesh.points.size();
+		for (int corner_index = 0; corner_index < 4; corner_index++) {
+			const Vector2 &corner = corners[corner_index];
+			Vector2 destination_corner = Vector2(flip_h ? 1.0 - corner.x : corner.x, flip_v ? 1.0 - corner.y : corner.y);
+			Vector2 source_corner = transpose ? Vector2(corner.y, corner.x) : corner;
+			mesh.points.push_back(dest_rect.position + size * destination_corner);
+			mesh.uvs.push_back((source_rect.position + source_rect.size * source_corner) * mesh.texture_pixel_size);
+			mesh.colors.push_back(modulate);
+		}
+		mesh.indices.push_back(base);
+		mesh.indices.push_back(base + 1);
+		mesh.indices.push_back(base + 2);
+		mesh.indices.push_back(base);
+		mesh.indices.push_back(base + 2);
+		mesh.indices.push_back(base + 3);
+	}
+	_rendering_flush_tile_mesh(p_batch.canvas_item, mesh);
+}
+
+void RTileMap::_rendering_flush_tile_mesh(RID p_canvas_item, TileMesh &r_mesh) {
+	if (r_mesh.indices.empty()) {
+		return;
+	}
+	VisualServer::get_singleton()->canvas_item_add_triangle_array(p_canvas_item, r_mesh.indices, r_mesh.points, r_mesh.colors, r_mesh.uvs, Vector<int>(), Vector<float>(), r_mesh.texture);
+	r_mesh.indices.clear();
+	r_mesh.points.clear();
+	r_mesh.colors.clear();
+	r_mesh.uvs.clear();
+}
+
+double RTileMap::get_animation_time() {
+	return OS::get_singleton()->get_ticks_usec() / 1000000.0;
+}
+
 void RTileMap::draw_tile(RID p_canvas_item, Vector2i p_position, const Ref<RTileSet> p_tile_set, int p_atlas_source_id, Vector2i p_atlas_coords, int p_alternative_tile, int p_frame, Color p_modulation, const RTileData *p_tile_data_override) {
 	ERR_FAIL_COND(!p_tile_set.is_valid());
 	ERR_FAIL_COND(!p_tile_set->has_source(p_atlas_source_id));
@@ -1371,21 +2493,10 @@ void RTileMap::draw_tile(RID p_canvas_item, Vector2i p_position, const Ref<RTile
 			Rect2i source_rect = atlas_source->get_runtime_tile_texture_region(p_atlas_coords, 0);
 			tex->draw_rect_region(p_canvas_item, dest_rect, source_rect, modulate, transpose, Ref<Texture>(), p_tile_set->is_uv_clipping());
 		} else {
-			//TODO
-			//real_t speed = atlas_source->get_tile_animation_speed(p_atlas_coords);
-			//real_t animation_duration = atlas_source->get_tile_animation_total_duration(p_atlas_coords) / speed;
-			//real_t time = 0.0;
-			for (int frame = 0; frame < atlas_source->get_tile_animation_frames_count(p_atlas_coords); frame++) {
-				//real_t frame_duration = atlas_source->get_tile_animation_frame_duration(p_atlas_coords, frame) / speed;
-				//VisualServer::get_singleton()->canvas_item_add_animation_slice(p_canvas_item, animation_duration, time, time + frame_duration, 0.0);
-
-				Rect2i source_rect = atlas_source->get_runtime_tile_texture_region(p_atlas_coords, frame);
-				tex->draw_rect_region(p_canvas_item, dest_rect, source_rect, modulate, transpose, Ref<Texture>(), p_tile_set->is_uv_clipping());
-
-				//time += frame_duration;
-			}
-			//TODO
-			//VisualServer::get_singleton()->canvas_item_add_animation_slice(p_canvas_item, 1.0, 0.0, 1.0, 0.0);
+			// Draw the frame visible at the current animation time, the tile maps redraw it when it changes.
+			int frame = atlas_source->get_tile_animation_frame_at_time(p_atlas_coords, get_animation_time());
+			Rect2i source_rect = atlas_source->get_runtime_tile_texture_region(p_atlas_coords, frame);
+			tex->draw_rect_region(p_canvas_item, dest_rect, source_rect, modulate, transpose, Ref<Texture>(), p_tile_set->is_uv_clipping());
 		}
 	}
 }
@@ -1414,161 +2525,530 @@ void RTileMap::_physics_notification(int p_what) {
 #endif
 			if (is_inside_tree() && (!collision_animatable || in_editor)) {
 				// Update the new transform directly if we are not in animatable mode.
-				Transform2D global_transform = get_global_transform();
-				for (int layer = 0; layer < (int)layers.size(); layer++) {
+				_physics_set_bodies_transform(get_global_transform());
+			}
+		} break;
+		case NOTIFICATION_LOCAL_TRANSFORM_CHANGED: {
+			bool in_editor = false;
+#ifdef TOOLS_ENABLED
+			in_editor = Engine::get_singleton()->is_editor_hint();
+#endif
+			if (is_inside_tree() && !in_editor && collision_animatable) {
+				// Only active when animatable. Send the new transform to the physics...
+				new_transform = get_global_transform();
+				_physics_set_bodies_transform(new_transform);
+
+				// ... but then revert changes.
+				set_notify_local_transform(false);
+				set_global_transform(last_valid_transform);
+				set_notify_local_transform(true);
+			}
+		} break;
+	}
+}
+
+void RTileMap::_physics_set_bodies_transform(const Transform2D &p_global_transform) {
+	Physics2DServer *ps = Physics2DServer::get_singleton();
+	for (int layer = 0; layer < (int)layers.size(); layer++) {
+		for (Map<Vector2i, RTileMapQuadrant>::Element *E = layers[layer].quadrant_map.front(); E; E = E->next()) {
+			RTileMapQuadrant &q = E->value();
+
+			for (Map<Vector2i, Vector<RID>>::Element *E_cell = q.bodies.front(); E_cell; E_cell = E_cell->next()) {
+				Transform2D xform;
+				xform.set_origin(map_to_world(E_cell->key()));
+				xform = p_global_transform * xform;
+
+				for (int i = 0; i < E_cell->value().size(); i++) {
+					ps->body_set_state(E_cell->value()[i], Physics2DServer::BODY_STATE_TRANSFORM, xform);
+				}
+			}
+
+			if (!q.quadrant_bodies.empty()) {
+				Transform2D xform;
+				xform.set_origin(map_to_world(q.coords * get_effective_quadrant_size(q.layer)));
+				xform = p_global_transform * xform;
+
+				for (uint32_t i = 0; i < q.quadrant_bodies.size(); i++) {
+					ps->body_set_state(q.quadrant_bodies[i].body, Physics2DServer::BODY_STATE_TRANSFORM, xform);
+				}
+			}
+		}
+	}
+}
+
+void RTileMap::_physics_update_dirty_quadrants(SelfList<RTileMapQuadrant>::List &r_dirty_quadrant_list) {
+	ERR_FAIL_COND(!is_inside_tree());
+	ERR_FAIL_COND(!tile_set.is_valid());
+
+	Transform2D global_transform = get_global_transform();
+	last_valid_transform = global_transform;
+	new_transform = global_transform;
+	Physics2DServer *ps = Physics2DServer::get_singleton();
+	RID space = get_world_2d()->get_space();
+
+	SelfList<RTileMapQuadrant> *q_list_element = r_dirty_quadrant_list.first();
+	while (q_list_element) {
+		RTileMapQuadrant &q = *q_list_element->self();
+		if (!(q.dirty_aspects & RTileSet::TILE_CHANGE_PHYSICS)) {
+			q_list_element = q_list_element->next();
+			continue;
+		}
+
+		if (collision_use_quadrant_bodies) {
+			_physics_update_quadrant_bodies(q, global_transform);
+			q_list_element = q_list_element->next();
+			continue;
+		}
+
+		// Clear the bodies of the modified cells.
+		if (q.full_update) {
+			for (Map<Vector2i, Vector<RID>>::Element *E = q.bodies.front(); E; E = E->next()) {
+				for (int i = 0; i < E->value().size(); i++) {
+					bodies_coords.erase(E->value()[i]);
+					_release_body(E->value()[i]);
+				}
+			}
+			q.bodies.clear();
+		} else {
+			for (Set<Vector2i>::Element *E_cell = q.dirty_cells.front(); E_cell; E_cell = E_cell->next()) {
+				Map<Vector2i, Vector<RID>>::Element *E = q.bodies.find(E_cell->get());
+				if (E) {
+					for (int i = 0; i < E->value().size(); i++) {
+						bodies_coords.erase(E->value()[i]);
+						_release_body(E->value()[i]);
+					}
+					q.bodies.erase(E);
+				}
+			}
+		}
+
+		// Recreate bodies and shapes of the modified cells.
+		for (uint32_t i = 0; i < q.cells_to_update.size(); i++) {
+			uint32_t cell_index = q.cells_to_update[i];
+			const RTileData *tile_data = q.cells_tile_data[cell_index];
+			if (!tile_data) {
+				continue;
+			}
+			const Vector2i &pk = q.cells[cell_index].coords;
+			for (int tile_set_physics_layer = 0; tile_set_physics_layer < tile_set->get_physics_layers_count(); tile_set_physics_layer++) {
+				if (!_physics_is_layer_active(q, tile_set_physics_layer)) {
+					continue;
+				}
+
+				Ref<PhysicsMaterial> physics_material = tile_set->get_physics_layer_physics_material(tile_set_physics_layer);
+				uint32_t physics_layer = tile_set->get_physics_layer_collision_layer(tile_set_physics_layer);
+				uint32_t physics_mask = tile_set->get_physics_layer_collision_mask(tile_set_physics_layer);
+
+				// Create the body.
+				RID body = _acquire_body();
+				bodies_coords[body] = pk;
+				ps->body_set_mode(body, collision_animatable ? Physics2DServer::BODY_MODE_KINEMATIC : Physics2DServer::BODY_MODE_STATIC);
+				ps->body_set_space(body, space);
+
+				Transform2D xform;
+				xform.set_origin(map_to_world(pk));
+				xform = global_transform * xform;
+				ps->body_set_state(body, Physics2DServer::BODY_STATE_TRANSFORM, xform);
+
+				ps->body_attach_object_instance_id(body, get_instance_id());
+				ps->body_set_collision_layer(body, physics_layer);
+				ps->body_set_collision_mask(body, physics_mask);
+				ps->body_set_pickable(body, false);
+				ps->body_set_state(body, Physics2DServer::BODY_STATE_LINEAR_VELOCITY, tile_data->get_constant_linear_velocity(tile_set_physics_layer));
+				ps->body_set_state(body, Physics2DServer::BODY_STATE_ANGULAR_VELOCITY, tile_data->get_constant_angular_velocity(tile_set_physics_layer));
+
+				if (!physics_material.is_valid()) {
+					ps->body_set_param(body, Physics2DServer::BODY_PARAM_BOUNCE, 0);
+					ps->body_set_param(body, Physics2DServer::BODY_PARAM_FRICTION, 1);
+				} else {
+					ps->body_set_param(body, Physics2DServer::BODY_PARAM_BOUNCE, physics_material->computed_bounce());
+					ps->body_set_param(body, Physics2DServer::BODY_PARAM_FRICTION, physics_material->computed_friction());
+				}
+
+				q.bodies[pk].push_back(body);
+
+				// Add the shapes to the body.
+				int body_shape_index = 0;
+				for (int polygon_index = 0; polygon_index < tile_data->get_collision_polygons_count(tile_set_physics_layer); polygon_index++) {
+					// Iterate over the polygons.
+					bool one_way_collision = tile_data->is_collision_polygon_one_way(tile_set_physics_layer, polygon_index);
+					float one_way_collision_margin = tile_data->get_collision_polygon_one_way_margin(tile_set_physics_layer, polygon_index);
+					int shapes_count = tile_data->get_collision_polygon_shapes_count(tile_set_physics_layer, polygon_index);
+					for (int shape_index = 0; shape_index < shapes_count; shape_index++) {
+						// Add decomposed convex shapes.
+						Ref<ConvexPolygonShape2D> shape = tile_data->get_collision_polygon_shape(tile_set_physics_layer, polygon_index, shape_index);
+						ps->body_add_shape(body, shape->get_rid());
+						ps->body_set_shape_as_one_way_collision(body, body_shape_index, one_way_collision, one_way_collision_margin);
+
+						body_shape_index++;
+					}
+				}
+			}
+		}
+
+		q_list_element = q_list_element->next();
+	}
+}
+
+void RTileMap::_physics_cleanup_quadrant(RTileMapQuadrant *p_quadrant) {
+	// Remove a quadrant.
+	for (Map<Vector2i, Vector<RID>>::Element *E = p_quadrant->bodies.front(); E; E = E->next()) {
+		for (int i = 0; i < E->value().size(); i++) {
+			bodies_coords.erase(E->value()[i]);
+			_release_body(E->value()[i]);
+		}
+	}
+	p_quadrant->bodies.clear();
+
+	_physics_release_quadrant_bodies(*p_quadrant);
+
+	if (p_quadrant->physics_active_list_element.in_list()) {
+		physics_active_quadrant_list.remove(&p_quadrant->physics_active_list_element);
+	}
+}
+
+void RTileMap::_physics_set_quadrant_active_mask(RTileMapQuadrant &r_quadrant, uint32_t p_mask) {
+	if (p_mask == r_quadrant.physics_active_mask) {
+		return;
+	}
+	r_quadrant.physics_active_mask = p_mask;
+
+	if (p_mask && !r_quadrant.physics_active_list_element.in_list()) {
+		physics_active_quadrant_list.add(&r_quadrant.physics_active_list_element);
+	} else if (!p_mask && r_quadrant.physics_active_list_element.in_list()) {
+		physics_active_quadrant_list.remove(&r_quadrant.physics_active_list_element);
+	}
+
+	// The bodies are rebuilt with the dirty quadrants, so activations are spread by the update budget.
+	_make_quadrant_fully_dirty(r_quadrant, RTileSet::TILE_CHANGE_PHYSICS);
+}
+
+void RTileMap::_physics_update_activation() {
+	if (!use_physics_activation || !is_inside_tree() || !tile_set.is_valid()) {
+		return;
+	}
+
+	// Only check the quadrants when an activator moved, or quadrants were created. Freed activators are forgotten.
+	Transform2D to_local = get_global_transform().affine_inverse();
+	bool changed = physics_activation_dirty;
+	for (uint32_t i = 0; i < physics_activators.size();) {
+		Node2D *node = Object::cast_to<Node2D>(ObjectDB::get_instance(physics_activators[i].node_id));
+		if (!node) {
+			physics_activators.remove(i);
+			changed = true;
+			continue;
+		}
+		Vector2 position = to_local.xform(node->get_global_position());
+		if (position != physics_activators[i].position) {
+			physics_activators[i].position = position;
+			changed = true;
+		}
+		i++;
+	}
+	if (!changed) {
+		return;
+	}
+	physics_activation_dirty = false;
+
+	// The collision layers to activate, and the ones to keep, per quadrant in range.
+	struct ActivationMasks {
+		uint32_t activate = 0;
+		uint32_t keep = 0;
+	};
+	Map<RTileMapQuadrant *, ActivationMasks> quadrants_masks;
+	real_t release_distance = MAX(physics_activation_release_distance, physics_activation_distance);
+	LocalVector<RTileMapQuadrant *> quadrants;
+	for (uint32_t i = 0; i < physics_activators.size(); i++) {
+		const PhysicsActivator &activator = physics_activators[i];
+		Rect2 range = Rect2(activator.position, Size2()).grow(release_distance);
+
+		quadrants.clear();
+		for (unsigned int layer = 0; layer < layers.size(); layer++) {
+			_find_quadrants_in_rect(layer, range, quadrants);
+		}
+		for (uint32_t j = 0; j < quadrants.size(); j++) {
+			Rect2 rect = _get_quadrant_rect(*quadrants[j]);
+			Vector2 closest = Vector2(CLAMP(activator.position.x, rect.position.x, rect.position.x + rect.size.x), CLAMP(activator.position.y, rect.position.y, rect.position.y + rect.size.y));
+			real_t distance = activator.position.distance_to(closest);
+			if (distance > release_distance) {
+				continue;
+			}
+			ActivationMasks &masks = quadrants_masks[quadrants[j]];
+			masks.keep |= activator.collision_mask;
+			if (distance <= physics_activation_distance) {
+				masks.activate |= activator.collision_mask;
+			}
+		}
+	}
+
+	// Release the layers out of range. The distance between both ranges avoids churn when an activator moves back and forth.
+	SelfList<RTileMapQuadrant> *E = physics_active_quadrant_list.first();
+	while (E) {
+		SelfList<RTileMapQuadrant> *next = E->next();
+		if (!quadrants_masks.has(E->self())) {
+			_physics_set_quadrant_active_mask(*E->self(), 0);
+		}
+		E = next;
+	}
+	for (Map<RTileMapQuadrant *, ActivationMasks>::Element *E_masks = quadrants_masks.front(); E_masks; E_masks = E_masks->next()) {
+		RTileMapQuadrant &q = *E_masks->key();
+		_physics_set_quadrant_active_mask(q, (q.physics_active_mask & E_masks->get().keep) | E_masks->get().activate);
+	}
+}
+
+static bool _is_full_square_polygon(const Vector<Vector2> &p_polygon, const Vector2 &p_tile_size) {
+	// The four corners of the tile, each consecutive pair sharing one side.
+	if (p_polygon.size() != 4) {
+		return false;
+	}
+	Vector2 half_tile_size = p_tile_size / 2.0;
+	for (int i = 0; i < 4; i++) {
+		if (!Math::is_equal_approx(ABS(p_polygon[i].x), half_tile_size.x) || !Math::is_equal_approx(ABS(p_polygon[i].y), half_tile_size.y)) {
+			return false;
+		}
+	}
+	for (int i = 0; i < 4; i++) {
+		const Vector2 &a = p_polygon[i];
+		const Vector2 &b = p_polygon[(i + 1) % 4];
+		if (((a.x > 0) == (b.x > 0)) == ((a.y > 0) == (b.y > 0))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void RTileMap::_physics_update_quadrant_bodies(RTileMapQuadrant &r_quadrant, const Transform2D &p_global_transform) {
+	// The shapes of all the cells are rebuilt, in released and reacquired bodies.
+	_physics_release_quadrant_bodies(r_quadrant);
+
+	Physics2DServer *ps = Physics2DServer::get_singleton();
+	RID space = get_world_2d()->get_space();
+	Vector2 quadrant_position = map_to_world(r_quadrant.coords * get_effective_quadrant_size(r_quadrant.layer));
+
+	Transform2D body_xform;
+	body_xform.set_origin(quadrant_position);
+	body_xform = p_global_transform * body_xform;
+
+	// Square tiles fully covered by a single polygon are merged into rectangles.
+	bool merge_full_squares = tile_set->get_tile_shape() == RTileSet::TILE_SHAPE_SQUARE;
+	Vector2 tile_size = tile_set->get_tile_size();
+	LocalVector<CollisionMergeGroup> merge_groups;
+
+	for (uint32_t cell_index = 0; cell_index < r_quadrant.cells.size(); cell_index++) {
+		const RTileData *tile_data = r_quadrant.cells_tile_data[cell_index];
+		if (!tile_data) {
+			continue;
+		}
+		const Vector2i &pk = r_quadrant.cells[cell_index].coords;
+
+		Transform2D shape_xform;
+		shape_xform.set_origin(map_to_world(pk) - quadrant_position);
 
-					for (Map<Vector2i, RTileMapQuadrant>::Element *E = layers[layer].quadrant_map.front(); E; E = E->next()) {
-						RTileMapQuadrant &q = E->value();
+		for (int tile_set_physics_layer = 0; tile_set_physics_layer < tile_set->get_physics_layers_count(); tile_set_physics_layer++) {
+			int polygons_count = tile_data->get_collision_polygons_count(tile_set_physics_layer);
+			if (polygons_count == 0 || !_physics_is_layer_active(r_quadrant, tile_set_physics_layer)) {
+				continue;
+			}
 
-						for (List<RID>::Element *body = q.bodies.front(); body; body = body->next()) {
-							Transform2D xform;
-							xform.set_origin(map_to_world(bodies_coords[body->get()]));
-							xform = global_transform * xform;
-							
-							Physics2DServer::get_singleton()->body_set_state(body->get(), Physics2DServer::BODY_STATE_TRANSFORM, xform);
-						}
-					}
+			// Tiles share a body only if they have the same constant velocities.
+			Vector2 linear_velocity = tile_data->get_constant_linear_velocity(tile_set_physics_layer);
+			real_t angular_velocity = tile_data->get_constant_angular_velocity(tile_set_physics_layer);
+			RTileMapQuadrant::PhysicsBody *quadrant_body = nullptr;
+			uint32_t body_index = 0;
+			for (; body_index < r_quadrant.quadrant_bodies.size(); body_index++) {
+				RTileMapQuadrant::PhysicsBody &other = r_quadrant.quadrant_bodies[body_index];
+				if (other.physics_layer == tile_set_physics_layer && other.linear_velocity == linear_velocity && other.angular_velocity == angular_velocity) {
+					quadrant_body = &other;
+					break;
 				}
 			}
-		} break;
-		case NOTIFICATION_LOCAL_TRANSFORM_CHANGED: {
-			bool in_editor = false;
-#ifdef TOOLS_ENABLED
-			in_editor = Engine::get_singleton()->is_editor_hint();
-#endif
-			if (is_inside_tree() && !in_editor && collision_animatable) {
-				// Only active when animatable. Send the new transform to the physics...
-				new_transform = get_global_transform();
-				for (int layer = 0; layer < (int)layers.size(); layer++) {
 
-					for (Map<Vector2i, RTileMapQuadrant>::Element *E = layers[layer].quadrant_map.front(); E; E = E->next()) {
-						RTileMapQuadrant &q = E->value();
+			if (!quadrant_body) {
+				RTileMapQuadrant::PhysicsBody new_body;
+				new_body.body = _acquire_body();
+				new_body.physics_layer = tile_set_physics_layer;
+				new_body.linear_velocity = linear_velocity;
+				new_body.angular_velocity = angular_velocity;
+
+				RID body = new_body.body;
+				ps->body_set_mode(body, collision_animatable ? Physics2DServer::BODY_MODE_KINEMATIC : Physics2DServer::BODY_MODE_STATIC);
+				ps->body_set_space(body, space);
+				ps->body_set_state(body, Physics2DServer::BODY_STATE_TRANSFORM, body_xform);
+				ps->body_attach_object_instance_id(body, get_instance_id());
+				ps->body_set_collision_layer(body, tile_set->get_physics_layer_collision_layer(tile_set_physics_layer));
+				ps->body_set_collision_mask(body, tile_set->get_physics_layer_collision_mask(tile_set_physics_layer));
+				ps->body_set_pickable(body, false);
+				ps->body_set_state(body, Physics2DServer::BODY_STATE_LINEAR_VELOCITY, linear_velocity);
+				ps->body_set_state(body, Physics2DServer::BODY_STATE_ANGULAR_VELOCITY, angular_velocity);
+
+				Ref<PhysicsMaterial> physics_material = tile_set->get_physics_layer_physics_material(tile_set_physics_layer);
+				if (!physics_material.is_valid()) {
+					ps->body_set_param(body, Physics2DServer::BODY_PARAM_BOUNCE, 0);
+					ps->body_set_param(body, Physics2DServer::BODY_PARAM_FRICTION, 1);
+				} else {
+					ps->body_set_param(body, Physics2DServer::BODY_PARAM_BOUNCE, physics_material->computed_bounce());
+					ps->body_set_param(body, Physics2DServer::BODY_PARAM_FRICTION, physics_material->computed_friction());
+				}
+
+				r_quadrant.quadrant_bodies.push_back(new_body);
+				quadrant_body = &r_quadrant.quadrant_bodies[r_quadrant.quadrant_bodies.size() - 1];
+			}
+
+			// Add the shapes to the body, placed at the cell.
+			LocalVector<Vector2i> &shapes_coords = bodies_shapes_coords[quadrant_body->body];
+			for (int polygon_index = 0; polygon_index < polygons_count; polygon_index++) {
+				bool one_way_collision = tile_data->is_collision_polygon_one_way(tile_set_physics_layer, polygon_index);
+				float one_way_collision_margin = tile_data->get_collision_polygon_one_way_margin(tile_set_physics_layer, polygon_index);
 
-						for (List<RID>::Element *body = q.bodies.front(); body; body = body->next()) {
-							Transform2D xform;
-							xform.set_origin(map_to_world(bodies_coords[body->get()]));
-							xform = new_transform * xform;
+				if (collision_merge_shapes) {
+					Vector<Vector2> polygon = tile_data->get_collision_polygon_points(tile_set_physics_layer, polygon_index);
+					if (polygon.size() < 3) {
+						continue;
+					}
+
+					CollisionMergeGroup *group = nullptr;
+					for (uint32_t i = 0; i < merge_groups.size(); i++) {
+						CollisionMergeGroup &other = merge_groups[i];
+						if (other.body_index == body_index && other.one_way == one_way_collision && other.one_way_margin == one_way_collision_margin) {
+							group = &other;
+							break;
+						}
+					}
+					if (!group) {
+						merge_groups.push_back(CollisionMergeGroup());
+						group = &merge_groups[merge_groups.size() - 1];
+						group->body_index = body_index;
+						group->one_way = one_way_collision;
+						group->one_way_margin = one_way_collision_margin;
+					}
 
-							Physics2DServer::get_singleton()->body_set_state(body->get(), Physics2DServer::BODY_STATE_TRANSFORM, xform);
+					if (merge_full_squares && _is_full_square_polygon(polygon, tile_size)) {
+						group->full_cells.push_back(pk);
+					} else {
+						Vector2 offset = shape_xform.get_origin();
+						for (int i = 0; i < polygon.size(); i++) {
+							polygon.write[i] += offset;
 						}
+						group->polygons.push_back(polygon);
+						group->polygons_coords.push_back(pk);
 					}
+					continue;
 				}
 
-				// ... but then revert changes.
-				set_notify_local_transform(false);
-				set_global_transform(last_valid_transform);
-				set_notify_local_transform(true);
+				int shapes_count = tile_data->get_collision_polygon_shapes_count(tile_set_physics_layer, polygon_index);
+				for (int shape_index = 0; shape_index < shapes_count; shape_index++) {
+					Ref<ConvexPolygonShape2D> shape = tile_data->get_collision_polygon_shape(tile_set_physics_layer, polygon_index, shape_index);
+					ps->body_add_shape(quadrant_body->body, shape->get_rid(), shape_xform);
+					ps->body_set_shape_as_one_way_collision(quadrant_body->body, shapes_coords.size(), one_way_collision, one_way_collision_margin);
+					shapes_coords.push_back(pk);
+				}
 			}
-		} break;
+		}
+	}
+	for (uint32_t i = 0; i < merge_groups.size(); i++) {
+		_physics_add_merged_shapes(r_quadrant, merge_groups[i], quadrant_position);
 	}
 }
 
-void RTileMap::_physics_update_dirty_quadrants(SelfList<RTileMapQuadrant>::List &r_dirty_quadrant_list) {
-	ERR_FAIL_COND(!is_inside_tree());
-	ERR_FAIL_COND(!tile_set.is_valid());
-
-	Transform2D global_transform = get_global_transform();
-	last_valid_transform = global_transform;
-	new_transform = global_transform;
+void RTileMap::_physics_add_merged_shapes(RTileMapQuadrant &r_quadrant, const CollisionMergeGroup &p_group, const Vector2 &p_quadrant_position) {
 	Physics2DServer *ps = Physics2DServer::get_singleton();
-	RID space = get_world_2d()->get_space();
-
-	SelfList<RTileMapQuadrant> *q_list_element = r_dirty_quadrant_list.first();
-	while (q_list_element) {
-		RTileMapQuadrant &q = *q_list_element->self();
+	RID body = r_quadrant.quadrant_bodies[p_group.body_index].body;
+	LocalVector<Vector2i> &shapes_coords = bodies_shapes_coords[body];
 
-		// Clear bodies.
-		for (List<RID>::Element *body = q.bodies.front(); body; body = body->next()) {
-			bodies_coords.erase(body->get());
-			ps->free(body->get());
+	// Greedy rectangles over the fully covered cells: extend each rectangle along the row, then down while whole rows are covered.
+	Set<Vector2i> remaining;
+	for (uint32_t i = 0; i < p_group.full_cells.size(); i++) {
+		remaining.insert(p_group.full_cells[i]);
+	}
+	Vector2 half_tile_size = tile_set->get_tile_size() / 2.0;
+	while (!remaining.empty()) {
+		Vector2i start = remaining.front()->get();
+		Vector2i end = start;
+		while (remaining.has(Vector2i(end.x + 1, start.y))) {
+			end.x++;
 		}
-		q.bodies.clear();
-
-		// Recreate bodies and shapes.
-		for (Set<Vector2i>::Element *E_cell = q.cells.front(); E_cell; E_cell = E_cell->next()) {
-			RTileMapCell c = get_cell(q.layer, E_cell->get(), true);
-
-			RTileSetSource *source;
-			if (tile_set->has_source(c.source_id)) {
-				source = *tile_set->get_source(c.source_id);
-
-				if (!source->has_tile(c.get_atlas_coords()) || !source->has_alternative_tile(c.get_atlas_coords(), c.alternative_tile)) {
-					continue;
+		bool row_covered = true;
+		while (row_covered) {
+			for (int x = start.x; x <= end.x; x++) {
+				if (!remaining.has(Vector2i(x, end.y + 1))) {
+					row_covered = false;
+					break;
 				}
+			}
+			if (row_covered) {
+				end.y++;
+			}
+		}
+		for (int y = start.y; y <= end.y; y++) {
+			for (int x = start.x; x <= end.x; x++) {
+				remaining.erase(Vector2i(x, y));
+			}
+		}
 
-				RTileSetAtlasSource *atlas_source = Object::cast_to<RTileSetAtlasSource>(source);
-				if (atlas_source) {
-					const RTileData *tile_data;
-					if (q.runtime_tile_data_cache.has(E_cell->get())) {
-						tile_data = q.runtime_tile_data_cache[E_cell->get()];
-					} else {
-						tile_data = Object::cast_to<RTileData>(atlas_source->get_tile_data(c.get_atlas_coords(), c.alternative_tile));
-					}
-					for (int tile_set_physics_layer = 0; tile_set_physics_layer < tile_set->get_physics_layers_count(); tile_set_physics_layer++) {
-						Ref<PhysicsMaterial> physics_material = tile_set->get_physics_layer_physics_material(tile_set_physics_layer);
-						uint32_t physics_layer = tile_set->get_physics_layer_collision_layer(tile_set_physics_layer);
-						uint32_t physics_mask = tile_set->get_physics_layer_collision_mask(tile_set_physics_layer);
+		Vector2 rect_start = map_to_world(start) - half_tile_size - p_quadrant_position;
+		Vector2 rect_end = map_to_world(end) + half_tile_size - p_quadrant_position;
+		Ref<RectangleShape2D> rectangle;
+		rectangle.instance();
+		rectangle->set_extents((rect_end - rect_start) / 2.0);
+		r_quadrant.merged_collision_shapes.push_back(rectangle);
 
-						// Create the body.
-						RID body = ps->body_create();
-						bodies_coords[body] = E_cell->get();
-						ps->body_set_mode(body, collision_animatable ? Physics2DServer::BODY_MODE_KINEMATIC : Physics2DServer::BODY_MODE_STATIC);
-						ps->body_set_space(body, space);
+		ps->body_add_shape(body, rectangle->get_rid(), Transform2D(0, (rect_start + rect_end) / 2.0));
+		ps->body_set_shape_as_one_way_collision(body, shapes_coords.size(), p_group.one_way, p_group.one_way_margin);
+		shapes_coords.push_back(start);
+	}
 
-						Transform2D xform;
-						xform.set_origin(map_to_world(E_cell->get()));
-						xform = global_transform * xform;
-						ps->body_set_state(body, Physics2DServer::BODY_STATE_TRANSFORM, xform);
-
-						ps->body_attach_object_instance_id(body, get_instance_id());
-						ps->body_set_collision_layer(body, physics_layer);
-						ps->body_set_collision_mask(body, physics_mask);
-						ps->body_set_pickable(body, false);
-						ps->body_set_state(body, Physics2DServer::BODY_STATE_LINEAR_VELOCITY, tile_data->get_constant_linear_velocity(tile_set_physics_layer));
-						ps->body_set_state(body, Physics2DServer::BODY_STATE_ANGULAR_VELOCITY, tile_data->get_constant_angular_velocity(tile_set_physics_layer));
-
-						if (!physics_material.is_valid()) {
-							ps->body_set_param(body, Physics2DServer::BODY_PARAM_BOUNCE, 0);
-							ps->body_set_param(body, Physics2DServer::BODY_PARAM_FRICTION, 1);
-						} else {
-							ps->body_set_param(body, Physics2DServer::BODY_PARAM_BOUNCE, physics_material->computed_bounce());
-							ps->body_set_param(body, Physics2DServer::BODY_PARAM_FRICTION, physics_material->computed_friction());
-						}
+	// Union the other polygons: each new polygon absorbs the merged ones it overlaps or touches.
+	// Merges leaving a hole give several polygons, and are not done.
+	Vector<Vector<Vector2>> merged;
+	Vector<Vector<int>> merged_sources;
+	for (int polygon_index = 0; polygon_index < p_group.polygons.size(); polygon_index++) {
+		Vector<Vector2> current = p_group.polygons[polygon_index];
+		Vector<int> sources;
+		sources.push_back(polygon_index);
+		for (int i = merged.size() - 1; i >= 0; i--) {
+			Vector<Vector<Vector2>> result = Geometry2D::merge_polygons(merged[i], current);
+			if (result.size() == 1) {
+				current = result[0];
+				sources.append_array(merged_sources[i]);
+				merged.remove(i);
+				merged_sources.remove(i);
+			}
+		}
+		merged.push_back(current);
+		merged_sources.push_back(sources);
+	}
 
-						q.bodies.push_back(body);
-
-						// Add the shapes to the body.
-						int body_shape_index = 0;
-						for (int polygon_index = 0; polygon_index < tile_data->get_collision_polygons_count(tile_set_physics_layer); polygon_index++) {
-							// Iterate over the polygons.
-							bool one_way_collision = tile_data->is_collision_polygon_one_way(tile_set_physics_layer, polygon_index);
-							float one_way_collision_margin = tile_data->get_collision_polygon_one_way_margin(tile_set_physics_layer, polygon_index);
-							int shapes_count = tile_data->get_collision_polygon_shapes_count(tile_set_physics_layer, polygon_index);
-							for (int shape_index = 0; shape_index < shapes_count; shape_index++) {
-								// Add decomposed convex shapes.
-								Ref<ConvexPolygonShape2D> shape = tile_data->get_collision_polygon_shape(tile_set_physics_layer, polygon_index, shape_index);
-								ps->body_add_shape(body, shape->get_rid());
-								ps->body_set_shape_as_one_way_collision(body, body_shape_index, one_way_collision, one_way_collision_margin);
-
-								body_shape_index++;
-							}
-						}
-					}
-				}
+	for (int i = 0; i < merged.size(); i++) {
+		Vector<Vector<Vector2>> pieces = Geometry2D::decompose_polygon_in_convex(merged[i]);
+		if (pieces.empty()) {
+			// Fall back to the original polygons.
+			for (int j = 0; j < merged_sources[i].size(); j++) {
+				pieces.append_array(Geometry2D::decompose_polygon_in_convex(p_group.polygons[merged_sources[i][j]]));
 			}
 		}
 
-		q_list_element = q_list_element->next();
+		// The shapes of a merged polygon report the cell of one of its polygons.
+		Vector2i coords = p_group.polygons_coords[merged_sources[i][0]];
+		for (int j = 0; j < pieces.size(); j++) {
+			Ref<ConvexPolygonShape2D> convex;
+			convex.instance();
+			convex->set_points(pieces[j]);
+			r_quadrant.merged_collision_shapes.push_back(convex);
+
+			ps->body_add_shape(body, convex->get_rid(), Transform2D());
+			ps->body_set_shape_as_one_way_collision(body, shapes_coords.size(), p_group.one_way, p_group.one_way_margin);
+			shapes_coords.push_back(coords);
+		}
 	}
 }
 
-void RTileMap::_physics_cleanup_quadrant(RTileMapQuadrant *p_quadrant) {
-	// Remove a quadrant.
-	for (List<RID>::Element *body = p_quadrant->bodies.front(); body; body = body->next()) {
-		bodies_coords.erase(body->get());
-		Physics2DServer::get_singleton()->free(body->get());
+void RTileMap::_physics_release_quadrant_bodies(RTileMapQuadrant &r_quadrant) {
+	for (uint32_t i = 0; i < r_quadrant.quadrant_bodies.size(); i++) {
+		bodies_shapes_coords.erase(r_quadrant.quadrant_bodies[i].body);
+		_release_body(r_quadrant.quadrant_bodies[i].body);
 	}
-	p_quadrant->bodies.clear();
+	r_quadrant.quadrant_bodies.clear();
+	r_quadrant.merged_collision_shapes.clear();
 }
 
 void RTileMap::_physics_draw_quadrant_debug(RTileMapQuadrant *p_quadrant) {
@@ -1596,7 +3076,6 @@ void RTileMap::_physics_draw_quadrant_debug(RTileMapQuadrant *p_quadrant) {
 	}
 
 	VisualServer *rs = VisualServer::get_singleton();
-	Physics2DServer *ps = Physics2DServer::get_singleton();
 
 	Color debug_collision_color = get_tree()->get_debug_collisions_color();
 	Vector<Color> color;
@@ -1607,23 +3086,40 @@ void RTileMap::_physics_draw_quadrant_debug(RTileMapQuadrant *p_quadrant) {
 	qudrant_xform.set_origin(quadrant_pos);
 	Transform2D global_transform_inv = (get_global_transform() * qudrant_xform).affine_inverse();
 
-	for (List<RID>::Element *body = p_quadrant->bodies.front(); body; body = body->next()) {
-		Transform2D xform = Transform2D(ps->body_get_state(body->get(), Physics2DServer::BODY_STATE_TRANSFORM)) * global_transform_inv;
-		rs->canvas_item_add_set_transform(p_quadrant->debug_canvas_item, xform);
-		for (int shape_index = 0; shape_index < ps->body_get_shape_count(body->get()); shape_index++) {
-			const RID &shape = ps->body_get_shape(body->get(), shape_index);
-			Physics2DServer::ShapeType type = ps->shape_get_type(shape);
-			if (type == Physics2DServer::SHAPE_CONVEX_POLYGON) {
-				Vector<Vector2> polygon = ps->shape_get_data(shape);
-				rs->canvas_item_add_polygon(p_quadrant->debug_canvas_item, polygon, color);
-			} else {
-				WARN_PRINT("Wrong shape type for a tile, should be SHAPE_CONVEX_POLYGON.");
-			}
+	for (Map<Vector2i, Vector<RID>>::Element *E = p_quadrant->bodies.front(); E; E = E->next()) {
+		for (int body_index = 0; body_index < E->value().size(); body_index++) {
+			_physics_draw_body_debug(p_quadrant->debug_canvas_item, E->value()[body_index], global_transform_inv, color);
 		}
-		rs->canvas_item_add_set_transform(p_quadrant->debug_canvas_item, Transform2D());
 	}
+	for (uint32_t body_index = 0; body_index < p_quadrant->quadrant_bodies.size(); body_index++) {
+		_physics_draw_body_debug(p_quadrant->debug_canvas_item, p_quadrant->quadrant_bodies[body_index].body, global_transform_inv, color);
+	}
+	rs->canvas_item_add_set_transform(p_quadrant->debug_canvas_item, Transform2D());
 };
 
+void RTileMap::_physics_draw_body_debug(RID p_canvas_item, RID p_body, const Transform2D &p_global_transform_inv, const Vector<Color> &p_color) {
+	VisualServer *rs = VisualServer::get_singleton();
+	Physics2DServer *ps = Physics2DServer::get_singleton();
+
+	Transform2D body_xform = p_global_transform_inv * Transform2D(ps->body_get_state(p_body, Physics2DServer::BODY_STATE_TRANSFORM));
+	for (int shape_index = 0; shape_index < ps->body_get_shape_count(p_body); shape_index++) {
+		rs->canvas_item_add_set_transform(p_canvas_item, body_xform * ps->body_get_shape_transform(p_body, shape_index));
+
+		// Tiles have convex polygons, merged shapes add rectangles.
+		const RID &shape = ps->body_get_shape(p_body, shape_index);
+		Physics2DServer::ShapeType type = ps->shape_get_type(shape);
+		if (type == Physics2DServer::SHAPE_CONVEX_POLYGON) {
+			Vector<Vector2> polygon = ps->shape_get_data(shape);
+			rs->canvas_item_add_polygon(p_canvas_item, polygon, p_color);
+		} else if (type == Physics2DServer::SHAPE_RECTANGLE) {
+			Vector2 extents = ps->shape_get_data(shape);
+			rs->canvas_item_add_rect(p_canvas_item, Rect2(-extents, extents * 2.0), p_color[0]);
+		} else {
+			WARN_PRINT("Wrong shape type for a tile, should be SHAPE_CONVEX_POLYGON or SHAPE_RECTANGLE.");
+		}
+	}
+}
+
 /////////////////////////////// Navigation //////////////////////////////////////
 
 void RTileMap::_navigation_notification(int p_what) {
@@ -1648,6 +3144,15 @@ void RTileMap::_navigation_notification(int p_what) {
 								Navigation2DServer::get_singleton()->region_set_transform(region, tilemap_xform * tile_transform);
 							}
 						}
+
+						Transform2D quadrant_transform;
+						quadrant_transform.set_origin(map_to_world(q.coords * get_effective_quadrant_size(q.layer)));
+						for (int layer_index = 0; layer_index < q.merged_navigation_regions.size(); layer_index++) {
+							RID region = q.merged_navigation_regions[layer_index];
+							if (region.is_valid()) {
+								Navigation2DServer::get_singleton()->region_set_transform(region, tilemap_xform * quadrant_transform);
+							}
+						}
 					}
 				}
 			}
@@ -1671,82 +3176,207 @@ void RTileMap::_navigation_update_dirty_quadrants(SelfList<RTileMapQuadrant>::Li
 	SelfList<RTileMapQuadrant> *q_list_element = r_dirty_quadrant_list.first();
 	while (q_list_element) {
 		RTileMapQuadrant &q = *q_list_element->self();
+		if (!(q.dirty_aspects & RTileSet::TILE_CHANGE_NAVIGATION)) {
+			q_list_element = q_list_element->next();
+			continue;
+		}
 
-		// Clear navigation shapes in the quadrant.
-		for (Map<Vector2i, Vector<RID>>::Element *E = q.navigation_regions.front(); E; E = E->next()) {
-			for (int i = 0; i < E->value().size(); i++) {
-				RID region = E->value()[i];
-				if (!region.is_valid()) {
-					continue;
+		if (navigation_merge_regions) {
+			_navigation_update_quadrant_merged_regions(q, tilemap_xform);
+			q_list_element = q_list_element->next();
+			continue;
+		}
+
+		// Clear the navigation regions of the modified cells.
+		if (q.full_update) {
+			for (Map<Vector2i, Vector<RID>>::Element *E = q.navigation_regions.front(); E; E = E->next()) {
+				_navigation_free_cell_regions(E->value());
+			}
+			q.navigation_regions.clear();
+		} else {
+			for (Set<Vector2i>::Element *E_cell = q.dirty_cells.front(); E_cell; E_cell = E_cell->next()) {
+				Map<Vector2i, Vector<RID>>::Element *E = q.navigation_regions.find(E_cell->get());
+				if (E) {
+					_navigation_free_cell_regions(E->value());
+					q.navigation_regions.erase(E);
 				}
-				Navigation2DServer::get_singleton()->region_set_map(region, RID());
 			}
 		}
-		q.navigation_regions.clear();
 
-		// Get the navigation polygons and create regions.
-		for (Set<Vector2i>::Element *E_cell = q.cells.front(); E_cell; E_cell = E_cell->next()) {
-			RTileMapCell c = get_cell(q.layer, E_cell->get(), true);
+		// Get the navigation polygons and create regions for the modified cells.
+		for (uint32_t i = 0; i < q.cells_to_update.size(); i++) {
+			uint32_t cell_index = q.cells_to_update[i];
+			const RTileData *tile_data = q.cells_tile_data[cell_index];
+			if (!tile_data) {
+				continue;
+			}
+			const Vector2i &pk = q.cells[cell_index].coords;
+			q.navigation_regions[pk].resize(tile_set->get_navigation_layers_count());
 
-			RTileSetSource *source;
-			if (tile_set->has_source(c.source_id)) {
-				source = *tile_set->get_source(c.source_id);
+			for (int layer_index = 0; layer_index < tile_set->get_navigation_layers_count(); layer_index++) {
+				Ref<NavigationPolygon> navpoly;
+				navpoly = tile_data->get_navigation_polygon(layer_index);
 
-				if (!source->has_tile(c.get_atlas_coords()) || !source->has_alternative_tile(c.get_atlas_coords(), c.alternative_tile)) {
-					continue;
-				}
+				if (navpoly.is_valid()) {
+					Transform2D tile_transform;
+					tile_transform.set_origin(map_to_world(pk));
 
-				RTileSetAtlasSource *atlas_source = Object::cast_to<RTileSetAtlasSource>(source);
-				if (atlas_source) {
-					const RTileData *tile_data;
-					if (q.runtime_tile_data_cache.has(E_cell->get())) {
-						tile_data = q.runtime_tile_data_cache[E_cell->get()];
-					} else {
-						tile_data = Object::cast_to<RTileData>(atlas_source->get_tile_data(c.get_atlas_coords(), c.alternative_tile));
+					RID region = Navigation2DServer::get_singleton()->region_create();
+
+					if (_nav_map == RID()) {
+						_nav_map = Navigation2DServer::get_singleton()->map_create();
 					}
-					q.navigation_regions[E_cell->get()].resize(tile_set->get_navigation_layers_count());
 
-					for (int layer_index = 0; layer_index < tile_set->get_navigation_layers_count(); layer_index++) {
-						Ref<NavigationPolygon> navpoly;
-						navpoly = tile_data->get_navigation_polygon(layer_index);
+					//Navigation2DServer::get_singleton()->region_set_map(region, get_world_2d()->get_navigation_map());
+					Navigation2DServer::get_singleton()->region_set_map(region, _nav_map);
+					Navigation2DServer::get_singleton()->region_set_transform(region, tilemap_xform * tile_transform);
+					Navigation2DServer::get_singleton()->region_set_navpoly(region, navpoly);
+					q.navigation_regions[pk].write[layer_index] = region;
+				}
+			}
+		}
+
+		q_list_element = q_list_element->next();
+	}
+}
+
+void RTileMap::_navigation_free_cell_regions(const Vector<RID> &p_regions) {
+	for (int i = 0; i < p_regions.size(); i++) {
+		RID region = p_regions[i];
+		if (!region.is_valid()) {
+			continue;
+		}
+		Navigation2DServer::get_singleton()->free(region);
+	}
+}
 
-						if (navpoly.is_valid()) {
-							Transform2D tile_transform;
-							tile_transform.set_origin(map_to_world(E_cell->get()));
+void RTileMap::_navigation_update_quadrant_merged_regions(RTileMapQuadrant &r_quadrant, const Transform2D &p_global_transform) {
+	// The navigation polygons of all the cells are merged again, into one polygon per navigation layer.
+	_navigation_free_cell_regions(r_quadrant.merged_navigation_regions);
+	r_quadrant.merged_navigation_regions.clear();
 
-							RID region = Navigation2DServer::get_singleton()->region_create();
+	int navigation_layers_count = tile_set->get_navigation_layers_count();
+	if (navigation_layers_count == 0) {
+		return;
+	}
 
-							if (_nav_map == RID()) {
-								_nav_map = Navigation2DServer::get_singleton()->map_create();
-							}
+	Vector2 quadrant_position = map_to_world(r_quadrant.coords * get_effective_quadrant_size(r_quadrant.layer));
+	Transform2D quadrant_transform;
+	quadrant_transform.set_origin(quadrant_position);
 
-							//Navigation2DServer::get_singleton()->region_set_map(region, get_world_2d()->get_navigation_map());
-							Navigation2DServer::get_singleton()->region_set_map(region, _nav_map);
-							Navigation2DServer::get_singleton()->region_set_transform(region, tilemap_xform * tile_transform);
-							Navigation2DServer::get_singleton()->region_set_navpoly(region, navpoly);
-							q.navigation_regions[E_cell->get()].write[layer_index] = region;
-						}
+	// Vertices closer than this are welded, so that neighboring polygons share their edges.
+	const real_t weld_precision = 0.01;
+
+	r_quadrant.merged_navigation_regions.resize(navigation_layers_count);
+	for (int layer_index = 0; layer_index < navigation_layers_count; layer_index++) {
+		PoolVector2Array vertices;
+		Map<Vector2, int> welded_vertices;
+		Ref<NavigationPolygon> merged_navpoly;
+		merged_navpoly.instance();
+
+		for (uint32_t cell_index = 0; cell_index < r_quadrant.cells.size(); cell_index++) {
+			const RTileData *tile_data = r_quadrant.cells_tile_data[cell_index];
+			if (!tile_data) {
+				continue;
+			}
+			Ref<NavigationPolygon> navpoly = tile_data->get_navigation_polygon(layer_index);
+			if (!navpoly.is_valid()) {
+				continue;
+			}
+
+			Vector2 offset = map_to_world(r_quadrant.cells[cell_index].coords) - quadrant_position;
+			PoolVector2Array navpoly_vertices = navpoly->get_vertices();
+			for (int i = 0; i < navpoly->get_polygon_count(); i++) {
+				Vector<int> polygon = navpoly->get_polygon(i);
+				Vector<int> merged_polygon;
+				for (int j = 0; j < polygon.size(); j++) {
+					ERR_CONTINUE(polygon[j] < 0 || polygon[j] >= navpoly_vertices.size());
+					Vector2 vertex = navpoly_vertices[polygon[j]] + offset;
+					Vector2 key = (vertex / weld_precision).round();
+
+					int vertex_index;
+					Map<Vector2, int>::Element *E = welded_vertices.find(key);
+					if (E) {
+						vertex_index = E->get();
+					} else {
+						vertex_index = vertices.size();
+						vertices.push_back(vertex);
+						welded_vertices.insert(key, vertex_index);
+					}
+
+					// Welding can collapse a polygon's own edges.
+					if (merged_polygon.empty() || (merged_polygon[merged_polygon.size() - 1] != vertex_index && merged_polygon[0] != vertex_index)) {
+						merged_polygon.push_back(vertex_index);
 					}
 				}
+				if (merged_polygon.size() >= 3) {
+					merged_navpoly->add_polygon(merged_polygon);
+				}
 			}
 		}
 
-		q_list_element = q_list_element->next();
+		if (merged_navpoly->get_polygon_count() == 0) {
+			continue;
+		}
+		merged_navpoly->set_vertices(vertices);
+
+		if (_nav_map == RID()) {
+			_nav_map = Navigation2DServer::get_singleton()->map_create();
+		}
+
+		RID region = Navigation2DServer::get_singleton()->region_create();
+		Navigation2DServer::get_singleton()->region_set_map(region, _nav_map);
+		Navigation2DServer::get_singleton()->region_set_transform(region, p_global_transform * quadrant_transform);
+		Navigation2DServer::get_singleton()->region_set_navpoly(region, merged_navpoly);
+		r_quadrant.merged_navigation_regions.write[layer_index] = region;
+	}
+}
+
+RTileMapPathfinding *RTileMap::_pathfinding_get_layer(int p_layer) const {
+	ERR_FAIL_INDEX_V(p_layer, (int)layers.size(), nullptr);
+	ERR_FAIL_COND_V(!tile_set.is_valid(), nullptr);
+
+	MutexLock lock(pathfinding_mutex);
+	Map<int, RTileMapPathfinding *>::Element *E = pathfinding_layers.find(p_layer);
+	if (E) {
+		return E->get();
+	}
+
+	int custom_data_layer = -1;
+	if (!pathfinding_custom_data_layer.empty()) {
+		custom_data_layer = tile_set->get_custom_data_layer_by_name(pathfinding_custom_data_layer);
+		ERR_FAIL_COND_V_MSG(custom_data_layer < 0, nullptr, vformat("No custom data layer named \"%s\" in the TileSet.", pathfinding_custom_data_layer));
+	}
+	RTileMapPathfinding *pathfinding = memnew(RTileMapPathfinding(this, &layers[p_layer].tile_map, custom_data_layer));
+	pathfinding_layers[p_layer] = pathfinding;
+	return pathfinding;
+}
+
+void RTileMap::_pathfinding_make_cell_dirty(int p_layer, const Vector2i &p_coords) {
+	Map<int, RTileMapPathfinding *>::Element *E = pathfinding_layers.find(p_layer);
+	if (E) {
+		E->get()->make_cell_dirty(p_coords);
+	}
+}
+
+void RTileMap::_pathfinding_clear_layer(int p_layer) {
+	// The graph is built again on the next query.
+	Map<int, RTileMapPathfinding *>::Element *E = pathfinding_layers.find(p_layer);
+	if (E) {
+		memdelete(E->get());
+		pathfinding_layers.erase(E);
 	}
 }
 
 void RTileMap::_navigation_cleanup_quadrant(RTileMapQuadrant *p_quadrant) {
 	// Clear navigation shapes in the quadrant.
 	for (Map<Vector2i, Vector<RID>>::Element *E = p_quadrant->navigation_regions.front(); E; E = E->next()) {
-		for (int i = 0; i < E->value().size(); i++) {
-			RID region = E->value()[i];
-			if (!region.is_valid()) {
-				continue;
-			}
-			Navigation2DServer::get_singleton()->free(region);
-		}
+		_navigation_free_cell_regions(E->value());
 	}
 	p_quadrant->navigation_regions.clear();
+
+	_navigation_free_cell_regions(p_quadrant->merged_navigation_regions);
+	p_quadrant->merged_navigation_regions.clear();
 }
 
 void RTileMap::_navigation_draw_quadrant_debug(RTileMapQuadrant *p_quadrant) {
@@ -1780,8 +3410,10 @@ void RTileMap::_navigation_draw_quadrant_debug(RTileMapQuadrant *p_quadrant) {
 
 	Vector2 quadrant_pos = map_to_world(p_quadrant->coords * get_effective_quadrant_size(p_quadrant->layer));
 
-	for (Set<Vector2i>::Element *E_cell = p_quadrant->cells.front(); E_cell; E_cell = E_cell->next()) {
-		RTileMapCell c = get_cell(p_quadrant->layer, E_cell->get(), true);
+	for (uint32_t cell_index = 0; cell_index < p_quadrant->cells.size(); cell_index++) {
+		const Vector2i &pk = p_quadrant->cells[cell_index].coords;
+
+		RTileMapCell c = get_cell(p_quadrant->layer, pk, true);
 
 		RTileSetSource *source;
 		if (tile_set->has_source(c.source_id)) {
@@ -1794,14 +3426,14 @@ void RTileMap::_navigation_draw_quadrant_debug(RTileMapQuadrant *p_quadrant) {
 			RTileSetAtlasSource *atlas_source = Object::cast_to<RTileSetAtlasSource>(source);
 			if (atlas_source) {
 				const RTileData *tile_data;
-				if (p_quadrant->runtime_tile_data_cache.has(E_cell->get())) {
-					tile_data = p_quadrant->runtime_tile_data_cache[E_cell->get()];
+				if (p_quadrant->runtime_tile_data_cache.has(pk)) {
+					tile_data = p_quadrant->runtime_tile_data_cache[pk];
 				} else {
 					tile_data = Object::cast_to<RTileData>(atlas_source->get_tile_data(c.get_atlas_coords(), c.alternative_tile));
 				}
 
 				Transform2D xform;
-				xform.set_origin(map_to_world(E_cell->get()) - quadrant_pos);
+				xform.set_origin(map_to_world(pk) - quadrant_pos);
 				rs->canvas_item_add_set_transform(p_quadrant->debug_canvas_item, xform);
 
 				for (int layer_index = 0; layer_index < tile_set->get_navigation_layers_count(); layer_index++) {
@@ -1843,46 +3475,60 @@ void RTileMap::_scenes_update_dirty_quadrants(SelfList<RTileMapQuadrant>::List &
 	SelfList<RTileMapQuadrant> *q_list_element = r_dirty_quadrant_list.first();
 	while (q_list_element) {
 		RTileMapQuadrant &q = *q_list_element->self();
-
-		// Clear the scenes.
-		for (Map<Vector2i, String>::Element *E = q.scenes.front(); E; E = E->next()) {
-			Node *node = get_node(E->value());
-			if (node) {
-				node->queue_delete();
-			}
+		if (!(q.dirty_aspects & RTileSet::TILE_CHANGE_SCENES)) {
+			q_list_element = q_list_element->next();
+			continue;
 		}
 
-		q.scenes.clear();
+		// Clear the scenes of the modified cells.
+		if (q.full_update) {
+			for (Map<Vector2i, String>::Element *E = q.scenes.front(); E; E = E->next()) {
+				Node *node = get_node(E->value());
+				if (node) {
+					node->queue_delete();
+				}
+			}
 
-		// Recreate the scenes.
-		for (Set<Vector2i>::Element *E_cell = q.cells.front(); E_cell; E_cell = E_cell->next()) {
-			const RTileMapCell &c = get_cell(q.layer, E_cell->get(), true);
+			q.scenes.clear();
+		} else {
+			for (Set<Vector2i>::Element *E_cell = q.dirty_cells.front(); E_cell; E_cell = E_cell->next()) {
+				Map<Vector2i, String>::Element *E = q.scenes.find(E_cell->get());
+				if (E) {
+					Node *node = get_node(E->value());
+					if (node) {
+						node->queue_delete();
+					}
+					q.scenes.erase(E);
+				}
+			}
+		}
 
-			RTileSetSource *source;
-			if (tile_set->has_source(c.source_id)) {
-				source = *tile_set->get_source(c.source_id);
+		// Recreate the scenes of the modified cells.
+		for (uint32_t i = 0; i < q.cells_to_update.size(); i++) {
+			const Vector2i &pk = q.cells[q.cells_to_update[i]].coords;
 
-				if (!source->has_tile(c.get_atlas_coords()) || !source->has_alternative_tile(c.get_atlas_coords(), c.alternative_tile)) {
-					continue;
-				}
+			const RTileMapCell *cell = layers[q.layer].tile_map.get_cell(pk);
+			const RTileSet::TileResolution *resolution = cell ? tile_set->resolve_tile(*cell) : nullptr;
+			if (!resolution) {
+				continue;
+			}
 
-				RTileSetScenesCollectionSource *scenes_collection_source = Object::cast_to<RTileSetScenesCollectionSource>(source);
-				if (scenes_collection_source) {
-					Ref<PackedScene> packed_scene = scenes_collection_source->get_scene_tile_scene(c.alternative_tile);
-					if (packed_scene.is_valid()) {
-						Node *scene = packed_scene->instance();
-						add_child(scene);
-						Control *scene_as_control = Object::cast_to<Control>(scene);
-						Node2D *scene_as_node2d = Object::cast_to<Node2D>(scene);
-						if (scene_as_control) {
-							scene_as_control->set_position(map_to_world(E_cell->get()) + scene_as_control->get_position());
-						} else if (scene_as_node2d) {
-							Transform2D xform;
-							xform.set_origin(map_to_world(E_cell->get()));
-							scene_as_node2d->set_transform(xform * scene_as_node2d->get_transform());
-						}
-						q.scenes[E_cell->get()] = scene->get_name();
+			RTileSetScenesCollectionSource *scenes_collection_source = Object::cast_to<RTileSetScenesCollectionSource>(resolution->source);
+			if (scenes_collection_source) {
+				Ref<PackedScene> packed_scene = scenes_collection_source->get_scene_tile_scene(resolution->cell.alternative_tile);
+				if (packed_scene.is_valid()) {
+					Node *scene = packed_scene->instance();
+					add_child(scene);
+					Control *scene_as_control = Object::cast_to<Control>(scene);
+					Node2D *scene_as_node2d = Object::cast_to<Node2D>(scene);
+					if (scene_as_control) {
+						scene_as_control->set_position(map_to_world(pk) + scene_as_control->get_position());
+					} else if (scene_as_node2d) {
+						Transform2D xform;
+						xform.set_origin(map_to_world(pk));
+						scene_as_node2d->set_transform(xform * scene_as_node2d->get_transform());
 					}
+					q.scenes[pk] = scene->get_name();
 				}
 			}
 		}
@@ -1913,8 +3559,10 @@ void RTileMap::_scenes_draw_quadrant_debug(RTileMapQuadrant *p_quadrant) {
 	// Draw a placeholder for scenes needing one.
 	VisualServer *rs = VisualServer::get_singleton();
 	Vector2 quadrant_pos = map_to_world(p_quadrant->coords * get_effective_quadrant_size(p_quadrant->layer));
-	for (Set<Vector2i>::Element *E_cell = p_quadrant->cells.front(); E_cell; E_cell = E_cell->next()) {
-		const RTileMapCell &c = get_cell(p_quadrant->layer, E_cell->get(), true);
+	for (uint32_t cell_index = 0; cell_index < p_quadrant->cells.size(); cell_index++) {
+		const Vector2i &pk = p_quadrant->cells[cell_index].coords;
+
+		const RTileMapCell &c = get_cell(p_quadrant->layer, pk, true);
 
 		RTileSetSource *source;
 		if (tile_set->has_source(c.source_id)) {
@@ -1942,7 +3590,7 @@ void RTileMap::_scenes_draw_quadrant_debug(RTileMapQuadrant *p_quadrant) {
 
 					// Draw a placeholder tile.
 					Transform2D xform;
-					xform.set_origin(map_to_world(E_cell->get()) - quadrant_pos);
+					xform.set_origin(map_to_world(pk) - quadrant_pos);
 					rs->canvas_item_add_set_transform(p_quadrant->debug_canvas_item, xform);
 					rs->canvas_item_add_circle(p_quadrant->debug_canvas_item, Vector2(), MIN(tile_set->get_tile_size().x, tile_set->get_tile_size().y) / 4.0, color);
 				}
@@ -1955,9 +3603,9 @@ void RTileMap::set_cell(int p_layer, const Vector2 &p_coords, int p_source_id, c
 	ERR_FAIL_INDEX(p_layer, (int)layers.size());
 
 	// Set the current cell tile (using integer position).
-	Map<Vector2i, RTileMapCell> &tile_map = layers[p_layer].tile_map;
+	RTileMapCellStorage &tile_map = layers[p_layer].tile_map;
 	Vector2i pk(p_coords);
-	Map<Vector2i, RTileMapCell>::Element *E = tile_map.find(pk);
+	const RTileMapCell *E = tile_map.get_cell(pk);
 
 	int source_id = p_source_id;
 	Vector2i atlas_coords = p_atlas_coords;
@@ -1975,6 +3623,35 @@ void RTileMap::set_cell(int p_layer, const Vector2 &p_coords, int p_source_id, c
 		return; // Nothing to do, the tile is already empty.
 	}
 
+	if (E && E->source_id == source_id && Vector2i(E->get_atlas_coords()) == atlas_coords && E->alternative_tile == alternative_tile) {
+		return; // Nothing changed.
+	}
+
+	_pathfinding_make_cell_dirty(p_layer, pk);
+	if (streamer && !streaming_updating_cells) {
+		_streaming_make_cell_dirty(p_layer, pk);
+	}
+	if (layers[p_layer].tiles_quadrants_valid) {
+		if (E) {
+			_tiles_quadrants_add(p_layer, *E, pk, -1);
+		}
+		if (source_id != RTileSet::INVALID_SOURCE) {
+			_tiles_quadrants_add(p_layer, RTileMapCell(source_id, atlas_coords, alternative_tile), pk, 1);
+		}
+	}
+
+	if (batch_depth > 0) {
+		// Only update the storage, quadrants are updated once the batch ends.
+		if (source_id == RTileSet::INVALID_SOURCE) {
+			tile_map.erase_cell(pk);
+		} else {
+			tile_map.insert_cell(pk, RTileMapCell(source_id, atlas_coords, alternative_tile));
+		}
+		_batch_cell_change(p_layer, pk);
+		used_rect_cache_dirty = true;
+		return;
+	}
+
 	// Get the quadrant
 	Vector2i qk = _coords_to_quadrant_coords(p_layer, pk);
 
@@ -1982,50 +3659,150 @@ void RTileMap::set_cell(int p_layer, const Vector2 &p_coords, int p_source_id, c
 
 	if (source_id == RTileSet::INVALID_SOURCE) {
 		// Erase existing cell in the tile map.
-		tile_map.erase(pk);
+		tile_map.erase_cell(pk);
 
 		// Erase existing cell in the quadrant.
 		ERR_FAIL_COND(!Q);
 		RTileMapQuadrant &q = Q->get();
 
-		q.cells.erase(pk);
+		q.erase_cell(pk, _get_cell_world_position(pk));
 
 		// Remove or make the quadrant dirty.
 		if (q.cells.size() == 0) {
 			_erase_quadrant(Q);
 		} else {
-			_make_quadrant_dirty(Q);
+			_make_quadrant_cell_dirty(Q, pk);
 		}
 
 		used_rect_cache_dirty = true;
 	} else {
 		if (!E) {
-			// Insert a new cell in the tile map.
-			E = tile_map.insert(pk, RTileMapCell());
-
 			// Create a new quadrant if needed, then insert the cell if needed.
 			if (!Q) {
 				Q = _create_quadrant(p_layer, qk);
 			}
 			RTileMapQuadrant &q = Q->get();
-			q.cells.insert(pk);
+			q.insert_cell(pk, _get_cell_world_position(pk));
 
 		} else {
 			ERR_FAIL_COND(!Q); // RTileMapQuadrant should exist...
+		}
+
+		// Insert or replace the cell in the tile map.
+		tile_map.insert_cell(pk, RTileMapCell(source_id, atlas_coords, alternative_tile));
 
-			if (E->get().source_id == source_id && E->get().get_atlas_coords() == atlas_coords && E->get().alternative_tile == alternative_tile) {
-				return; // Nothing changed.
+		_make_quadrant_cell_dirty(Q, pk);
+		used_rect_cache_dirty = true;
+	}
+}
+
+void RTileMap::set_cells(int p_layer, const PoolVector2Array &p_coords_array, const PoolIntArray &p_packed_cells) {
+	ERR_FAIL_INDEX(p_layer, (int)layers.size());
+	ERR_FAIL_COND_MSG(p_packed_cells.size() != p_coords_array.size() * 2, "The packed cells array must contain two integers per coordinates.");
+
+	PoolVector2Array::Read coords_read = p_coords_array.read();
+	PoolIntArray::Read cells_read = p_packed_cells.read();
+
+	begin_batch();
+	for (int i = 0; i < p_coords_array.size(); i++) {
+		// Each cell is packed as [source_id | atlas_coords.x << 16, atlas_coords.y | alternative_tile << 16].
+		uint32_t low = cells_read[i * 2];
+		uint32_t high = cells_read[i * 2 + 1];
+		int source_id = int16_t(low & 0xFFFF);
+		Vector2i atlas_coords = Vector2i(int16_t(low >> 16), int16_t(high & 0xFFFF));
+		int alternative_tile = int16_t(high >> 16);
+		set_cell(p_layer, coords_read[i], source_id, atlas_coords, alternative_tile);
+	}
+	end_batch();
+}
+
+void RTileMap::begin_batch() {
+	batch_depth++;
+}
+
+void RTileMap::end_batch() {
+	ERR_FAIL_COND_MSG(batch_depth <= 0, "end_batch() called without a matching begin_batch().");
+	batch_depth--;
+	if (batch_depth == 0) {
+		_flush_batched_cells();
+	}
+}
+
+bool RTileMap::is_batching() const {
+	return batch_depth > 0;
+}
+
+void RTileMap::_batch_cell_change(int p_layer, const Vector2i &p_coords) {
+	TileMapLayer &layer = layers[p_layer];
+	Vector2i qk = _coords_to_quadrant_coords(p_layer, p_coords);
+
+	// Group the changed cells per quadrant.
+	uint32_t *index = layer.batched_quadrants_indices.getptr(qk);
+	if (!index) {
+		layer.batched_quadrants_indices.set(qk, layer.batched_quadrants.size());
+		layer.batched_quadrants.push_back(BatchedQuadrantCells());
+		layer.batched_quadrants[layer.batched_quadrants.size() - 1].quadrant_coords = qk;
+		index = layer.batched_quadrants_indices.getptr(qk);
+	}
+	layer.batched_quadrants[*index].cells.push_back(p_coords);
+}
+
+void RTileMap::_flush_batched_cells() {
+	bool changed = false;
+	for (unsigned int layer = 0; layer < layers.size(); layer++) {
+		TileMapLayer &tile_map_layer = layers[layer];
+
+		for (uint32_t i = 0; i < tile_map_layer.batched_quadrants.size(); i++) {
+			const BatchedQuadrantCells &batched_quadrant = tile_map_layer.batched_quadrants[i];
+
+			// Create the quadrant only once, if any cell remains in it.
+			Map<Vector2i, RTileMapQuadrant>::Element *Q = tile_map_layer.quadrant_map.find(batched_quadrant.quadrant_coords);
+			if (!Q) {
+				bool has_cells = false;
+				for (uint32_t j = 0; j < batched_quadrant.cells.size(); j++) {
+					if (tile_map_layer.tile_map.has_cell(batched_quadrant.cells[j])) {
+						has_cells = true;
+						break;
+					}
+				}
+				if (!has_cells) {
+					continue;
+				}
+				Q = _create_quadrant(layer, batched_quadrant.quadrant_coords);
+			}
+			RTileMapQuadrant &q = Q->get();
+
+			// The storage holds the final state of each cell, so cells changed several times are handled correctly.
+			for (uint32_t j = 0; j < batched_quadrant.cells.size(); j++) {
+				const Vector2i &pk = batched_quadrant.cells[j];
+				if (tile_map_layer.tile_map.has_cell(pk)) {
+					q.insert_cell(pk, _get_cell_world_position(pk));
+				} else {
+					q.erase_cell(pk, _get_cell_world_position(pk));
+				}
+				if (!q.full_update) {
+					q.dirty_cells.insert(pk);
+				}
 			}
-		}
 
-		RTileMapCell &c = E->get();
+			// Remove or make the quadrant dirty, once. Edited cells need every subsystem updated.
+			if (q.cells.size() == 0) {
+				_erase_quadrant(Q);
+			} else {
+				q.dirty_aspects |= RTileSet::TILE_CHANGE_ALL;
+				if (!q.dirty_list_element.in_list()) {
+					tile_map_layer.dirty_quadrant_list.add(&q.dirty_list_element);
+				}
+			}
+			changed = true;
+		}
 
-		c.source_id = source_id;
-		c.set_atlas_coords(atlas_coords);
-		c.alternative_tile = alternative_tile;
+		tile_map_layer.batched_quadrants.clear();
+		tile_map_layer.batched_quadrants_indices.clear();
+	}
 
-		_make_quadrant_dirty(Q);
-		used_rect_cache_dirty = true;
+	if (changed) {
+		_queue_update_dirty_quadrants();
 	}
 }
 
@@ -2033,57 +3810,51 @@ int RTileMap::get_cell_source_id(int p_layer, const Vector2 &p_coords, bool p_us
 	ERR_FAIL_INDEX_V(p_layer, (int)layers.size(), RTileSet::INVALID_SOURCE);
 
 	// Get a cell source id from position
-	const Map<Vector2i, RTileMapCell> &tile_map = layers[p_layer].tile_map;
-	const Map<Vector2i, RTileMapCell>::Element *E = tile_map.find(p_coords);
+	const RTileMapCell *E = layers[p_layer].tile_map.get_cell(Vector2i(p_coords));
 
 	if (!E) {
 		return RTileSet::INVALID_SOURCE;
 	}
 
 	if (p_use_proxies && tile_set.is_valid()) {
-		Array proxyed = tile_set->map_tile_proxy(E->get().source_id, E->get().get_atlas_coords(), E->get().alternative_tile);
-		return proxyed[0];
+		return tile_set->map_tile_proxy_fast(*E).source_id;
 	}
 
-	return E->get().source_id;
+	return E->source_id;
 }
 
 Vector2 RTileMap::get_cell_atlas_coords(int p_layer, const Vector2 &p_coords, bool p_use_proxies) const {
 	ERR_FAIL_INDEX_V(p_layer, (int)layers.size(), RTileSetSource::INVALID_ATLAS_COORDS);
 
 	// Get a cell source id from position
-	const Map<Vector2i, RTileMapCell> &tile_map = layers[p_layer].tile_map;
-	const Map<Vector2i, RTileMapCell>::Element *E = tile_map.find(p_coords);
+	const RTileMapCell *E = layers[p_layer].tile_map.get_cell(Vector2i(p_coords));
 
 	if (!E) {
 		return RTileSetSource::INVALID_ATLAS_COORDS;
 	}
 
 	if (p_use_proxies && tile_set.is_valid()) {
-		Array proxyed = tile_set->map_tile_proxy(E->get().source_id, E->get().get_atlas_coords(), E->get().alternative_tile);
-		return proxyed[1];
+		return tile_set->map_tile_proxy_fast(*E).get_atlas_coords();
 	}
 
-	return E->get().get_atlas_coords();
+	return E->get_atlas_coords();
 }
 
 int RTileMap::get_cell_alternative_tile(int p_layer, const Vector2 &p_coords, bool p_use_proxies) const {
 	ERR_FAIL_INDEX_V(p_layer, (int)layers.size(), RTileSetSource::INVALID_TILE_ALTERNATIVE);
 
 	// Get a cell source id from position
-	const Map<Vector2i, RTileMapCell> &tile_map = layers[p_layer].tile_map;
-	const Map<Vector2i, RTileMapCell>::Element *E = tile_map.find(p_coords);
+	const RTileMapCell *E = layers[p_layer].tile_map.get_cell(Vector2i(p_coords));
 
 	if (!E) {
 		return RTileSetSource::INVALID_TILE_ALTERNATIVE;
 	}
 
 	if (p_use_proxies && tile_set.is_valid()) {
-		Array proxyed = tile_set->map_tile_proxy(E->get().source_id, E->get().get_atlas_coords(), E->get().alternative_tile);
-		return proxyed[2];
+		return tile_set->map_tile_proxy_fast(*E).alternative_tile;
 	}
 
-	return E->get().alternative_tile;
+	return E->alternative_tile;
 }
 
 Ref<RTileMapPattern> RTileMap::get_pattern(int p_layer, Vector<Vector2> p_coords_array) {
@@ -2164,48 +3935,19 @@ Vector2 RTileMap::map_pattern(Vector2 p_position_in_tilemapv, Vector2 p_coords_i
 	}
 
 	return output;
-}
-
-void RTileMap::set_pattern(int p_layer, Vector2 p_position, const Ref<RTileMapPattern> p_pattern) {
-	ERR_FAIL_INDEX(p_layer, (int)layers.size());
-	ERR_FAIL_COND(!tile_set.is_valid());
-
-	PoolVector2Array used_cells = p_pattern->get_used_cells();
-	for (int i = 0; i < used_cells.size(); i++) {
-		Vector2i coords = map_pattern(p_position, used_cells[i], p_pattern);
-		set_cell(p_layer, coords, p_pattern->get_cell_source_id(coords), p_pattern->get_cell_atlas_coords(coords), p_pattern->get_cell_alternative_tile(coords));
-	}
-}
-
-Set<RTileSet::TerrainsPattern> RTileMap::_get_valid_terrains_patterns_for_constraints(int p_terrain_set, const Vector2i &p_position, Set<TerrainConstraint> p_constraints) {
-	if (!tile_set.is_valid()) {
-		return Set<RTileSet::TerrainsPattern>();
-	}
-
-	// Returns all tiles compatible with the given constraints.
-	Set<RTileSet::TerrainsPattern> compatible_terrain_tile_patterns;
-	for (Set<RTileSet::TerrainsPattern>::Element *E = tile_set->get_terrains_pattern_set(p_terrain_set).front(); E; E = E->next()) {
-		const RTileSet::TerrainsPattern &terrain_pattern = E->get();
-		int valid = true;
-		for (int i = 0; i < RTileSet::CELL_NEIGHBOR_MAX; i++) {
-			RTileSet::CellNeighbor bit = RTileSet::CellNeighbor(i);
-			if (tile_set->is_valid_peering_bit_terrain(p_terrain_set, bit)) {
-				// Check if the bit is compatible with the constraints.
-				TerrainConstraint terrain_bit_constraint = TerrainConstraint(this, p_position, bit, terrain_pattern.get_terrain(bit));
-				Set<TerrainConstraint>::Element *in_set_constraint_element = p_constraints.find(terrain_bit_constraint);
-				if (in_set_constraint_element && in_set_constraint_element->get().get_terrain() != terrain_bit_constraint.get_terrain()) {
-					valid = false;
-					break;
-				}
-			}
-		}
+}
 
-		if (valid) {
-			compatible_terrain_tile_patterns.insert(terrain_pattern);
-		}
-	}
+void RTileMap::set_pattern(int p_layer, Vector2 p_position, const Ref<RTileMapPattern> p_pattern) {
+	ERR_FAIL_INDEX(p_layer, (int)layers.size());
+	ERR_FAIL_COND(!tile_set.is_valid());
 
-	return compatible_terrain_tile_patterns;
+	PoolVector2Array used_cells = p_pattern->get_used_cells();
+	begin_batch();
+	for (int i = 0; i < used_cells.size(); i++) {
+		Vector2i coords = map_pattern(p_position, used_cells[i], p_pattern);
+		set_cell(p_layer, coords, p_pattern->get_cell_source_id(coords), p_pattern->get_cell_atlas_coords(coords), p_pattern->get_cell_alternative_tile(coords));
+	}
+	end_batch();
 }
 
 Set<RTileMap::TerrainConstraint> RTileMap::get_terrain_constraints_from_removed_cells_list(int p_layer, const Set<Vector2i> &p_to_replace, int p_terrain_set, bool p_ignore_empty_terrains) const {
@@ -2300,109 +4042,327 @@ Set<RTileMap::TerrainConstraint> RTileMap::get_terrain_constraints_from_added_ti
 	return output;
 }
 
-Map<Vector2i, RTileSet::TerrainsPattern> RTileMap::terrain_wave_function_collapse(const Set<Vector2i> &p_to_replace, int p_terrain_set, const Set<TerrainConstraint> p_constraints) {
-	if (!tile_set.is_valid()) {
-		return Map<Vector2i, RTileSet::TerrainsPattern>();
+// Terrains solver over the cells to replace.
+// The possible patterns of each cell are a bitset over the patterns of the terrain set. Neighboring cells share terrain
+// points, each point holding one terrain: when the patterns of a cell change, the terrains still possible on its points
+// restrict the patterns of the cells sharing them, until nothing changes. Cells are then decided from the most constrained one.
+class RTileMapTerrainSolver {
+	struct Point {
+		bool constrained = false;
+		int terrain_index = 0; // The terrain + 1, when constrained.
+		int cells_count = 0;
+		int cells[4]; // The cells sharing the point, and the index of the peering bit in each of them.
+		int bits[4];
+	};
+
+	struct OpenCell {
+		int patterns_count = 0;
+		uint32_t tie_breaker = 0;
+		int cell = 0;
+
+		bool operator<(const OpenCell &p_other) const {
+			if (patterns_count == p_other.patterns_count) {
+				return tie_breaker < p_other.tie_breaker;
+			}
+			return patterns_count < p_other.patterns_count;
+		}
+	};
+
+	bool valid = false;
+	int words_count = 0;
+	int bits_count = 0;
+	int terrains_count = 0; // Including the empty terrain.
+
+	Ref<RTileSet> tile_set;
+	const RTileSet::TerrainsPatternsTable *table = nullptr; // The indexed patterns, cached by the tile set.
+	RandomPCG *rng = nullptr; // The global random generator if null.
+
+	LocalVector<Vector2i> cells;
+	LocalVector<uint64_t> domains; // The possible patterns, per cell.
+	LocalVector<int> cells_points; // The point of each peering bit, per cell.
+	LocalVector<Point> points;
+
+	LocalVector<int> queue;
+	LocalVector<uint8_t> queued;
+	LocalVector<uint8_t> decided;
+	LocalVector<OpenCell> open;
+
+	static _FORCE_INLINE_ int _count_bits(uint64_t p_value) {
+		p_value = p_value - ((p_value >> 1) & 0x5555555555555555ULL);
+		p_value = (p_value & 0x3333333333333333ULL) + ((p_value >> 2) & 0x3333333333333333ULL);
+		p_value = (p_value + (p_value >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+		return (p_value * 0x0101010101010101ULL) >> 56;
 	}
 
-	// Copy the constraints set.
-	Set<TerrainConstraint> constraints = p_constraints;
-
-	// Compute all acceptable patterns for each cell.
-	Map<Vector2i, Set<RTileSet::TerrainsPattern>> per_cell_acceptable_tiles;
+	_FORCE_INLINE_ uint64_t *_get_domain(int p_cell) { return &domains[p_cell * words_count]; }
+	_FORCE_INLINE_ const uint64_t *_get_mask(int p_bit, int p_terrain_index) const { return table->get_mask(table->bits[p_bit], p_terrain_index - 1); }
 
-	for (Set<Vector2i>::Element *cell = p_to_replace.front(); cell; cell = cell->next()) {
-		per_cell_acceptable_tiles[cell->get()] = _get_valid_terrains_patterns_for_constraints(p_terrain_set, cell->get(), constraints);
+	int _get_patterns_count(int p_cell) {
+		const uint64_t *domain = _get_domain(p_cell);
+		int count = 0;
+		for (int i = 0; i < words_count; i++) {
+			count += _count_bits(domain[i]);
+		}
+		return count;
 	}
 
-	// Output map.
-	Map<Vector2i, RTileSet::TerrainsPattern> output;
+	void _push_open_cell(int p_cell) {
+		OpenCell open_cell;
+		open_cell.patterns_count = _get_patterns_count(p_cell);
+		open_cell.tie_breaker = rng ? rng->rand() : Math::rand();
+		open_cell.cell = p_cell;
+
+		// Binary min-heap.
+		uint32_t index = open.size();
+		open.push_back(open_cell);
+		while (index > 0 && open[index] < open[(index - 1) / 2]) {
+			SWAP(open[index], open[(index - 1) / 2]);
+			index = (index - 1) / 2;
+		}
+	}
 
-	// Add all positions to a set.
-	Set<Vector2i> to_replace = Set<Vector2i>(p_to_replace);
-	while (!to_replace.empty()) {
-		// Compute the minimum number of tile possibilities for each cell.
-		int min_nb_possibilities = 100000000;
+	OpenCell _pop_open_cell() {
+		OpenCell top = open[0];
+		open[0] = open[open.size() - 1];
+		open.resize(open.size() - 1);
+		uint32_t index = 0;
+		while (true) {
+			uint32_t smallest = index;
+			for (uint32_t child = index * 2 + 1; child <= index * 2 + 2 && child < open.size(); child++) {
+				if (open[child] < open[smallest]) {
+					smallest = child;
+				}
+			}
+			if (smallest == index) {
+				break;
+			}
+			SWAP(open[index], open[smallest]);
+			index = smallest;
+		}
+		return top;
+	}
 
-		for (Map<Vector2i, Set<RTileSet::TerrainsPattern>>::Element *E = per_cell_acceptable_tiles.front(); E; E = E->next()) {
-			min_nb_possibilities = MIN(min_nb_possibilities, E->value().size());
+	void _queue_cell(int p_cell) {
+		if (!queued[p_cell]) {
+			queued[p_cell] = true;
+			queue.push_back(p_cell);
 		}
+	}
+
+	void _propagate() {
+		LocalVector<uint64_t> allowed;
+		allowed.resize(words_count);
+		while (!queue.empty()) {
+			int cell = queue[queue.size() - 1];
+			queue.resize(queue.size() - 1);
+			queued[cell] = false;
+
+			const uint64_t *domain = _get_domain(cell);
+			bool empty = true;
+			for (int i = 0; i < words_count && empty; i++) {
+				empty = domain[i] == 0;
+			}
+			if (empty) {
+				continue; // Cannot be solved, and does not restrict its neighbors.
+			}
+
+			for (int bit = 0; bit < bits_count; bit++) {
+				int point_index = cells_points[cell * bits_count + bit];
+				if (point_index < 0) {
+					continue;
+				}
+				const Point &point = points[point_index];
+
+				// The terrains still possible on the point.
+				uint64_t point_terrains = 0;
+				for (int terrain_index = 0; terrain_index < terrains_count; terrain_index++) {
+					const uint64_t *mask = _get_mask(bit, terrain_index);
+					for (int i = 0; i < words_count; i++) {
+						if (domain[i] & mask[i]) {
+							point_terrains |= uint64_t(1) << terrain_index;
+							break;
+						}
+					}
+				}
+
+				for (int j = 0; j < point.cells_count; j++) {
+					int other_cell = point.cells[j];
+					if (other_cell == cell || decided[other_cell]) {
+						continue;
+					}
+					for (int i = 0; i < words_count; i++) {
+						allowed[i] = 0;
+					}
+					for (int terrain_index = 0; terrain_index < terrains_count; terrain_index++) {
+						if (point_terrains & (uint64_t(1) << terrain_index)) {
+							const uint64_t *mask = _get_mask(point.bits[j], terrain_index);
+							for (int i = 0; i < words_count; i++) {
+								allowed[i] |= mask[i];
+							}
+						}
+					}
 
-		// Get the set of possible cells to fill, out of the most constrained ones.
-		LocalVector<Vector2i> to_choose_from;
-		for (Map<Vector2i, Set<RTileSet::TerrainsPattern>>::Element *E = per_cell_acceptable_tiles.front(); E; E = E->next()) {
-			if (E->value().size() == min_nb_possibilities) {
-				to_choose_from.push_back(E->key());
+					uint64_t *other_domain = _get_domain(other_cell);
+					bool changed = false;
+					bool other_empty = true;
+					for (int i = 0; i < words_count; i++) {
+						uint64_t restricted = other_domain[i] & allowed[i];
+						changed = changed || restricted != other_domain[i];
+						other_empty = other_empty && restricted == 0;
+						other_domain[i] = restricted;
+					}
+					if (changed) {
+						if (!other_empty) {
+							_queue_cell(other_cell);
+						}
+						_push_open_cell(other_cell);
+					}
+				}
 			}
 		}
+	}
 
-		// Randomly a cell to fill out of the most constrained.
-		Vector2i selected_cell_to_replace = to_choose_from[Math::random(0, to_choose_from.size() - 1)];
+public:
+	Map<Vector2i, RTileSet::TerrainsPattern> solve() {
+		Map<Vector2i, RTileSet::TerrainsPattern> output;
+		if (!valid) {
+			return output;
+		}
 
-		// Get the list of acceptable pattens for the given cell.
-		Set<RTileSet::TerrainsPattern> valid_tiles = per_cell_acceptable_tiles[selected_cell_to_replace];
-		if (valid_tiles.empty()) {
-			break; // No possibilities :/
+		// The initial constraints reach as far as they can before any choice.
+		for (uint32_t i = 0; i < cells.size(); i++) {
+			_queue_cell(i);
+		}
+		_propagate();
+		for (uint32_t i = 0; i < cells.size(); i++) {
+			_push_open_cell(i);
 		}
 
-		// Out of the possible patterns, prioritize the one which have the least amount of different terrains.
-		LocalVector<RTileSet::TerrainsPattern> valid_tiles_with_least_amount_of_terrains;
-		int min_terrain_count = 10000;
-		LocalVector<int> terrains_counts;
-		int pattern_index = 0;
-		for (Set<RTileSet::TerrainsPattern>::Element *E = valid_tiles.front(); E; E = E->next()) {
-			const RTileSet::TerrainsPattern &pattern = E->get();
+		LocalVector<int> candidates;
+		while (!open.empty()) {
+			OpenCell open_cell = _pop_open_cell();
+			int cell = open_cell.cell;
+			if (decided[cell] || open_cell.patterns_count != _get_patterns_count(cell)) {
+				continue; // Outdated entry.
+			}
+			if (open_cell.patterns_count == 0) {
+				continue; // No possibilities, the cell is left as is.
+			}
 
-			Set<int> terrains;
-			for (int i = 0; i < RTileSet::CELL_NEIGHBOR_MAX; i++) {
-				RTileSet::CellNeighbor side = RTileSet::CellNeighbor(i);
-				if (tile_set->is_valid_peering_bit_terrain(p_terrain_set, side)) {
-					terrains.insert(pattern.get_terrain(side));
+			// Out of the possible patterns, prioritize the ones which have the least amount of different terrains.
+			uint64_t *domain = _get_domain(cell);
+			int min_terrains_count = RTileSet::CELL_NEIGHBOR_MAX + 1;
+			candidates.clear();
+			for (uint32_t pattern_index = 0; pattern_index < table->patterns.size(); pattern_index++) {
+				if (!(domain[pattern_index / 64] & (uint64_t(1) << (pattern_index % 64)))) {
+					continue;
+				}
+				if (table->patterns_terrains_counts[pattern_index] < min_terrains_count) {
+					min_terrains_count = table->patterns_terrains_counts[pattern_index];
+					candidates.clear();
+				}
+				if (table->patterns_terrains_counts[pattern_index] == min_terrains_count) {
+					candidates.push_back(pattern_index);
 				}
 			}
-			min_terrain_count = MIN(min_terrain_count, terrains.size());
-			terrains_counts.push_back(terrains.size());
-			pattern_index++;
-		}
-		pattern_index = 0;
-		for (Set<RTileSet::TerrainsPattern>::Element *E = valid_tiles.front(); E; E = E->next()) {
-			const RTileSet::TerrainsPattern &pattern = E->get();
 
-			if (terrains_counts[pattern_index] == min_terrain_count) {
-				valid_tiles_with_least_amount_of_terrains.push_back(pattern);
+			// Randomly select a pattern out of the remaining ones.
+			int selected = candidates[(rng ? rng->rand() : Math::rand()) % candidates.size()];
+			for (int i = 0; i < words_count; i++) {
+				domain[i] = 0;
 			}
-			pattern_index++;
+			domain[selected / 64] = uint64_t(1) << (selected % 64);
+			decided[cell] = true;
+			output[cells[cell]] = table->patterns[selected];
+
+			_queue_cell(cell);
+			_propagate();
 		}
 
-		// Randomly select a pattern out of the remaining ones.
-		RTileSet::TerrainsPattern selected_terrain_tile_pattern = valid_tiles_with_least_amount_of_terrains[Math::random(0, valid_tiles_with_least_amount_of_terrains.size() - 1)];
+		return output;
+	}
+
+	RTileMapTerrainSolver(const RTileMap *p_tile_map, const Set<Vector2i> &p_to_replace, int p_terrain_set, const Set<RTileMap::TerrainConstraint> &p_constraints, RandomPCG *p_rng) {
+		rng = p_rng;
+		tile_set = p_tile_map->get_tileset();
+		table = tile_set->get_terrains_patterns_table(p_terrain_set);
+		ERR_FAIL_COND(!table);
+		words_count = table->words_count;
+		bits_count = table->bits.size();
+		terrains_count = table->terrains_count;
+		ERR_FAIL_COND_MSG(terrains_count > 64, "Terrain sets with more than 63 terrains cannot be solved.");
+		const LocalVector<RTileSet::CellNeighbor> &bits = table->bits;
+
+		// Index the cells, and the terrain points they share.
+		HashMap<Vector2i, int, RTileMapCoordsHasher> points_indices[RTileSet::CELL_NEIGHBOR_MAX];
+		cells_points.resize(p_to_replace.size() * bits_count);
+		for (const Set<Vector2i>::Element *E = p_to_replace.front(); E; E = E->next()) {
+			int cell = cells.size();
+			cells.push_back(E->get());
+			for (int bit = 0; bit < bits_count; bit++) {
+				RTileMap::TerrainConstraint constraint = RTileMap::TerrainConstraint(p_tile_map, E->get(), bits[bit], -1);
+				ERR_FAIL_INDEX(constraint.get_bit(), RTileSet::CELL_NEIGHBOR_MAX);
+				int *point_index = points_indices[constraint.get_bit()].getptr(constraint.get_base_cell_coords());
+				if (!point_index) {
+					points_indices[constraint.get_bit()].set(constraint.get_base_cell_coords(), points.size());
+					points.push_back(Point());
+					point_index = points_indices[constraint.get_bit()].getptr(constraint.get_base_cell_coords());
+				}
+				cells_points[cell * bits_count + bit] = *point_index;
 
-		// Set the selected cell into the output.
-		output[selected_cell_to_replace] = selected_terrain_tile_pattern;
-		to_replace.erase(selected_cell_to_replace);
-		per_cell_acceptable_tiles.erase(selected_cell_to_replace);
+				Point &point = points[*point_index];
+				ERR_CONTINUE(point.cells_count >= 4);
+				point.cells[point.cells_count] = cell;
+				point.bits[point.cells_count] = bit;
+				point.cells_count++;
+			}
+		}
 
-		// Add the new constraints from the added tiles.
-		Set<TerrainConstraint> new_constraints = get_terrain_constraints_from_added_tile(selected_cell_to_replace, p_terrain_set, selected_terrain_tile_pattern);
-		for (Set<TerrainConstraint>::Element *E_constraint = new_constraints.front(); E_constraint; E_constraint = E_constraint->next()) {
-			constraints.insert(E_constraint->get());
+		for (const Set<RTileMap::TerrainConstraint>::Element *E = p_constraints.front(); E; E = E->next()) {
+			if (E->get().get_bit() < 0 || E->get().get_bit() >= RTileSet::CELL_NEIGHBOR_MAX) {
+				continue;
+			}
+			const int *point_index = points_indices[E->get().get_bit()].getptr(E->get().get_base_cell_coords());
+			if (point_index) {
+				points[*point_index].constrained = true;
+				points[*point_index].terrain_index = E->get().get_terrain() + 1;
+			}
 		}
 
-		// Compute valid tiles again for neighbors.
-		for (uint32_t i = 0; i < RTileSet::CELL_NEIGHBOR_MAX; i++) {
-			RTileSet::CellNeighbor side = RTileSet::CellNeighbor(i);
-			if (is_existing_neighbor(side)) {
-				Vector2i neighbor = get_neighbor_cell(selected_cell_to_replace, side);
-				if (to_replace.has(neighbor)) {
-					per_cell_acceptable_tiles[neighbor] = _get_valid_terrains_patterns_for_constraints(p_terrain_set, neighbor, constraints);
+		// Start with every pattern matching the constrained points.
+		domains.resize(cells.size() * words_count);
+		for (uint32_t cell = 0; cell < cells.size(); cell++) {
+			uint64_t *domain = _get_domain(cell);
+			table->fill(domain);
+			for (int bit = 0; bit < bits_count; bit++) {
+				const Point &point = points[cells_points[cell * bits_count + bit]];
+				if (point.constrained) {
+					table->constrain(domain, bits[bit], point.terrain_index - 1);
 				}
 			}
 		}
+
+		queued.resize(cells.size());
+		decided.resize(cells.size());
+		for (uint32_t cell = 0; cell < cells.size(); cell++) {
+			queued[cell] = false;
+			decided[cell] = false;
+		}
+		valid = true;
 	}
-	return output;
+};
+
+Map<Vector2i, RTileSet::TerrainsPattern> RTileMap::terrain_wave_function_collapse(const Set<Vector2i> &p_to_replace, int p_terrain_set, const Set<TerrainConstraint> p_constraints, RandomPCG *p_rng) {
+	if (!tile_set.is_valid()) {
+		return Map<Vector2i, RTileSet::TerrainsPattern>();
+	}
+	ERR_FAIL_INDEX_V(p_terrain_set, tile_set->get_terrain_sets_count(), (Map<Vector2i, RTileSet::TerrainsPattern>()));
+
+	RTileMapTerrainSolver solver(this, p_to_replace, p_terrain_set, p_constraints, p_rng);
+	return solver.solve();
 }
 
-void RTileMap::set_cells_from_surrounding_terrains(int p_layer, Vector<Vector2> p_coords_array, int p_terrain_set, bool p_ignore_empty_terrains) {
+void RTileMap::set_cells_from_surrounding_terrains(int p_layer, Vector<Vector2> p_coords_array, int p_terrain_set, bool p_ignore_empty_terrains, int64_t p_seed) {
 	ERR_FAIL_COND(!tile_set.is_valid());
 	ERR_FAIL_INDEX(p_layer, (int)layers.size());
 	ERR_FAIL_INDEX(p_terrain_set, tile_set->get_terrain_sets_count());
@@ -2414,25 +4374,28 @@ void RTileMap::set_cells_from_surrounding_terrains(int p_layer, Vector<Vector2>
 
 	Set<RTileMap::TerrainConstraint> constraints = get_terrain_constraints_from_removed_cells_list(p_layer, coords_set, p_terrain_set, p_ignore_empty_terrains);
 
-	Map<Vector2i, RTileSet::TerrainsPattern> wfc_output = terrain_wave_function_collapse(coords_set, p_terrain_set, constraints);
+	// A seed makes the fill reproducible.
+	RandomPCG rng(p_seed);
+	RandomPCG *rng_ptr = p_seed >= 0 ? &rng : nullptr;
+
+	Map<Vector2i, RTileSet::TerrainsPattern> wfc_output = terrain_wave_function_collapse(coords_set, p_terrain_set, constraints, rng_ptr);
+	begin_batch();
 	for (Map<Vector2i, RTileSet::TerrainsPattern>::Element *kv = wfc_output.front(); kv; kv = kv->next()) {
-		RTileMapCell cell = tile_set->get_random_tile_from_terrains_pattern(p_terrain_set, kv->value());
+		RTileMapCell cell = tile_set->get_random_tile_from_terrains_pattern(p_terrain_set, kv->value(), rng_ptr);
 		set_cell(p_layer, kv->key(), cell.source_id, cell.get_atlas_coords(), cell.alternative_tile);
 	}
+	end_batch();
 }
 
 RTileMapCell RTileMap::get_cell(int p_layer, const Vector2i &p_coords, bool p_use_proxies) const {
 	ERR_FAIL_INDEX_V(p_layer, (int)layers.size(), RTileMapCell());
-	const Map<Vector2i, RTileMapCell> &tile_map = layers[p_layer].tile_map;
-	if (!tile_map.has(p_coords)) {
+	const RTileMapCell *E = layers[p_layer].tile_map.get_cell(p_coords);
+	if (!E) {
 		return RTileMapCell();
 	} else {
-		RTileMapCell c = tile_map.find(p_coords)->get();
+		RTileMapCell c = *E;
 		if (p_use_proxies && tile_set.is_valid()) {
-			Array proxyed = tile_set->map_tile_proxy(c.source_id, c.get_atlas_coords(), c.alternative_tile);
-			c.source_id = proxyed[0];
-			c.set_atlas_coords(proxyed[1]);
-			c.alternative_tile = proxyed[2];
+			c = tile_set->map_tile_proxy_fast(c);
 		}
 		return c;
 	}
@@ -2445,25 +4408,51 @@ Map<Vector2i, RTileMapQuadrant> *RTileMap::get_quadrant_map(int p_layer) {
 }
 
 Vector2 RTileMap::get_coords_for_body_rid(RID p_physics_body) {
+	// Quadrant bodies hold several cells, give the one of their first shape.
+	const Map<RID, LocalVector<Vector2i>>::Element *E = bodies_shapes_coords.find(p_physics_body);
+	if (E && !E->value().empty()) {
+		return E->value()[0];
+	}
+
 	ERR_FAIL_COND_V_MSG(!bodies_coords.has(p_physics_body), Vector2(), vformat("No tiles for the given body RID %d.", p_physics_body));
 	return bodies_coords[p_physics_body];
 }
 
+Vector2 RTileMap::get_coords_for_body_shape(RID p_physics_body, int p_body_shape_index) {
+	const Map<RID, LocalVector<Vector2i>>::Element *E = bodies_shapes_coords.find(p_physics_body);
+	if (!E) {
+		// Bodies of a single cell.
+		return get_coords_for_body_rid(p_physics_body);
+	}
+
+	ERR_FAIL_INDEX_V(p_body_shape_index, (int)E->value().size(), Vector2());
+	return E->value()[p_body_shape_index];
+}
+
 void RTileMap::fix_invalid_tiles() {
 	ERR_FAIL_COND_MSG(tile_set.is_null(), "Cannot fix invalid tiles if Tileset is not open.");
 
 	for (unsigned int i = 0; i < layers.size(); i++) {
-		const Map<Vector2i, RTileMapCell> &tile_map = layers[i].tile_map;
+		const RTileMapCellStorage &tile_map = layers[i].tile_map;
 		Set<Vector2i> coords;
-		for (Map<Vector2i, RTileMapCell>::Element *E = tile_map.front(); E; E = E->next()) {
-			RTileSetSource *source = *tile_set->get_source(E->value().source_id);
-			if (!source || !source->has_tile(E->value().get_atlas_coords()) || !source->has_alternative_tile(E->value().get_atlas_coords(), E->value().alternative_tile)) {
-				coords.insert(E->key());
+		for (uint32_t chunk_index = 0; chunk_index < tile_map.get_chunks_count(); chunk_index++) {
+			const RTileMapCellStorage::Chunk *chunk = tile_map.get_chunk_by_index(chunk_index);
+			for (uint32_t cell_index = 0; cell_index < RTileMapCellStorage::CHUNK_CELLS_COUNT; cell_index++) {
+				if (!chunk->is_used(cell_index)) {
+					continue;
+				}
+				const RTileMapCell &c = chunk->cells[cell_index];
+				RTileSetSource *source = *tile_set->get_source(c.source_id);
+				if (!source || !source->has_tile(c.get_atlas_coords()) || !source->has_alternative_tile(c.get_atlas_coords(), c.alternative_tile)) {
+					coords.insert(chunk->get_cell_coords(cell_index));
+				}
 			}
 		}
+		begin_batch();
 		for (Set<Vector2i>::Element *E = coords.front(); E; E = E->next()) {
 			set_cell(i, E->get(), RTileSet::INVALID_SOURCE, RTileSetSource::INVALID_ATLAS_COORDS, RTileSetSource::INVALID_TILE_ALTERNATIVE);
 		}
+		end_batch();
 	}
 }
 
@@ -2473,6 +4462,7 @@ void RTileMap::clear_layer(int p_layer) {
 	// Remove all tiles.
 	_clear_layer_internals(p_layer);
 	layers[p_layer].tile_map.clear();
+	layers[p_layer].base_file = String();
 
 	used_rect_cache_dirty = true;
 }
@@ -2482,6 +4472,7 @@ void RTileMap::clear() {
 	_clear_internals();
 	for (unsigned int i = 0; i < layers.size(); i++) {
 		layers[i].tile_map.clear();
+		layers[i].base_file = String();
 	}
 	used_rect_cache_dirty = true;
 }
@@ -2499,7 +4490,7 @@ void RTileMap::force_update(int p_layer) {
 
 void RTileMap::_set_tile_data(int p_layer, const Vector<int> &p_data) {
 	ERR_FAIL_INDEX(p_layer, (int)layers.size());
-	ERR_FAIL_COND(format > FORMAT_3);
+	ERR_FAIL_COND(format >= FORMAT_4);
 
 	// Set data for a given tile from raw data.
 
@@ -2515,6 +4506,7 @@ void RTileMap::_set_tile_data(int p_layer, const Vector<int> &p_data) {
 	ERR_FAIL_COND_MSG(format != FORMAT_3, vformat("Cannot handle deprecated TileMap data format version %d. This Godot version was compiled with no support for deprecated data.", format));
 #endif
 
+	begin_batch();
 	for (int i = 0; i < c; i += offset) {
 		const uint8_t *ptr = (const uint8_t *)&r[i];
 		uint8_t local[12];
@@ -2577,6 +4569,7 @@ void RTileMap::_set_tile_data(int p_layer, const Vector<int> &p_data) {
 #endif
 		}
 	}
+	end_batch();
 	emit_signal("changed");
 }
 
@@ -2584,59 +4577,356 @@ Vector<int> RTileMap::_get_tile_data(int p_layer) const {
 	ERR_FAIL_INDEX_V(p_layer, (int)layers.size(), Vector<int>());
 
 	// Export tile data to raw format
-	const Map<Vector2i, RTileMapCell> &tile_map = layers[p_layer].tile_map;
+	const RTileMapCellStorage &tile_map = layers[p_layer].tile_map;
 	Vector<int> data;
 	data.resize(tile_map.size() * 3);
 	int *w = data.ptrw();
 
 	// Save in highest format
 
+	LocalVector<Vector2i> cells_coords;
+	tile_map.get_sorted_cells(cells_coords);
 	int idx = 0;
-	for (Map<Vector2i, RTileMapCell>::Element *E = tile_map.front(); E; E = E->next()) {
+	for (uint32_t i = 0; i < cells_coords.size(); i++) {
+		const Vector2i &coords = cells_coords[i];
+		const RTileMapCell &c = *tile_map.get_cell(coords);
 		uint8_t *ptr = (uint8_t *)&w[idx];
-		encode_uint16((int16_t)(E->key().x), &ptr[0]);
-		encode_uint16((int16_t)(E->key().y), &ptr[2]);
-		encode_uint16(E->value().source_id, &ptr[4]);
-		encode_uint16(E->value().coord_x, &ptr[6]);
-		encode_uint16(E->value().coord_y, &ptr[8]);
-		encode_uint16(E->value().alternative_tile, &ptr[10]);
+		encode_uint16((int16_t)(coords.x), &ptr[0]);
+		encode_uint16((int16_t)(coords.y), &ptr[2]);
+		encode_uint16(c.source_id, &ptr[4]);
+		encode_uint16(c.coord_x, &ptr[6]);
+		encode_uint16(c.coord_y, &ptr[8]);
+		encode_uint16(c.alternative_tile, &ptr[10]);
 		idx += 3;
 	}
 
 	return data;
 }
 
+void RTileMap::_set_tile_data_chunks(int p_layer, const Vector<uint8_t> &p_data) {
+	ERR_FAIL_INDEX(p_layer, (int)layers.size());
+
+	// Decode the cells straight into the storage, then create the quadrants at once.
+	// Over a base file, the data only holds the changes to it, applied over the unchanged base.
+	if (layers[p_layer].tile_map.has_base()) {
+		_clear_layer_internals(p_layer);
+		Error err = layers[p_layer].tile_map.open_base(layers[p_layer].base_file);
+		if (err == OK) {
+			err = layers[p_layer].tile_map.decode(p_data);
+			if (err != OK) {
+				// Drop the partially applied changes.
+				err = layers[p_layer].tile_map.open_base(layers[p_layer].base_file);
+			}
+		}
+		if (err != OK) {
+			ERR_PRINT(vformat("Cannot open the base file of the TileMap layer %d: %s.", p_layer, layers[p_layer].base_file));
+		}
+	} else {
+		clear_layer(p_layer);
+		Error err = layers[p_layer].tile_map.decode(p_data);
+		if (err != OK) {
+			layers[p_layer].tile_map.clear();
+		}
+	}
+	_recreate_layer_internals(p_layer);
+	used_rect_cache_dirty = true;
+	emit_signal("changed");
+}
+
+Vector<uint8_t> RTileMap::_get_tile_data_chunks(int p_layer) const {
+	ERR_FAIL_INDEX_V(p_layer, (int)layers.size(), Vector<uint8_t>());
+
+	return layers[p_layer].tile_map.encode(_get_tile_data_compression_mode());
+}
+
+int RTileMap::_get_tile_data_compression_mode() const {
+	switch (tile_data_compression) {
+		case TILE_DATA_COMPRESSION_DEFLATE:
+			return Compression::MODE_DEFLATE;
+		case TILE_DATA_COMPRESSION_ZSTD:
+			return Compression::MODE_ZSTD;
+		default:
+			return -1;
+	}
+}
+
+void RTileMap::_streaming_start() {
+	if (streamer || streaming_directory.empty() || !is_inside_tree()) {
+		return;
+	}
+	streamer = memnew(RTileMapRegionStreamer(streaming_directory));
+
+	// The cells already set, like the ones saved with the scene, are merged into their region files and take precedence.
+	for (unsigned int layer = 0; layer < layers.size(); layer++) {
+		const RTileMapCellStorage &tile_map = layers[layer].tile_map;
+		for (uint32_t chunk_index = 0; chunk_index < tile_map.get_chunks_count(); chunk_index++) {
+			const RTileMapCellStorage::Chunk *chunk = tile_map.get_chunk_by_index(chunk_index);
+			for (uint32_t i = 0; i < RTileMapCellStorage::CHUNK_CELLS_COUNT; i++) {
+				if (chunk->is_used(i)) {
+					_streaming_make_cell_dirty(layer, chunk->get_cell_coords(i));
+				}
+			}
+		}
+	}
+
+	set_process_internal(true);
+}
+
+void RTileMap::_streaming_stop() {
+	if (!streamer) {
+		return;
+	}
+
+	// Merge the regions still being read, then write back every edited region.
+	streamer->wait_for_requests();
+	_streaming_integrate_regions();
+	for (Map<Vector2i, StreamedRegion>::Element *E = streamed_regions.front(); E; E = E->next()) {
+		if (E->get().dirty) {
+			_streaming_save_region(E->key());
+		}
+	}
+	memdelete(streamer); // Processes the queued saves.
+	streamer = nullptr;
+	streamed_regions.clear();
+
+	// Drop the streamed cells, the layers go back to their base file if any.
+	_clear_internals();
+	for (unsigned int layer = 0; layer < layers.size(); layer++) {
+		RTileMapCellStorage &tile_map = layers[layer].tile_map;
+		if (layers[layer].base_file.empty()) {
+			tile_map.clear();
+		} else if (tile_map.open_base(layers[layer].base_file) != OK) {
+			ERR_PRINT(vformat("Cannot open the base file of the TileMap layer %d: %s.", layer, layers[layer].base_file));
+		}
+	}
+	used_rect_cache_dirty = true;
+	_recreate_internals();
+}
+
+void RTileMap::_streaming_update() {
+	if (!streamer || !tile_set.is_valid()) {
+		return;
+	}
+
+	_streaming_integrate_regions();
+
+	// Request the regions in range. The candidates are found from a conservative spacing between cells.
+	Vector2 focus_point = _get_update_focus_point();
+	int region_cells = streaming_region_size * quadrant_size;
+	Size2 tile_size = tile_set->get_tile_size();
+	real_t cell_spacing = MAX(1.0, MIN(tile_size.x, tile_size.y) / 2.0);
+	int radius = Math::ceil(streaming_load_distance / (cell_spacing * region_cells)) + 1;
+	Vector2i focus_region = _streaming_get_region_coords(world_to_map(focus_point));
+	for (int y = -radius; y <= radius; y++) {
+		for (int x = -radius; x <= radius; x++) {
+			Vector2i region = focus_region + Vector2i(x, y);
+			if (!streamed_regions.has(region) && _streaming_get_region_distance(region, focus_point) <= streaming_load_distance) {
+				streamed_regions.insert(region, StreamedRegion());
+				streamer->request_load(region);
+			}
+		}
+	}
+
+	// Evict the loaded regions out of range. The unload distance being larger avoids reloading regions when the focus moves back and forth on their border.
+	real_t unload_distance = MAX(streaming_unload_distance, streaming_load_distance);
+	LocalVector<Vector2i> to_evict;
+	for (Map<Vector2i, StreamedRegion>::Element *E = streamed_regions.front(); E; E = E->next()) {
+		if (E->get().loaded && _streaming_get_region_distance(E->key(), focus_point) > unload_distance) {
+			to_evict.push_back(E->key());
+		}
+	}
+	for (uint32_t i = 0; i < to_evict.size(); i++) {
+		_streaming_evict_region(to_evict[i]);
+	}
+}
+
+Vector2i RTileMap::_streaming_get_region_coords(const Vector2i &p_coords) const {
+	int region_cells = streaming_region_size * quadrant_size;
+	// Rounds towards negative infinity.
+	return Vector2i(
+			(p_coords.x >= 0 ? p_coords.x : p_coords.x - region_cells + 1) / region_cells,
+			(p_coords.y >= 0 ? p_coords.y : p_coords.y - region_cells + 1) / region_cells);
+}
+
+Rect2i RTileMap::_streaming_get_region_cells(const Vector2i &p_region) const {
+	int region_cells = streaming_region_size * quadrant_size;
+	return Rect2i(p_region * region_cells, Vector2i(region_cells, region_cells));
+}
+
+real_t RTileMap::_streaming_get_region_distance(const Vector2i &p_region, const Vector2 &p_point) const {
+	// Distance to the bounding rect of the region, in local coordinates.
+	Rect2i cells = _streaming_get_region_cells(p_region);
+	Vector2i end = cells.position + cells.size;
+	Rect2 rect(map_to_world(cells.position), Size2());
+	rect.expand_to(map_to_world(Vector2i(end.x, cells.position.y)));
+	rect.expand_to(map_to_world(Vector2i(cells.position.x, end.y)));
+	rect.expand_to(map_to_world(end));
+
+	Vector2 closest = Vector2(CLAMP(p_point.x, rect.position.x, rect.position.x + rect.size.x), CLAMP(p_point.y, rect.position.y, rect.position.y + rect.size.y));
+	return p_point.distance_to(closest);
+}
+
+void RTileMap::_streaming_make_cell_dirty(int p_layer, const Vector2i &p_coords) {
+	Vector2i region = _streaming_get_region_coords(p_coords);
+	Map<Vector2i, StreamedRegion>::Element *E = streamed_regions.find(region);
+	if (!E) {
+		// Changed out of the loaded regions, read the rest of the region so it can be written back.
+		E = streamed_regions.insert(region, StreamedRegion());
+		streamer->request_load(region);
+	}
+	E->get().dirty = true;
+	if (!E->get().loaded) {
+		E->get().pending_cells[p_layer].insert(p_coords);
+	}
+}
+
+void RTileMap::_streaming_integrate_regions() {
+	LocalVector<RTileMapRegionStreamer::LoadedRegion> loaded_regions;
+	streamer->take_loaded_regions(loaded_regions);
+	if (loaded_regions.empty()) {
+		return;
+	}
+
+	begin_batch();
+	streaming_updating_cells = true;
+	for (uint32_t region_index = 0; region_index < loaded_regions.size(); region_index++) {
+		const RTileMapRegionStreamer::LoadedRegion &region = loaded_regions[region_index];
+		Map<Vector2i, StreamedRegion>::Element *E = streamed_regions.find(region.coords);
+		bool integrate = E && !E->get().loaded;
+
+		for (uint32_t layer = 0; layer < region.layers.size(); layer++) {
+			const RTileMapCellStorage *storage = region.layers[layer];
+			if (integrate && layer < layers.size()) {
+				// Cells set or erased while the region was read are kept.
+				Map<int, Set<Vector2i>>::Element *E_pending = E->get().pending_cells.find(layer);
+				for (uint32_t chunk_index = 0; chunk_index < storage->get_chunks_count(); chunk_index++) {
+					const RTileMapCellStorage::Chunk *chunk = storage->get_chunk_by_index(chunk_index);
+					for (uint32_t i = 0; i < RTileMapCellStorage::CHUNK_CELLS_COUNT; i++) {
+						if (!chunk->is_used(i)) {
+							continue;
+						}
+						Vector2i coords = chunk->get_cell_coords(i);
+						if (!E_pending || !E_pending->get().has(coords)) {
+							const RTileMapCell &cell = chunk->cells[i];
+							set_cell(layer, coords, cell.source_id, cell.get_atlas_coords(), cell.alternative_tile);
+						}
+					}
+				}
+			}
+			memdelete(storage);
+		}
+
+		if (integrate) {
+			E->get().loaded = true;
+			E->get().pending_cells.clear();
+		}
+	}
+	streaming_updating_cells = false;
+	end_batch();
+}
+
+void RTileMap::_streaming_save_region(const Vector2i &p_region) {
+	Rect2i cells = _streaming_get_region_cells(p_region);
+	int compression_mode = _get_tile_data_compression_mode();
+
+	LocalVector<Vector<uint8_t>> layers_data;
+	for (unsigned int layer = 0; layer < layers.size(); layer++) {
+		const RTileMapCellStorage &tile_map = layers[layer].tile_map;
+		RTileMapCellStorage region_tile_map;
+		for (int y = cells.position.y; y < cells.position.y + cells.size.y; y++) {
+			for (int x = cells.position.x; x < cells.position.x + cells.size.x; x++) {
+				const RTileMapCell *cell = tile_map.get_cell(Vector2i(x, y));
+				if (cell) {
+					region_tile_map.insert_cell(Vector2i(x, y), *cell);
+				}
+			}
+		}
+		layers_data.push_back(region_tile_map.encode(compression_mode));
+	}
+	streamer->request_save(p_region, layers_data);
+}
+
+void RTileMap::_streaming_evict_region(const Vector2i &p_region) {
+	Map<Vector2i, StreamedRegion>::Element *E = streamed_regions.find(p_region);
+	ERR_FAIL_COND(!E);
+	if (E->get().dirty) {
+		_streaming_save_region(p_region);
+	}
+	streamed_regions.erase(E);
+
+	// Erasing the cells releases the quadrants, with their server resources.
+	Rect2i cells = _streaming_get_region_cells(p_region);
+	begin_batch();
+	streaming_updating_cells = true;
+	for (unsigned int layer = 0; layer < layers.size(); layer++) {
+		const RTileMapCellStorage &tile_map = layers[layer].tile_map;
+		for (int y = cells.position.y; y < cells.position.y + cells.size.y; y++) {
+			for (int x = cells.position.x; x < cells.position.x + cells.size.x; x++) {
+				if (tile_map.has_cell(Vector2i(x, y))) {
+					set_cell(layer, Vector2i(x, y));
+				}
+			}
+		}
+	}
+	streaming_updating_cells = false;
+	end_batch();
+}
+
 void RTileMap::_build_runtime_update_tile_data(SelfList<RTileMapQuadrant>::List &r_dirty_quadrant_list) {
+	// Free the runtime TileData of the modified cells, the other ones are kept until their cell changes.
+	for (SelfList<RTileMapQuadrant> *q_list_element = r_dirty_quadrant_list.first(); q_list_element; q_list_element = q_list_element->next()) {
+		RTileMapQuadrant &q = *q_list_element->self();
+		if (q.full_update) {
+			for (Map<Vector2i, RTileData *>::Element *E = q.runtime_tile_data_cache.front(); E; E = E->next()) {
+				memdelete(E->value());
+			}
+			q.runtime_tile_data_cache.clear();
+		} else {
+			for (Set<Vector2i>::Element *E_cell = q.dirty_cells.front(); E_cell; E_cell = E_cell->next()) {
+				Map<Vector2i, RTileData *>::Element *E = q.runtime_tile_data_cache.find(E_cell->get());
+				if (E) {
+					memdelete(E->value());
+					q.runtime_tile_data_cache.erase(E);
+				}
+			}
+		}
+	}
+
 	if (has_method("_use_tile_data_runtime_update") && has_method("_tile_data_runtime_update")) {
 		SelfList<RTileMapQuadrant> *q_list_element = r_dirty_quadrant_list.first();
 		while (q_list_element) {
 			RTileMapQuadrant &q = *q_list_element->self();
-			// Iterate over the cells of the quadrant.
-			for (Map<Vector2i, Vector2i, RTileMapQuadrant::CoordsWorldComparator>::Element *E_cell = q.world_to_map.front(); E_cell; E_cell = E_cell->next()) {
-				RTileMapCell c = get_cell(q.layer, E_cell->value(), true);
-
-				RTileSetSource *source;
-				if (tile_set->has_source(c.source_id)) {
-					source = *tile_set->get_source(c.source_id);
-
-					if (!source->has_tile(c.get_atlas_coords()) || !source->has_alternative_tile(c.get_atlas_coords(), c.alternative_tile)) {
-						continue;
+			// Iterate over the modified cells of the quadrant.
+			LocalVector<Vector2i> modified_cells;
+			if (q.full_update) {
+				for (uint32_t i = 0; i < q.cells.size(); i++) {
+					modified_cells.push_back(q.cells[i].coords);
+				}
+			} else {
+				for (Set<Vector2i>::Element *E = q.dirty_cells.front(); E; E = E->next()) {
+					if (layers[q.layer].tile_map.has_cell(E->get())) {
+						modified_cells.push_back(E->get());
 					}
+				}
+			}
+			for (uint32_t i = 0; i < modified_cells.size(); i++) {
+				const Vector2i &pk = modified_cells[i];
+				const RTileMapCell *cell = layers[q.layer].tile_map.get_cell(pk);
+				const RTileSet::TileResolution *resolution = cell ? tile_set->resolve_tile(*cell) : nullptr;
+				if (!resolution || !resolution->atlas_source) {
+					continue;
+				}
 
-					RTileSetAtlasSource *atlas_source = Object::cast_to<RTileSetAtlasSource>(source);
-					if (atlas_source) {
-						bool ret = false;
-						if (call("_use_tile_data_runtime_update", q.layer, Vector2(E_cell->value()), ret) && ret) {
-							RTileData *tile_data = Object::cast_to<RTileData>(atlas_source->get_tile_data(c.get_atlas_coords(), c.alternative_tile));
+				bool ret = false;
+				if (call("_use_tile_data_runtime_update", q.layer, Vector2(pk), ret) && ret) {
+					RTileData *tile_data = resolution->tile_data;
 
-							// Create the runtime RTileData.
-							RTileData *tile_data_runtime_use = tile_data->duplicate();
-							tile_data->set_allow_transform(true);
-							q.runtime_tile_data_cache[E_cell->value()] = tile_data_runtime_use;
+					// Create the runtime RTileData.
+					RTileData *tile_data_runtime_use = tile_data->duplicate();
+					tile_data->set_allow_transform(true);
+					q.runtime_tile_data_cache[pk] = tile_data_runtime_use;
 
-							call("_tile_data_runtime_update", q.layer, Vector2(E_cell->value()), tile_data_runtime_use);
-						}
-					}
+					call("_tile_data_runtime_update", q.layer, Vector2(pk), tile_data_runtime_use);
 				}
 			}
 			q_list_element = q_list_element->next();
@@ -2664,7 +4954,7 @@ bool RTileMap::_set(const StringName &p_name, const Variant &p_value) {
 			return true;
 		}
 	} else if (p_name == "tile_data") { // Kept for compatibility reasons.
-		if (p_value.is_array()) {
+		if (p_value.is_array() && format < FORMAT_4) {
 			if (layers.size() < 1) {
 				layers.resize(1);
 			}
@@ -2708,8 +4998,15 @@ bool RTileMap::_set(const StringName &p_name, const Variant &p_value) {
 		} else if (components[1] == "z_index") {
 			set_layer_z_index(index, p_value);
 			return true;
+		} else if (components[1] == "base_file") {
+			set_layer_base_file(index, p_value);
+			return true;
 		} else if (components[1] == "tile_data") {
-			_set_tile_data(index, p_value);
+			if (format >= FORMAT_4) {
+				_set_tile_data_chunks(index, p_value);
+			} else {
+				_set_tile_data(index, p_value);
+			}
 			return true;
 		} else {
 			return false;
@@ -2721,7 +5018,7 @@ bool RTileMap::_set(const StringName &p_name, const Variant &p_value) {
 bool RTileMap::_get(const StringName &p_name, Variant &r_ret) const {
 	Vector<String> components = String(p_name).split("/", true, 2);
 	if (p_name == "format") {
-		r_ret = FORMAT_3; // When saving, always save highest format
+		r_ret = FORMAT_4; // When saving, always save highest format
 		return true;
 	} else if (components.size() == 2 && components[0].begins_with("layer_") && components[0].trim_prefix("layer_").is_valid_integer()) {
 		int index = components[0].trim_prefix("layer_").to_int();
@@ -2747,8 +5044,12 @@ bool RTileMap::_get(const StringName &p_name, Variant &r_ret) const {
 		} else if (components[1] == "z_index") {
 			r_ret = get_layer_z_index(index);
 			return true;
+		} else if (components[1] == "base_file") {
+			r_ret = get_layer_base_file(index);
+			return true;
 		} else if (components[1] == "tile_data") {
-			r_ret = _get_tile_data(index);
+			// Streamed cells belong to the region files.
+			r_ret = streamer ? RTileMapCellStorage().encode() : _get_tile_data_chunks(index);
 			return true;
 		} else {
 			return false;
@@ -2767,7 +5068,8 @@ void RTileMap::_get_property_list(List<PropertyInfo> *p_list) const {
 		p_list->push_back(PropertyInfo(Variant::BOOL, vformat("layer_%d/y_sort_enabled", i), PROPERTY_HINT_NONE));
 		p_list->push_back(PropertyInfo(Variant::INT, vformat("layer_%d/y_sort_origin", i), PROPERTY_HINT_NONE));
 		p_list->push_back(PropertyInfo(Variant::INT, vformat("layer_%d/z_index", i), PROPERTY_HINT_NONE));
-		p_list->push_back(PropertyInfo(Variant::OBJECT, vformat("layer_%d/tile_data", i), PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NOEDITOR));
+		p_list->push_back(PropertyInfo(Variant::STRING, vformat("layer_%d/base_file", i), PROPERTY_HINT_FILE, "*.rtmc"));
+		p_list->push_back(PropertyInfo(Variant::POOL_BYTE_ARRAY, vformat("layer_%d/tile_data", i), PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NOEDITOR));
 	}
 }
 
@@ -3397,12 +5699,13 @@ Vector<Vector2> RTileMap::get_used_cells(int p_layer) const {
 	ERR_FAIL_INDEX_V(p_layer, (int)layers.size(), Vector<Vector2>());
 
 	// Returns the cells used in the tilemap.
+	const RTileMapCellStorage &tile_map = layers[p_layer].tile_map;
+	LocalVector<Vector2i> cells_coords;
+	tile_map.get_sorted_cells(cells_coords);
 	Vector<Vector2> a;
-	a.resize(layers[p_layer].tile_map.size());
-	int i = 0;
-	for (Map<Vector2i, RTileMapCell>::Element *E = layers[p_layer].tile_map.front(); E; E = E->next()) {
-		Vector2 p(E->key().x, E->key().y);
-		a.write[i++] = p;
+	a.resize(cells_coords.size());
+	for (uint32_t i = 0; i < cells_coords.size(); i++) {
+		a.write[i] = cells_coords[i];
 	}
 
 	return a;
@@ -3415,15 +5718,15 @@ Rect2 RTileMap::get_used_rect() { // Not const because of cache
 		used_rect_cache = Rect2i();
 
 		for (unsigned int i = 0; i < layers.size(); i++) {
-			const Map<Vector2i, RTileMapCell> &tile_map = layers[i].tile_map;
+			const RTileMapCellStorage &tile_map = layers[i].tile_map;
 			if (tile_map.size() > 0) {
+				Rect2i layer_used_rect = tile_map.get_used_rect();
 				if (first) {
-					used_rect_cache = Rect2i(tile_map.front()->key().x, tile_map.front()->key().y, 0, 0);
+					used_rect_cache = layer_used_rect;
 					first = false;
-				}
-
-				for (Map<Vector2i, RTileMapCell>::Element *E = tile_map.front(); E; E = E->next()) {
-					used_rect_cache.expand_to(Vector2i(E->key().x, E->key().y));
+				} else {
+					used_rect_cache.expand_to(layer_used_rect.position);
+					used_rect_cache.expand_to(layer_used_rect.position + layer_used_rect.size);
 				}
 			}
 		}
@@ -3444,8 +5747,9 @@ void RTileMap::set_light_mask(int p_light_mask) {
 	CanvasItem::set_light_mask(p_light_mask);
 	for (unsigned int layer = 0; layer < layers.size(); layer++) {
 		for (Map<Vector2i, RTileMapQuadrant>::Element *E = layers[layer].quadrant_map.front(); E; E = E->next()) {
-			for (List<RID>::Element *ci = E->value().canvas_items.front(); ci; ci = ci->next()) {
-				VisualServer::get_singleton()->canvas_item_set_light_mask(ci->get(), get_light_mask());
+			RTileMapQuadrant &q = E->value();
+			for (uint32_t i = 0; i < q.rendering_batches.size(); i++) {
+				VisualServer::get_singleton()->canvas_item_set_light_mask(q.rendering_batches[i].canvas_item, get_light_mask());
 			}
 		}
 		_rendering_update_layer(layer);
@@ -3461,8 +5765,8 @@ void RTileMap::set_material(const Ref<Material> &p_material) {
 		for (Map<Vector2i, RTileMapQuadrant>::Element *E = layers[layer].quadrant_map.front(); E; E = E->next()) {
 			RTileMapQuadrant &q = E->value();
 			
-			for (List<RID>::Element *ci = q.canvas_items.front(); ci; ci = ci->next()) {
-				VS::get_singleton()->canvas_item_set_use_parent_material(ci->get(), get_use_parent_material() || get_material().is_valid());
+			for (uint32_t i = 0; i < q.rendering_batches.size(); i++) {
+				VS::get_singleton()->canvas_item_set_use_parent_material(q.rendering_batches[i].canvas_item, get_use_parent_material() || get_material().is_valid());
 			}
 		}
 		_rendering_update_layer(layer);
@@ -3478,8 +5782,8 @@ void RTileMap::set_use_parent_material(bool p_use_parent_material) {
 		for (Map<Vector2i, RTileMapQuadrant>::Element *E = layers[layer].quadrant_map.front(); E; E = E->next()) {
 			RTileMapQuadrant &q = E->value();
 
-			for (List<RID>::Element *ci = q.canvas_items.front(); ci; ci = ci->next()) {
-				VS::get_singleton()->canvas_item_set_use_parent_material(ci->get(), get_use_parent_material() || get_material().is_valid());
+			for (uint32_t i = 0; i < q.rendering_batches.size(); i++) {
+				VS::get_singleton()->canvas_item_set_use_parent_material(q.rendering_batches[i].canvas_item, get_use_parent_material() || get_material().is_valid());
 			}
 		}
 		_rendering_update_layer(layer);
@@ -3493,7 +5797,8 @@ void RTileMap::set_texture_filter(TextureFilter p_texture_filter) {
 	for (unsigned int layer = 0; layer < layers.size(); layer++) {
 		for (Map<Vector2i, RTileMapQuadrant>::Element *F = layers[layer].quadrant_map.front(); F; F = F->next()) {
 			RTileMapQuadrant &q = F->get();
-			for (const RID &ci : q.canvas_items) {
+			for (uint32_t i = 0; i < q.rendering_batches.size(); i++) {
+				const RID &ci = q.rendering_batches[i].canvas_item;
 				VisualServer::get_singleton()->canvas_item_set_default_texture_filter(ci, VS::CanvasItemTextureFilter(p_texture_filter));
 				_make_quadrant_dirty(F);
 			}
@@ -3508,7 +5813,8 @@ void RTileMap::set_texture_repeat(CanvasItem::TextureRepeat p_texture_repeat) {
 	for (unsigned int layer = 0; layer < layers.size(); layer++) {
 		for (Map<Vector2i, RTileMapQuadrant>::Element *F = layers[layer].quadrant_map.front(); F; F = F->next()) {
 			RTileMapQuadrant &q = F->get();
-			for (const RID &ci : q.canvas_items) {
+			for (uint32_t i = 0; i < q.rendering_batches.size(); i++) {
+				const RID &ci = q.rendering_batches[i].canvas_item;
 				VisualServer::get_singleton()->canvas_item_set_default_texture_repeat(ci, VS::CanvasItemTextureRepeat(p_texture_repeat));
 				_make_quadrant_dirty(F);
 			}
@@ -3661,6 +5967,9 @@ void RTileMap::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_layer_y_sort_origin", "layer"), &RTileMap::get_layer_y_sort_origin);
 	ClassDB::bind_method(D_METHOD("set_layer_z_index", "layer", "z_index"), &RTileMap::set_layer_z_index);
 	ClassDB::bind_method(D_METHOD("get_layer_z_index", "layer"), &RTileMap::get_layer_z_index);
+	ClassDB::bind_method(D_METHOD("set_layer_base_file", "layer", "path"), &RTileMap::set_layer_base_file);
+	ClassDB::bind_method(D_METHOD("get_layer_base_file", "layer"), &RTileMap::get_layer_base_file);
+	ClassDB::bind_method(D_METHOD("save_layer_base_file", "layer", "path"), &RTileMap::save_layer_base_file);
 
 	ClassDB::bind_method(D_METHOD("is_y_sort_enabled"), &RTileMap::is_y_sort_enabled);
 	ClassDB::bind_method(D_METHOD("set_y_sort_enabled", "p_enable"), &RTileMap::set_y_sort_enabled);
@@ -3668,30 +5977,84 @@ void RTileMap::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("set_collision_animatable", "enabled"), &RTileMap::set_collision_animatable);
 	ClassDB::bind_method(D_METHOD("is_collision_animatable"), &RTileMap::is_collision_animatable);
+	ClassDB::bind_method(D_METHOD("set_collision_use_quadrant_bodies", "use_quadrant_bodies"), &RTileMap::set_collision_use_quadrant_bodies);
+	ClassDB::bind_method(D_METHOD("is_collision_using_quadrant_bodies"), &RTileMap::is_collision_using_quadrant_bodies);
+	ClassDB::bind_method(D_METHOD("set_collision_merge_shapes", "merge_shapes"), &RTileMap::set_collision_merge_shapes);
+	ClassDB::bind_method(D_METHOD("is_collision_merging_shapes"), &RTileMap::is_collision_merging_shapes);
+	ClassDB::bind_method(D_METHOD("set_use_mesh_batching", "use_mesh_batching"), &RTileMap::set_use_mesh_batching);
+	ClassDB::bind_method(D_METHOD("is_using_mesh_batching"), &RTileMap::is_using_mesh_batching);
+	ClassDB::bind_method(D_METHOD("set_use_physics_activation", "use_physics_activation"), &RTileMap::set_use_physics_activation);
+	ClassDB::bind_method(D_METHOD("is_using_physics_activation"), &RTileMap::is_using_physics_activation);
+	ClassDB::bind_method(D_METHOD("set_physics_activation_distance", "distance"), &RTileMap::set_physics_activation_distance);
+	ClassDB::bind_method(D_METHOD("get_physics_activation_distance"), &RTileMap::get_physics_activation_distance);
+	ClassDB::bind_method(D_METHOD("set_physics_activation_release_distance", "distance"), &RTileMap::set_physics_activation_release_distance);
+	ClassDB::bind_method(D_METHOD("get_physics_activation_release_distance"), &RTileMap::get_physics_activation_release_distance);
+	ClassDB::bind_method(D_METHOD("add_physics_activator", "node", "collision_mask"), &RTileMap::add_physics_activator, DEFVAL(0xFFFFFFFF));
+	ClassDB::bind_method(D_METHOD("remove_physics_activator", "node"), &RTileMap::remove_physics_activator);
+	ClassDB::bind_method(D_METHOD("get_physics_activators"), &RTileMap::get_physics_activators);
+
+	ClassDB::bind_method(D_METHOD("set_use_viewport_culling", "use_viewport_culling"), &RTileMap::set_use_viewport_culling);
+	ClassDB::bind_method(D_METHOD("is_using_viewport_culling"), &RTileMap::is_using_viewport_culling);
+	ClassDB::bind_method(D_METHOD("set_viewport_culling_margin", "margin"), &RTileMap::set_viewport_culling_margin);
+	ClassDB::bind_method(D_METHOD("get_viewport_culling_margin"), &RTileMap::get_viewport_culling_margin);
+	ClassDB::bind_method(D_METHOD("set_viewport_culling_release_margin", "margin"), &RTileMap::set_viewport_culling_release_margin);
+	ClassDB::bind_method(D_METHOD("get_viewport_culling_release_margin"), &RTileMap::get_viewport_culling_release_margin);
 	ClassDB::bind_method(D_METHOD("set_collision_visibility_mode", "collision_visibility_mode"), &RTileMap::set_collision_visibility_mode);
 	ClassDB::bind_method(D_METHOD("get_collision_visibility_mode"), &RTileMap::get_collision_visibility_mode);
 
 	ClassDB::bind_method(D_METHOD("set_navigation_visibility_mode", "navigation_visibility_mode"), &RTileMap::set_navigation_visibility_mode);
 	ClassDB::bind_method(D_METHOD("get_navigation_visibility_mode"), &RTileMap::get_navigation_visibility_mode);
+	ClassDB::bind_method(D_METHOD("set_navigation_merge_regions", "merge_regions"), &RTileMap::set_navigation_merge_regions);
+	ClassDB::bind_method(D_METHOD("is_navigation_merging_regions"), &RTileMap::is_navigation_merging_regions);
+
+	ClassDB::bind_method(D_METHOD("set_tile_data_compression", "compression"), &RTileMap::set_tile_data_compression);
+	ClassDB::bind_method(D_METHOD("get_tile_data_compression"), &RTileMap::get_tile_data_compression);
+
+	ClassDB::bind_method(D_METHOD("set_streaming_directory", "directory"), &RTileMap::set_streaming_directory);
+	ClassDB::bind_method(D_METHOD("get_streaming_directory"), &RTileMap::get_streaming_directory);
+	ClassDB::bind_method(D_METHOD("set_streaming_region_size", "size"), &RTileMap::set_streaming_region_size);
+	ClassDB::bind_method(D_METHOD("get_streaming_region_size"), &RTileMap::get_streaming_region_size);
+	ClassDB::bind_method(D_METHOD("set_streaming_load_distance", "distance"), &RTileMap::set_streaming_load_distance);
+	ClassDB::bind_method(D_METHOD("get_streaming_load_distance"), &RTileMap::get_streaming_load_distance);
+	ClassDB::bind_method(D_METHOD("set_streaming_unload_distance", "distance"), &RTileMap::set_streaming_unload_distance);
+	ClassDB::bind_method(D_METHOD("get_streaming_unload_distance"), &RTileMap::get_streaming_unload_distance);
+	ClassDB::bind_method(D_METHOD("is_streaming"), &RTileMap::is_streaming);
+	ClassDB::bind_method(D_METHOD("save_streamed_regions"), &RTileMap::save_streamed_regions);
 
 	ClassDB::bind_method(D_METHOD("set_cell", "layer", "coords", "source_id", "atlas_coords", "alternative_tile"), &RTileMap::set_cell, DEFVAL(RTileSet::INVALID_SOURCE), DEFVAL(RTileSetSource::INVALID_ATLAS_COORDSV), DEFVAL(RTileSetSource::INVALID_TILE_ALTERNATIVE));
+	ClassDB::bind_method(D_METHOD("set_cells", "layer", "coords_array", "packed_cells"), &RTileMap::set_cells);
+	ClassDB::bind_method(D_METHOD("begin_batch"), &RTileMap::begin_batch);
+	ClassDB::bind_method(D_METHOD("end_batch"), &RTileMap::end_batch);
+	ClassDB::bind_method(D_METHOD("is_batching"), &RTileMap::is_batching);
 	ClassDB::bind_method(D_METHOD("get_cell_source_id", "layer", "coords", "use_proxies"), &RTileMap::get_cell_source_id);
 	ClassDB::bind_method(D_METHOD("get_cell_atlas_coords", "layer", "coords", "use_proxies"), &RTileMap::get_cell_atlas_coords);
 	ClassDB::bind_method(D_METHOD("get_cell_alternative_tile", "layer", "coords", "use_proxies"), &RTileMap::get_cell_alternative_tile);
 
 	ClassDB::bind_method(D_METHOD("get_coords_for_body_rid", "body"), &RTileMap::get_coords_for_body_rid);
+	ClassDB::bind_method(D_METHOD("get_coords_for_body_shape", "body", "body_shape_index"), &RTileMap::get_coords_for_body_shape);
 
 	ClassDB::bind_method(D_METHOD("get_pattern", "layer", "coords_array"), &RTileMap::get_pattern);
 	ClassDB::bind_method(D_METHOD("map_pattern", "position_in_tilemap", "coords_in_pattern", "pattern"), &RTileMap::map_pattern);
 	ClassDB::bind_method(D_METHOD("set_pattern", "layer", "position", "pattern"), &RTileMap::set_pattern);
 
-	ClassDB::bind_method(D_METHOD("set_cells_from_surrounding_terrains", "layer", "cells", "terrain_set", "ignore_empty_terrains"), &RTileMap::set_cells_from_surrounding_terrains, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("set_cells_from_surrounding_terrains", "layer", "cells", "terrain_set", "ignore_empty_terrains", "seed"), &RTileMap::set_cells_from_surrounding_terrains, DEFVAL(true), DEFVAL(-1));
 
 	ClassDB::bind_method(D_METHOD("fix_invalid_tiles"), &RTileMap::fix_invalid_tiles);
 	ClassDB::bind_method(D_METHOD("clear_layer", "layer"), &RTileMap::clear_layer);
 	ClassDB::bind_method(D_METHOD("clear"), &RTileMap::clear);
 
 	ClassDB::bind_method(D_METHOD("force_update", "layer"), &RTileMap::force_update, DEFVAL(-1));
+	ClassDB::bind_method(D_METHOD("flush_dirty_quadrants"), &RTileMap::flush_dirty_quadrants);
+	ClassDB::bind_method(D_METHOD("get_rid_pools_statistics"), &RTileMap::get_rid_pools_statistics);
+
+	ClassDB::bind_method(D_METHOD("set_update_budget_msec", "budget_msec"), &RTileMap::set_update_budget_msec);
+	ClassDB::bind_method(D_METHOD("get_update_budget_msec"), &RTileMap::get_update_budget_msec);
+	ClassDB::bind_method(D_METHOD("set_update_budget_quadrants", "budget_quadrants"), &RTileMap::set_update_budget_quadrants);
+	ClassDB::bind_method(D_METHOD("get_update_budget_quadrants"), &RTileMap::get_update_budget_quadrants);
+	ClassDB::bind_method(D_METHOD("set_use_update_focus_point", "enabled"), &RTileMap::set_use_update_focus_point);
+	ClassDB::bind_method(D_METHOD("is_using_update_focus_point"), &RTileMap::is_using_update_focus_point);
+	ClassDB::bind_method(D_METHOD("set_update_focus_point", "focus_point"), &RTileMap::set_update_focus_point);
+	ClassDB::bind_method(D_METHOD("get_update_focus_point"), &RTileMap::get_update_focus_point);
 
 	ClassDB::bind_method(D_METHOD("get_surrounding_tiles", "coords"), &RTileMap::get_surrounding_tiles);
 
@@ -3703,6 +6066,13 @@ void RTileMap::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("get_neighbor_cell", "coords", "neighbor"), &RTileMap::get_neighbor_cell);
 
+	ClassDB::bind_method(D_METHOD("set_pathfinding_custom_data_layer", "layer_name"), &RTileMap::set_pathfinding_custom_data_layer);
+	ClassDB::bind_method(D_METHOD("get_pathfinding_custom_data_layer"), &RTileMap::get_pathfinding_custom_data_layer);
+	ClassDB::bind_method(D_METHOD("find_path", "layer", "from", "to"), &RTileMap::find_path);
+	ClassDB::bind_method(D_METHOD("find_paths", "layer", "from", "to"), &RTileMap::find_paths);
+	ClassDB::bind_method(D_METHOD("get_flow_field", "layer", "region", "goals"), &RTileMap::get_flow_field);
+	ClassDB::bind_method(D_METHOD("get_flow_field_integration", "layer", "region", "goals"), &RTileMap::get_flow_field_integration);
+
 	ClassDB::bind_method(D_METHOD("_update_dirty_quadrants"), &RTileMap::_update_dirty_quadrants);
 
 	ClassDB::bind_method(D_METHOD("_set_tile_data", "layer", "data"), &RTileMap::_set_tile_data);
@@ -3723,8 +6093,38 @@ void RTileMap::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "tile_set", PROPERTY_HINT_RESOURCE_TYPE, "RTileSet"), "set_tileset", "get_tileset");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "cell_quadrant_size", PROPERTY_HINT_RANGE, "1,128,1"), "set_quadrant_size", "get_quadrant_size");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "collision_animatable"), "set_collision_animatable", "is_collision_animatable");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "collision_use_quadrant_bodies"), "set_collision_use_quadrant_bodies", "is_collision_using_quadrant_bodies");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "collision_merge_shapes"), "set_collision_merge_shapes", "is_collision_merging_shapes");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "mesh_batching"), "set_use_mesh_batching", "is_using_mesh_batching");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "collision_visibility_mode", PROPERTY_HINT_ENUM, "Default,Force Show,Force Hide"), "set_collision_visibility_mode", "get_collision_visibility_mode");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "navigation_visibility_mode", PROPERTY_HINT_ENUM, "Default,Force Show,Force Hide"), "set_navigation_visibility_mode", "get_navigation_visibility_mode");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "navigation_merge_regions"), "set_navigation_merge_regions", "is_navigation_merging_regions");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "tile_data_compression", PROPERTY_HINT_ENUM, "None,Deflate,Zstd"), "set_tile_data_compression", "get_tile_data_compression");
+
+	ADD_GROUP("Pathfinding", "pathfinding_");
+	ADD_PROPERTY(PropertyInfo(Variant::STRING, "pathfinding_custom_data_layer"), "set_pathfinding_custom_data_layer", "get_pathfinding_custom_data_layer");
+
+	ADD_GROUP("Physics Activation", "physics_activation_");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "physics_activation_enabled"), "set_use_physics_activation", "is_using_physics_activation");
+	ADD_PROPERTY(PropertyInfo(Variant::REAL, "physics_activation_distance", PROPERTY_HINT_RANGE, "0,4096,1,or_greater"), "set_physics_activation_distance", "get_physics_activation_distance");
+	ADD_PROPERTY(PropertyInfo(Variant::REAL, "physics_activation_release_distance", PROPERTY_HINT_RANGE, "0,4096,1,or_greater"), "set_physics_activation_release_distance", "get_physics_activation_release_distance");
+
+	ADD_GROUP("Viewport Culling", "viewport_culling_");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "viewport_culling_enabled"), "set_use_viewport_culling", "is_using_viewport_culling");
+	ADD_PROPERTY(PropertyInfo(Variant::REAL, "viewport_culling_margin", PROPERTY_HINT_RANGE, "0,4096,1,or_greater"), "set_viewport_culling_margin", "get_viewport_culling_margin");
+	ADD_PROPERTY(PropertyInfo(Variant::REAL, "viewport_culling_release_margin", PROPERTY_HINT_RANGE, "0,4096,1,or_greater"), "set_viewport_culling_release_margin", "get_viewport_culling_release_margin");
+
+	ADD_GROUP("Streaming", "streaming_");
+	ADD_PROPERTY(PropertyInfo(Variant::STRING, "streaming_directory", PROPERTY_HINT_DIR), "set_streaming_directory", "get_streaming_directory");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "streaming_region_size", PROPERTY_HINT_RANGE, "1,64,1,or_greater"), "set_streaming_region_size", "get_streaming_region_size");
+	ADD_PROPERTY(PropertyInfo(Variant::REAL, "streaming_load_distance", PROPERTY_HINT_RANGE, "0,16384,1,or_greater"), "set_streaming_load_distance", "get_streaming_load_distance");
+	ADD_PROPERTY(PropertyInfo(Variant::REAL, "streaming_unload_distance", PROPERTY_HINT_RANGE, "0,16384,1,or_greater"), "set_streaming_unload_distance", "get_streaming_unload_distance");
+
+	ADD_GROUP("Updates", "update_");
+	ADD_PROPERTY(PropertyInfo(Variant::REAL, "update_budget_msec", PROPERTY_HINT_RANGE, "0,100,0.1,or_greater"), "set_update_budget_msec", "get_update_budget_msec");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "update_budget_quadrants", PROPERTY_HINT_RANGE, "0,1024,1,or_greater"), "set_update_budget_quadrants", "get_update_budget_quadrants");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "update_use_focus_point"), "set_use_update_focus_point", "is_using_update_focus_point");
+	ADD_PROPERTY(PropertyInfo(Variant::VECTOR2, "update_focus_point"), "set_update_focus_point", "get_update_focus_point");
 
 	//ADD_ARRAY("layers", "layer_");
 
@@ -3735,6 +6135,10 @@ void RTileMap::_bind_methods() {
 	BIND_ENUM_CONSTANT(VISIBILITY_MODE_DEFAULT);
 	BIND_ENUM_CONSTANT(VISIBILITY_MODE_FORCE_HIDE);
 	BIND_ENUM_CONSTANT(VISIBILITY_MODE_FORCE_SHOW);
+
+	BIND_ENUM_CONSTANT(TILE_DATA_COMPRESSION_NONE);
+	BIND_ENUM_CONSTANT(TILE_DATA_COMPRESSION_DEFLATE);
+	BIND_ENUM_CONSTANT(TILE_DATA_COMPRESSION_ZSTD);
 }
 
 void RTileMap::_tile_set_changed() {
@@ -3745,12 +6149,98 @@ void RTileMap::_tile_set_changed() {
 
 void RTileMap::_tile_set_changed_deferred_update() {
 	if (_tile_set_changed_deferred_update_needed) {
-		_clear_internals();
-		_recreate_internals();
+		LocalVector<RTileSet::TileChange> changes;
+		if (tile_set.is_valid() && tile_set->get_tile_changes_since(tile_set_changes_version, changes)) {
+			_make_changed_tiles_dirty(changes);
+		} else {
+			_clear_internals();
+			_recreate_internals();
+		}
+		if (tile_set.is_valid()) {
+			tile_set_changes_version = tile_set->get_tile_changes_version();
+		}
 		_tile_set_changed_deferred_update_needed = false;
 	}
 }
 
+void RTileMap::_tiles_quadrants_add(int p_layer, const RTileMapCell &p_cell, const Vector2i &p_coords, int p_count) {
+	Map<Vector2i, int> &quadrants = layers[p_layer].tiles_quadrants[p_cell];
+	Vector2i qk = _coords_to_quadrant_coords(p_layer, p_coords);
+	Map<Vector2i, int>::Element *E = quadrants.find(qk);
+	if (!E) {
+		E = quadrants.insert(qk, 0);
+	}
+	E->get() += p_count;
+	if (E->get() <= 0) {
+		quadrants.erase(E);
+		if (quadrants.empty()) {
+			layers[p_layer].tiles_quadrants.erase(p_cell);
+		}
+	}
+}
+
+void RTileMap::_tiles_quadrants_build(int p_layer) {
+	TileMapLayer &layer = layers[p_layer];
+	layer.tiles_quadrants.clear();
+	for (uint32_t chunk_index = 0; chunk_index < layer.tile_map.get_chunks_count(); chunk_index++) {
+		const RTileMapCellStorage::Chunk *chunk = layer.tile_map.get_chunk_by_index(chunk_index);
+		for (uint32_t cell_index = 0; cell_index < RTileMapCellStorage::CHUNK_CELLS_COUNT; cell_index++) {
+			if (chunk->is_used(cell_index)) {
+				_tiles_quadrants_add(p_layer, chunk->cells[cell_index], chunk->get_cell_coords(cell_index), 1);
+			}
+		}
+	}
+	layer.tiles_quadrants_valid = true;
+}
+
+void RTileMap::_make_changed_tiles_dirty(const LocalVector<RTileSet::TileChange> &p_changes) {
+	if (p_changes.empty()) {
+		return;
+	}
+
+	for (unsigned int layer = 0; layer < layers.size(); layer++) {
+		if (!layers[layer].tiles_quadrants_valid) {
+			_tiles_quadrants_build(layer);
+		}
+
+		for (const Map<RTileMapCell, Map<Vector2i, int>>::Element *E_tile = layers[layer].tiles_quadrants.front(); E_tile; E_tile = E_tile->next()) {
+			// Cells display the tile they are proxied to.
+			RTileMapCell tile = tile_set->map_tile_proxy_fast(E_tile->key());
+			uint32_t aspects = 0;
+			for (uint32_t i = 0; i < p_changes.size(); i++) {
+				const RTileMapCell &changed = p_changes[i].tile;
+				if (changed.source_id == tile.source_id && changed.coord_x == tile.coord_x && changed.coord_y == tile.coord_y && (changed.alternative_tile == RTileSetSource::INVALID_TILE_ALTERNATIVE || changed.alternative_tile == tile.alternative_tile)) {
+					aspects |= p_changes[i].aspects;
+				}
+			}
+			if (aspects == 0) {
+				continue;
+			}
+
+			// Dirty the cells using the tile, only for the subsystems depending on what changed.
+			for (const Map<Vector2i, int>::Element *E_quadrant = E_tile->value().front(); E_quadrant; E_quadrant = E_quadrant->next()) {
+				Map<Vector2i, RTileMapQuadrant>::Element *Q = layers[layer].quadrant_map.find(E_quadrant->key());
+				if (!Q) {
+					continue;
+				}
+				const LocalVector<RTileMapQuadrant::Cell> &cells = Q->get().cells;
+				for (uint32_t cell_index = 0; cell_index < cells.size(); cell_index++) {
+					const RTileMapCell *cell = layers[layer].tile_map.get_cell(cells[cell_index].coords);
+					if (!cell || cell->_u64t != E_tile->key()._u64t) {
+						continue;
+					}
+					if (aspects & (RTileSet::TILE_CHANGE_RENDERING | RTileSet::TILE_CHANGE_PHYSICS | RTileSet::TILE_CHANGE_NAVIGATION | RTileSet::TILE_CHANGE_SCENES)) {
+						_make_quadrant_cell_dirty(Q, cells[cell_index].coords, aspects);
+					}
+					if (aspects & (RTileSet::TILE_CHANGE_NAVIGATION | RTileSet::TILE_CHANGE_CUSTOM_DATA)) {
+						_pathfinding_make_cell_dirty(layer, cells[cell_index].coords);
+					}
+				}
+			}
+		}
+	}
+}
+
 RTileMap::RTileMap() {
 	_y_sort_enabled = false;
 
@@ -3766,4 +6256,5 @@ RTileMap::~RTileMap() {
 	}
 
 	_clear_internals();
+	_free_rid_pools();
 }
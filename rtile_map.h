@@ -31,8 +31,12 @@
 #ifndef RTILE_MAP_H
 #define RTILE_MAP_H
 
+#include "core/os/thread_work_pool.h"
 #include "scene/2d/node_2d.h"
 #include "scene/gui/control.h"
+#include "rtile_map_cell_storage.h"
+#include "rtile_map_pathfinding.h"
+#include "rtile_map_streaming.h"
 #include "rtile_set.h"
 
 class RTileSetAtlasSource;
@@ -49,6 +53,33 @@ struct RTileMapQuadrant {
 		}
 	};
 
+	// A cell of the quadrant, with its cached world position.
+	struct Cell {
+		Vector2i coords;
+		Vector2i world_position;
+	};
+
+	struct CellWorldComparator {
+		_ALWAYS_INLINE_ bool operator()(const Cell &p_a, const Cell &p_b) const {
+			return CoordsWorldComparator()(p_a.world_position, p_b.world_position);
+		}
+	};
+
+	// Consecutive cells (in world order) sharing the same material and z_index, drawn in a single CanvasItem.
+	struct RenderingBatch {
+		RID canvas_item;
+		Vector2 position;
+		Ref<ShaderMaterial> material;
+		int z_index = 0;
+		LocalVector<Vector2i> cells;
+		// Animated tiles get their own batches, redrawn when the visible frame of one of them changes.
+		bool animated = false;
+		double next_frame_change = 0.0;
+		// Range of the batch in the quadrant cells, only valid during an update.
+		uint32_t cells_begin = 0;
+		uint32_t cells_end = 0;
+	};
+
 	// Dirty list element
 	SelfList<RTileMapQuadrant> dirty_list_element;
 
@@ -56,55 +87,112 @@ struct RTileMapQuadrant {
 	int layer = -1;
 	Vector2i coords;
 
-	// TileMapCells
-	Set<Vector2i> cells;
-	// We need those two maps to sort by world position for rendering
-	// This is kind of workaround, it would be better to sort the cells directly in the "cells" set instead.
-	Map<Vector2i, Vector2i> map_to_world;
-	Map<Vector2i, Vector2i, CoordsWorldComparator> world_to_map;
+	// TileMapCells, sorted by world position as it is needed by rendering.
+	LocalVector<Cell> cells;
+
+	// Cells modified since the last update. When full_update is set, every cell is considered modified.
+	Set<Vector2i> dirty_cells;
+	bool full_update = true;
+	uint32_t dirty_aspects = RTileSet::TILE_CHANGE_ALL; // The subsystems to update, tileset changes may not need all of them.
 
 	// Debug.
 	RID debug_canvas_item;
 
 	// Rendering.
-	List<RID> canvas_items;
-	List<RID> occluders;
+	LocalVector<RenderingBatch> rendering_batches;
+	SelfList<RTileMapQuadrant> animated_list_element; // In the list while some batches are animated.
+	Map<Vector2i, Vector<RID>> occluders;
+	bool rendering_culled = false; // Out of the viewport, without canvas items nor occluders.
+	SelfList<RTileMapQuadrant> rendered_list_element; // In the list while not culled, when viewport culling is enabled.
 
 	// Physics.
-	List<RID> bodies;
+	Map<Vector2i, Vector<RID>> bodies;
+	uint32_t physics_active_mask = 0xFFFFFFFF; // The collision layers with bodies, when physics activation is enabled.
+	SelfList<RTileMapQuadrant> physics_active_list_element; // In the list while some layers are active.
+
+	// Physics bodies shared by all the cells of the quadrant, when enabled. One per physics layer and constant velocities.
+	struct PhysicsBody {
+		RID body;
+		int physics_layer = 0;
+		Vector2 linear_velocity;
+		real_t angular_velocity = 0.0;
+	};
+	LocalVector<PhysicsBody> quadrant_bodies;
+	LocalVector<Ref<Shape2D>> merged_collision_shapes; // Built from the cells' polygons when merging, used by the quadrant bodies.
 
 	// Navigation.
 	Map<Vector2i, Vector<RID>> navigation_regions;
 
+	// One region per navigation layer for the whole quadrant, when merged. Invalid RIDs for empty layers.
+	Vector<RID> merged_navigation_regions;
+
 	// Scenes.
 	Map<Vector2i, String> scenes;
 
 	// Runtime TileData cache.
 	Map<Vector2i, RTileData *> runtime_tile_data_cache;
 
+	// Resolved by the compute phase of an update, then consumed by the main thread. Empty outside of updates.
+	// The indices of the modified cells, then the resolved tile and tile data of each cell (nullptr if not an atlas tile).
+	LocalVector<uint32_t> cells_to_update;
+	LocalVector<const RTileSet::TileResolution *> cells_resolution;
+	LocalVector<const RTileData *> cells_tile_data;
+	LocalVector<RenderingBatch> next_rendering_batches;
+
+	_FORCE_INLINE_ bool is_cell_dirty(const Vector2i &p_coords) const {
+		return full_update || dirty_cells.has(p_coords);
+	}
+
+	int find_cell(const Vector2i &p_coords, const Vector2i &p_world_position) const;
+	void insert_cell(const Vector2i &p_coords, const Vector2i &p_world_position);
+	void erase_cell(const Vector2i &p_coords, const Vector2i &p_world_position);
+	void sort_cells();
+
 	void operator=(const RTileMapQuadrant &q) {
 		layer = q.layer;
 		coords = q.coords;
+		dirty_cells = q.dirty_cells;
+		full_update = q.full_update;
+		dirty_aspects = q.dirty_aspects;
 		debug_canvas_item = q.debug_canvas_item;
-		canvas_items = q.canvas_items;
+		rendering_batches = q.rendering_batches;
 		occluders = q.occluders;
+		rendering_culled = q.rendering_culled;
 		bodies = q.bodies;
+		physics_active_mask = q.physics_active_mask;
+		quadrant_bodies = q.quadrant_bodies;
+		merged_collision_shapes = q.merged_collision_shapes;
 		navigation_regions = q.navigation_regions;
+		merged_navigation_regions = q.merged_navigation_regions;
 	}
 
 	RTileMapQuadrant(const RTileMapQuadrant &q) :
-			dirty_list_element(this) {
+			dirty_list_element(this),
+			animated_list_element(this),
+			rendered_list_element(this),
+			physics_active_list_element(this) {
 		layer = q.layer;
 		coords = q.coords;
+		dirty_cells = q.dirty_cells;
+		full_update = q.full_update;
+		dirty_aspects = q.dirty_aspects;
 		debug_canvas_item = q.debug_canvas_item;
-		canvas_items = q.canvas_items;
+		rendering_batches = q.rendering_batches;
 		occluders = q.occluders;
+		rendering_culled = q.rendering_culled;
 		bodies = q.bodies;
+		physics_active_mask = q.physics_active_mask;
+		quadrant_bodies = q.quadrant_bodies;
+		merged_collision_shapes = q.merged_collision_shapes;
 		navigation_regions = q.navigation_regions;
+		merged_navigation_regions = q.merged_navigation_regions;
 	}
 
 	RTileMapQuadrant() :
-			dirty_list_element(this) {
+			dirty_list_element(this),
+			animated_list_element(this),
+			rendered_list_element(this),
+			physics_active_list_element(this) {
 	}
 };
 
@@ -135,6 +223,10 @@ public:
 			return base_cell_coords;
 		}
 
+		int get_bit() const {
+			return bit;
+		}
+
 		Map<Vector2i, RTileSet::CellNeighbor> get_overlapping_coords_and_peering_bits() const;
 
 		void set_terrain(int p_terrain) {
@@ -155,6 +247,12 @@ public:
 		VISIBILITY_MODE_FORCE_HIDE,
 	};
 
+	enum TileDataCompression {
+		TILE_DATA_COMPRESSION_NONE,
+		TILE_DATA_COMPRESSION_DEFLATE,
+		TILE_DATA_COMPRESSION_ZSTD,
+	};
+
 private:
 	friend class TileSetPlugin;
 
@@ -162,7 +260,8 @@ private:
 	enum DataFormat {
 		FORMAT_1 = 0,
 		FORMAT_2,
-		FORMAT_3
+		FORMAT_3,
+		FORMAT_4 // Chunks of palette indexed cells, see RTileMapCellStorage::encode().
 	};
 	mutable DataFormat format = FORMAT_1; // Assume lowest possible format if none is present;
 
@@ -172,11 +271,27 @@ private:
 	Ref<RTileSet> tile_set;
 	int quadrant_size = 16;
 	bool collision_animatable = false;
+	bool collision_use_quadrant_bodies = false;
+	bool collision_merge_shapes = false;
+	bool use_physics_activation = false;
+	real_t physics_activation_distance = 512.0;
+	real_t physics_activation_release_distance = 768.0;
+	bool use_mesh_batching = false;
+	bool use_viewport_culling = false;
+	real_t viewport_culling_margin = 256.0;
+	real_t viewport_culling_release_margin = 512.0;
 	VisibilityMode collision_visibility_mode = VISIBILITY_MODE_DEFAULT;
 	VisibilityMode navigation_visibility_mode = VISIBILITY_MODE_DEFAULT;
+	bool navigation_merge_regions = false;
+	String pathfinding_custom_data_layer;
+	TileDataCompression tile_data_compression = TILE_DATA_COMPRESSION_NONE;
 
 	// Updates.
 	bool pending_update = false;
+	real_t update_budget_msec = 0.0;
+	int update_budget_quadrants = 0;
+	bool use_update_focus_point = false;
+	Vector2 update_focus_point;
 
 	// Rect.
 	Rect2 rect_cache;
@@ -187,6 +302,13 @@ private:
 	bool _y_sort_enabled;
 	RID _nav_map;
 
+	// Batched cells updates.
+	struct BatchedQuadrantCells {
+		Vector2i quadrant_coords;
+		LocalVector<Vector2i> cells;
+	};
+	int batch_depth = 0;
+
 	// TileMap layers.
 	struct TileMapLayer {
 		String name;
@@ -196,26 +318,94 @@ private:
 		int y_sort_origin = 0;
 		int z_index = 0;
 		RID canvas_item;
-		Map<Vector2i, RTileMapCell> tile_map;
+		RTileMapCellStorage tile_map;
+		String base_file; // Read-only cells under the ones of tile_map, which then only saves the changes.
 		Map<Vector2i, RTileMapQuadrant> quadrant_map;
 		SelfList<RTileMapQuadrant>::List dirty_quadrant_list;
+		HashMap<Vector2i, uint32_t, RTileMapCoordsHasher> batched_quadrants_indices;
+		LocalVector<BatchedQuadrantCells> batched_quadrants;
+		// The quadrants using each tile, with their number of cells using it. Built on the first tileset change.
+		Map<RTileMapCell, Map<Vector2i, int>> tiles_quadrants;
+		bool tiles_quadrants_valid = false;
 	};
 	LocalVector<TileMapLayer> layers;
 	int selected_layer = -1;
 
 	// Mapping for RID to coords.
 	Map<RID, Vector2i> bodies_coords;
+	Map<RID, LocalVector<Vector2i>> bodies_shapes_coords; // The cell of each shape, for quadrant bodies.
+
+	// Pathfinding graphs, created per layer on the first query. Released with the layers internals.
+	mutable Map<int, RTileMapPathfinding *> pathfinding_layers;
+	mutable Mutex pathfinding_mutex;
+
+	// Collision polygons of a quadrant waiting to be merged, for a body and one-way settings.
+	struct CollisionMergeGroup {
+		uint32_t body_index = 0;
+		bool one_way = false;
+		float one_way_margin = 0.0;
+		LocalVector<Vector2i> full_cells; // Cells fully covered by a square polygon.
+		Vector<Vector<Vector2>> polygons; // Other polygons, in quadrant coordinates.
+		LocalVector<Vector2i> polygons_coords;
+	};
+
+	// Server objects released by the quadrants are reset and kept for reuse, instead of being freed.
+	struct RIDPool {
+		LocalVector<RID> rids;
+		uint64_t created_count = 0;
+		uint64_t reused_count = 0;
+		uint64_t released_count = 0;
+	};
+	RIDPool canvas_item_pool;
+	RIDPool occluder_pool;
+	RIDPool body_pool;
+	RID _acquire_canvas_item();
+	void _release_canvas_item(RID p_canvas_item);
+	RID _acquire_occluder();
+	void _release_occluder(RID p_occluder);
+	RID _acquire_body();
+	void _release_body(RID p_body);
+	void _free_rid_pools();
 
 	// Quadrants and internals management.
 	Vector2i _coords_to_quadrant_coords(int p_layer, const Vector2i &p_coords) const;
+	Vector2i _get_cell_world_position(const Vector2i &p_coords) const;
 
 	Map<Vector2i, RTileMapQuadrant>::Element *_create_quadrant(int p_layer, const Vector2i &p_qk);
 
 	void _make_quadrant_dirty(Map<Vector2i, RTileMapQuadrant>::Element *Q);
+	void _make_quadrant_cell_dirty(Map<Vector2i, RTileMapQuadrant>::Element *Q, const Vector2i &p_coords, uint32_t p_aspects = RTileSet::TILE_CHANGE_ALL);
 	void _make_all_quadrants_dirty();
+	void _make_quadrant_fully_dirty(RTileMapQuadrant &r_quadrant, uint32_t p_aspects); // Only for the given subsystems.
 	void _queue_update_dirty_quadrants();
+	bool _is_internal_process_needed() const;
+
+	// Quadrants lookup by area, in local coordinates.
+	Rect2 _get_quadrant_rect(const RTileMapQuadrant &p_quadrant) const;
+	void _find_quadrants_in_rect(int p_layer, const Rect2 &p_rect, LocalVector<RTileMapQuadrant *> &r_quadrants);
 
 	void _update_dirty_quadrants();
+	void _update_quadrants(SelfList<RTileMapQuadrant>::List &r_update_list);
+
+	// Used to update the quadrants closest to the focus point first.
+	struct QuadrantUpdatePriority {
+		RTileMapQuadrant *quadrant = nullptr;
+		real_t distance_squared = 0.0;
+
+		bool operator<(const QuadrantUpdatePriority &p_other) const {
+			return distance_squared < p_other.distance_squared;
+		}
+	};
+	Vector2 _get_update_focus_point() const;
+
+	// The dirty quadrants data is resolved on worker threads, then applied to the servers on the main thread.
+	static ThreadWorkPool *quadrant_update_work_pool;
+	static ThreadWorkPool *_get_quadrant_update_work_pool(); // Also runs the pathfinding queries.
+	LocalVector<RTileMapQuadrant *> quadrant_update_list;
+	void _compute_quadrant_update(uint32_t p_index, RTileMapQuadrant **p_quadrants) const;
+
+	void _batch_cell_change(int p_layer, const Vector2i &p_coords);
+	void _flush_batched_cells();
 
 	void _recreate_layer_internals(int p_layer);
 	void _recreate_internals();
@@ -229,6 +419,9 @@ private:
 
 	// Per-system methods.
 	bool _rendering_quadrant_order_dirty = false;
+	SelfList<RTileMapQuadrant>::List animated_quadrant_list;
+	Color _rendering_get_layer_modulate(int p_layer) const;
+	void _rendering_draw_animated_batch(const RTileMapQuadrant &p_quadrant, RTileMapQuadrant::RenderingBatch &r_batch, const Color &p_modulation);
 	void _rendering_notification(int p_what);
 	void _rendering_update_layer(int p_layer);
 	void _rendering_cleanup_layer(int p_layer);
@@ -237,28 +430,82 @@ private:
 	void _rendering_cleanup_quadrant(RTileMapQuadrant *p_quadrant);
 	void _rendering_draw_quadrant_debug(RTileMapQuadrant *p_quadrant);
 
+	// Viewport culling, only the quadrants near the viewport get canvas items and occluders.
+	// They are created within the margin around the viewport, and released beyond the release margin.
+	SelfList<RTileMapQuadrant>::List rendered_quadrant_list;
+	Rect2 viewport_culling_rect;
+	bool viewport_culling_dirty = true;
+	Rect2 _rendering_get_visible_rect() const;
+	void _rendering_uncull_quadrant(RTileMapQuadrant &r_quadrant);
+	void _rendering_update_culling();
+
+	// Mesh batching, consecutive tiles sharing a texture are submitted as a single triangle array.
+	// Submissions are capped so they fit in the default canvas polygon buffer.
+	static constexpr int TILE_MESH_MAX_TILES = 512;
+	struct TileMesh {
+		RID texture;
+		Vector2 texture_pixel_size;
+		Vector<int> indices;
+		Vector<Vector2> points;
+		Vector<Color> colors;
+		Vector<Vector2> uvs;
+	};
+	void _rendering_draw_batch_mesh(const RTileMapQuadrant &p_quadrant, const RTileMapQuadrant::RenderingBatch &p_batch, const Color &p_modulation);
+	static void _rendering_flush_tile_mesh(RID p_canvas_item, TileMesh &r_mesh);
+
 	Transform2D last_valid_transform;
 	Transform2D new_transform;
 	void _physics_notification(int p_what);
 	void _physics_update_dirty_quadrants(SelfList<RTileMapQuadrant>::List &r_dirty_quadrant_list);
 	void _physics_cleanup_quadrant(RTileMapQuadrant *p_quadrant);
+	void _physics_update_quadrant_bodies(RTileMapQuadrant &r_quadrant, const Transform2D &p_global_transform);
+	void _physics_add_merged_shapes(RTileMapQuadrant &r_quadrant, const CollisionMergeGroup &p_group, const Vector2 &p_quadrant_position);
+	void _physics_release_quadrant_bodies(RTileMapQuadrant &r_quadrant);
+	void _physics_set_bodies_transform(const Transform2D &p_global_transform);
 	void _physics_draw_quadrant_debug(RTileMapQuadrant *p_quadrant);
+	void _physics_draw_body_debug(RID p_canvas_item, RID p_body, const Transform2D &p_global_transform_inv, const Vector<Color> &p_color);
+
+	// Physics activation, bodies only exist near the activators, for the collision layers in their masks.
+	// Layers are activated within the activation distance, and released beyond the release distance.
+	// Physics layers without collision layer (only detecting others) match any activator.
+	struct PhysicsActivator {
+		ObjectID node_id = 0;
+		uint32_t collision_mask = 0xFFFFFFFF;
+		Vector2 position; // Local, as of the last activation update.
+	};
+	LocalVector<PhysicsActivator> physics_activators;
+	SelfList<RTileMapQuadrant>::List physics_active_quadrant_list;
+	bool physics_activation_dirty = true;
+	_FORCE_INLINE_ bool _physics_is_layer_active(const RTileMapQuadrant &p_quadrant, int p_tile_set_physics_layer) const {
+		if (!use_physics_activation) {
+			return true;
+		}
+		uint32_t collision_layer = tile_set->get_physics_layer_collision_layer(p_tile_set_physics_layer);
+		return p_quadrant.physics_active_mask && (collision_layer == 0 || (collision_layer & p_quadrant.physics_active_mask));
+	}
+	void _physics_set_quadrant_active_mask(RTileMapQuadrant &r_quadrant, uint32_t p_mask);
+	void _physics_update_activation();
 
 	void _navigation_notification(int p_what);
 	void _navigation_update_dirty_quadrants(SelfList<RTileMapQuadrant>::List &r_dirty_quadrant_list);
+	void _navigation_free_cell_regions(const Vector<RID> &p_regions);
+	void _navigation_update_quadrant_merged_regions(RTileMapQuadrant &r_quadrant, const Transform2D &p_global_transform);
 	void _navigation_cleanup_quadrant(RTileMapQuadrant *p_quadrant);
 	void _navigation_draw_quadrant_debug(RTileMapQuadrant *p_quadrant);
 
+	RTileMapPathfinding *_pathfinding_get_layer(int p_layer) const;
+	void _pathfinding_make_cell_dirty(int p_layer, const Vector2i &p_coords);
+	void _pathfinding_clear_layer(int p_layer);
+
 	void _scenes_update_dirty_quadrants(SelfList<RTileMapQuadrant>::List &r_dirty_quadrant_list);
 	void _scenes_cleanup_quadrant(RTileMapQuadrant *p_quadrant);
 	void _scenes_draw_quadrant_debug(RTileMapQuadrant *p_quadrant);
 
-	// Terrains.
-	Set<RTileSet::TerrainsPattern> _get_valid_terrains_patterns_for_constraints(int p_terrain_set, const Vector2i &p_position, Set<TerrainConstraint> p_constraints);
-
 	// Set and get tiles from data arrays.
 	void _set_tile_data(int p_layer, const Vector<int> &p_data);
 	Vector<int> _get_tile_data(int p_layer) const;
+	void _set_tile_data_chunks(int p_layer, const Vector<uint8_t> &p_data);
+	Vector<uint8_t> _get_tile_data_chunks(int p_layer) const;
 
 	void _build_runtime_update_tile_data(SelfList<RTileMapQuadrant>::List &r_dirty_quadrant_list);
 
@@ -266,6 +513,38 @@ private:
 	bool _tile_set_changed_deferred_update_needed = false;
 	void _tile_set_changed_deferred_update();
 
+	// Updates only the cells using the tiles changed in the TileSet, when it logged which ones.
+	uint64_t tile_set_changes_version = 0;
+	void _tiles_quadrants_add(int p_layer, const RTileMapCell &p_cell, const Vector2i &p_coords, int p_count);
+	void _tiles_quadrants_build(int p_layer);
+	void _make_changed_tiles_dirty(const LocalVector<RTileSet::TileChange> &p_changes);
+
+	// Streaming, the cells are read from region files around the focus point, and written back when evicted.
+	// A region covers streaming_region_size * streaming_region_size quadrants.
+	String streaming_directory;
+	int streaming_region_size = 4;
+	real_t streaming_load_distance = 1024.0;
+	real_t streaming_unload_distance = 1536.0;
+	struct StreamedRegion {
+		bool loaded = false; // Otherwise waiting for the streamer.
+		bool dirty = false; // Cells changed since the region was read.
+		Map<int, Set<Vector2i>> pending_cells; // Per layer, the cells set or erased while the region is read, kept over the region file.
+	};
+	RTileMapRegionStreamer *streamer = nullptr;
+	Map<Vector2i, StreamedRegion> streamed_regions;
+	bool streaming_updating_cells = false;
+	void _streaming_start();
+	void _streaming_stop();
+	void _streaming_update();
+	Vector2i _streaming_get_region_coords(const Vector2i &p_coords) const;
+	Rect2i _streaming_get_region_cells(const Vector2i &p_region) const;
+	real_t _streaming_get_region_distance(const Vector2i &p_region, const Vector2 &p_point) const;
+	void _streaming_make_cell_dirty(int p_layer, const Vector2i &p_coords);
+	void _streaming_integrate_regions();
+	void _streaming_save_region(const Vector2i &p_region);
+	void _streaming_evict_region(const Vector2i &p_region);
+	int _get_tile_data_compression_mode() const;
+
 protected:
 	bool _set(const StringName &p_name, const Variant &p_value);
 	bool _get(const StringName &p_name, Variant &r_ret) const;
@@ -275,6 +554,8 @@ protected:
 	static void _bind_methods();
 
 public:
+	static void finish_quadrant_update_work_pool();
+
 	static Vector2i transform_coords_layout(Vector2i p_coords, RTileSet::TileOffsetAxis p_offset_axis, RTileSet::TileLayout p_from_layout, RTileSet::TileLayout p_to_layout);
 
 	enum {
@@ -291,6 +572,8 @@ public:
 	void set_quadrant_size(int p_size);
 	int get_quadrant_size() const;
 
+	// Shared by all the tile maps, so their animations stay in sync.
+	static double get_animation_time();
 	static void draw_tile(RID p_canvas_item, Vector2i p_position, const Ref<RTileSet> p_tile_set, int p_atlas_source_id, Vector2i p_atlas_coords, int p_alternative_tile, int p_frame = -1, Color p_modulation = Color(1.0, 1.0, 1.0, 1.0), const RTileData *p_tile_data_override = nullptr);
 
 	// Layers management.
@@ -310,12 +593,51 @@ public:
 	int get_layer_y_sort_origin(int p_layer) const;
 	void set_layer_z_index(int p_layer, int p_z_index);
 	int get_layer_z_index(int p_layer) const;
+	void set_layer_base_file(int p_layer, const String &p_path);
+	String get_layer_base_file(int p_layer) const;
+	Error save_layer_base_file(int p_layer, const String &p_path) const;
 	void set_selected_layer(int p_layer_id); // For editor use.
 	int get_selected_layer() const;
 
 	void set_collision_animatable(bool p_enabled);
 	bool is_collision_animatable() const;
 
+	void set_collision_use_quadrant_bodies(bool p_use_quadrant_bodies);
+	bool is_collision_using_quadrant_bodies() const;
+
+	void set_collision_merge_shapes(bool p_merge_shapes);
+	bool is_collision_merging_shapes() const;
+
+	void set_use_mesh_batching(bool p_use_mesh_batching);
+	bool is_using_mesh_batching() const;
+
+	void set_use_physics_activation(bool p_use_physics_activation);
+	bool is_using_physics_activation() const;
+	void set_physics_activation_distance(real_t p_distance);
+	real_t get_physics_activation_distance() const;
+	void set_physics_activation_release_distance(real_t p_distance);
+	real_t get_physics_activation_release_distance() const;
+	void add_physics_activator(Node2D *p_node, uint32_t p_collision_mask = 0xFFFFFFFF);
+	void remove_physics_activator(Node2D *p_node);
+	Array get_physics_activators() const;
+
+	void set_use_viewport_culling(bool p_use_viewport_culling);
+	bool is_using_viewport_culling() const;
+	void set_viewport_culling_margin(real_t p_margin);
+	real_t get_viewport_culling_margin() const;
+	void set_viewport_culling_release_margin(real_t p_margin);
+	real_t get_viewport_culling_release_margin() const;
+
+	// Dirty quadrants updates budget, spread over several frames when exceeded.
+	void set_update_budget_msec(real_t p_budget_msec);
+	real_t get_update_budget_msec() const;
+	void set_update_budget_quadrants(int p_budget_quadrants);
+	int get_update_budget_quadrants() const;
+	void set_use_update_focus_point(bool p_use_update_focus_point);
+	bool is_using_update_focus_point() const;
+	void set_update_focus_point(const Vector2 &p_update_focus_point);
+	Vector2 get_update_focus_point() const;
+
 	// Debug visibility modes.
 	void set_collision_visibility_mode(VisibilityMode p_show_collision);
 	VisibilityMode get_collision_visibility_mode();
@@ -323,12 +645,36 @@ public:
 	void set_navigation_visibility_mode(VisibilityMode p_show_navigation);
 	VisibilityMode get_navigation_visibility_mode();
 
+	void set_navigation_merge_regions(bool p_merge_regions);
+	bool is_navigation_merging_regions() const;
+
+	void set_tile_data_compression(TileDataCompression p_compression);
+	TileDataCompression get_tile_data_compression() const;
+
+	// Streaming from region files, enabled by setting a directory. Distances are in local coordinates.
+	void set_streaming_directory(const String &p_directory);
+	String get_streaming_directory() const;
+	void set_streaming_region_size(int p_size);
+	int get_streaming_region_size() const;
+	void set_streaming_load_distance(real_t p_distance);
+	real_t get_streaming_load_distance() const;
+	void set_streaming_unload_distance(real_t p_distance);
+	real_t get_streaming_unload_distance() const;
+	bool is_streaming() const;
+	void save_streamed_regions(); // Writes the edited regions still loaded, and waits for the files to be written.
+
 	// Cells accessors.
 	void set_cell(int p_layer, const Vector2 &p_coords, int p_source_id = -1, const Vector2 p_atlas_coords = RTileSetSource::INVALID_ATLAS_COORDSV, int p_alternative_tile = RTileSetSource::INVALID_TILE_ALTERNATIVE);
+	void set_cells(int p_layer, const PoolVector2Array &p_coords_array, const PoolIntArray &p_packed_cells);
 	int get_cell_source_id(int p_layer, const Vector2 &p_coords, bool p_use_proxies = false) const;
 	Vector2 get_cell_atlas_coords(int p_layer, const Vector2 &p_coords, bool p_use_proxies = false) const;
 	int get_cell_alternative_tile(int p_layer, const Vector2 &p_coords, bool p_use_proxies = false) const;
 
+	// Batching, quadrants are only updated once the outermost batch ends.
+	void begin_batch();
+	void end_batch();
+	bool is_batching() const;
+
 	// Patterns.
 	Ref<RTileMapPattern> get_pattern(int p_layer, Vector<Vector2> p_coords_array);
 	Vector2 map_pattern(Vector2 p_position_in_tilemap, Vector2 p_coords_in_pattern, Ref<RTileMapPattern> p_pattern);
@@ -337,8 +683,8 @@ public:
 	// Terrains.
 	Set<TerrainConstraint> get_terrain_constraints_from_removed_cells_list(int p_layer, const Set<Vector2i> &p_to_replace, int p_terrain_set, bool p_ignore_empty_terrains = true) const; // Not exposed.
 	Set<TerrainConstraint> get_terrain_constraints_from_added_tile(Vector2i p_position, int p_terrain_set, RTileSet::TerrainsPattern p_terrains_pattern) const; // Not exposed.
-	Map<Vector2i, RTileSet::TerrainsPattern> terrain_wave_function_collapse(const Set<Vector2i> &p_to_replace, int p_terrain_set, const Set<TerrainConstraint> p_constraints); // Not exposed.
-	void set_cells_from_surrounding_terrains(int p_layer, Vector<Vector2> p_coords_array, int p_terrain_set, bool p_ignore_empty_terrains = true);
+	Map<Vector2i, RTileSet::TerrainsPattern> terrain_wave_function_collapse(const Set<Vector2i> &p_to_replace, int p_terrain_set, const Set<TerrainConstraint> p_constraints, RandomPCG *p_rng = nullptr); // Not exposed.
+	void set_cells_from_surrounding_terrains(int p_layer, Vector<Vector2> p_coords_array, int p_terrain_set, bool p_ignore_empty_terrains = true, int64_t p_seed = -1);
 
 	// Not exposed to users
 	RTileMapCell get_cell(int p_layer, const Vector2i &p_coords, bool p_use_proxies = false) const;
@@ -358,6 +704,14 @@ public:
 	Vector<Vector2> get_used_cells(int p_layer) const;
 	Rect2 get_used_rect(); // Not const because of cache
 
+	// Pathfinding. Cells are walkable if the custom data layer holds true or a positive cost, or if they have a navigation polygon when no layer is set.
+	void set_pathfinding_custom_data_layer(const String &p_layer_name);
+	String get_pathfinding_custom_data_layer() const;
+	PoolVector2Array find_path(int p_layer, const Vector2 &p_from, const Vector2 &p_to) const;
+	Array find_paths(int p_layer, const PoolVector2Array &p_from, const PoolVector2Array &p_to) const; // Runs on worker threads.
+	PoolByteArray get_flow_field(int p_layer, const Rect2 &p_region, const PoolVector2Array &p_goals) const; // The CellNeighbor to move to, per cell of the region, row by row.
+	PoolRealArray get_flow_field_integration(int p_layer, const Rect2 &p_region, const PoolVector2Array &p_goals) const;
+
 	// Override some methods of the CanvasItem class to pass the changes to the quadrants CanvasItems
 	virtual void set_light_mask(int p_light_mask) override;
 	virtual void set_material(const Ref<Material> &p_material) override;
@@ -367,6 +721,7 @@ public:
 
 	// For finding tiles from collision.
 	Vector2 get_coords_for_body_rid(RID p_physics_body);
+	Vector2 get_coords_for_body_shape(RID p_physics_body, int p_body_shape_index);
 
 	// Fixing a nclearing methods.
 	void fix_invalid_tiles();
@@ -377,6 +732,10 @@ public:
 
 	// Force a TileMap update
 	void force_update(int p_layer = -1);
+	void flush_dirty_quadrants();
+
+	// Reuse statistics of the pooled server objects.
+	Dictionary get_rid_pools_statistics() const;
 
 	// Helpers?
 	Vector<Vector2> get_surrounding_tiles(Vector2 coords);
@@ -394,5 +753,6 @@ public:
 };
 
 VARIANT_ENUM_CAST(RTileMap::VisibilityMode);
+VARIANT_ENUM_CAST(RTileMap::TileDataCompression);
 
 #endif // TILE_MAP_H
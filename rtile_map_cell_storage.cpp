@@ -0,0 +1,702 @@
+/*************************************************************************/
+/*  rtile_map_cell_storage.cpp                                           */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#include "rtile_map_cell_storage.h"
+
+#include "core/io/compression.h"
+#include "core/io/marshalls.h"
+#include "core/os/file_access.h"
+#include "core/project_settings.h"
+#include "core/sort_array.h"
+
+#ifdef UNIX_ENABLED
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// A read-only file, memory mapped when the platform supports it, otherwise read into memory.
+// Files in a resources pack cannot be mapped, they are read as well.
+class RTileMapMappedFile {
+	const uint8_t *data = nullptr;
+	uint64_t size = 0;
+	bool mapped = false;
+	Vector<uint8_t> buffer;
+
+public:
+	Error open(const String &p_path) {
+		close();
+
+#ifdef UNIX_ENABLED
+		String path = ProjectSettings::get_singleton()->globalize_path(p_path);
+		int fd = ::open(path.utf8().get_data(), O_RDONLY);
+		if (fd >= 0) {
+			struct stat st;
+			if (fstat(fd, &st) == 0 && st.st_size > 0) {
+				void *ptr = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+				if (ptr != MAP_FAILED) {
+					data = (const uint8_t *)ptr;
+					size = st.st_size;
+					mapped = true;
+				}
+			}
+			::close(fd); // The mapping keeps its own reference to the file.
+			if (mapped) {
+				return OK;
+			}
+		}
+#endif
+
+		Error err;
+		buffer = FileAccess::get_file_as_array(p_path, &err);
+		ERR_FAIL_COND_V_MSG(err != OK, err, vformat("Cannot open TileMap base file: %s.", p_path));
+		data = buffer.ptr();
+		size = buffer.size();
+		return OK;
+	}
+
+	void close() {
+#ifdef UNIX_ENABLED
+		if (mapped) {
+			munmap((void *)data, size);
+		}
+#endif
+		data = nullptr;
+		size = 0;
+		mapped = false;
+		buffer = Vector<uint8_t>();
+	}
+
+	const uint8_t *get_data() const { return data; }
+	uint64_t get_size() const { return size; }
+	bool is_mapped() const { return mapped; }
+
+	~RTileMapMappedFile() {
+		close();
+	}
+};
+
+RTileMapCellStorage::Chunk *RTileMapCellStorage::_get_chunk(const Vector2i &p_chunk_coords) const {
+	const uint32_t *index = chunks_indices.getptr(p_chunk_coords);
+	if (!index) {
+		return nullptr;
+	}
+	return chunks[*index];
+}
+
+RTileMapCellStorage::Chunk *RTileMapCellStorage::_create_chunk(const Vector2i &p_chunk_coords) {
+	Chunk *chunk = memnew(Chunk);
+	chunk->coords = p_chunk_coords;
+	chunk->owned_data = memnew(ChunkData);
+	chunk->occupancy = chunk->owned_data->occupancy;
+	chunk->cells = chunk->owned_data->cells;
+	_add_chunk(chunk);
+	return chunk;
+}
+
+void RTileMapCellStorage::_add_chunk(Chunk *p_chunk) {
+	chunks_indices.set(p_chunk->coords, chunks.size());
+	chunks.push_back(p_chunk);
+}
+
+void RTileMapCellStorage::_erase_chunk(const Vector2i &p_chunk_coords) {
+	const uint32_t *index_ptr = chunks_indices.getptr(p_chunk_coords);
+	ERR_FAIL_COND(!index_ptr);
+	uint32_t index = *index_ptr;
+
+	memdelete(chunks[index]);
+	chunks_indices.erase(p_chunk_coords);
+
+	// Swap with the last chunk to keep the list contiguous.
+	uint32_t last = chunks.size() - 1;
+	if (index != last) {
+		chunks[index] = chunks[last];
+		chunks_indices.set(chunks[index]->coords, index);
+	}
+	chunks.resize(last);
+}
+
+RTileMapCellStorage::ChunkData *RTileMapCellStorage::_get_writable_data(Chunk *p_chunk) {
+	if (!p_chunk->owned_data) {
+		// Copy on write, the chunk leaves the mapped base for the overlay.
+		ChunkData *data = memnew(ChunkData);
+		memcpy(data->occupancy, p_chunk->occupancy, sizeof(data->occupancy));
+		memcpy(data->cells, p_chunk->cells, sizeof(data->cells));
+		p_chunk->owned_data = data;
+		p_chunk->occupancy = data->occupancy;
+		p_chunk->cells = data->cells;
+	}
+	p_chunk->in_base = false;
+	return p_chunk->owned_data;
+}
+
+void RTileMapCellStorage::_get_sorted_chunks(LocalVector<const Chunk *> &r_chunks) const {
+	r_chunks.resize(chunks.size());
+	for (uint32_t i = 0; i < chunks.size(); i++) {
+		r_chunks[i] = chunks[i];
+	}
+	SortArray<const Chunk *, ChunkCoordsComparator> sorter;
+	sorter.sort(r_chunks.ptr(), r_chunks.size());
+}
+
+const RTileMapCell *RTileMapCellStorage::get_cell(const Vector2i &p_coords) const {
+	const Chunk *chunk = _get_chunk(get_chunk_coords(p_coords));
+	if (!chunk) {
+		return nullptr;
+	}
+	uint32_t index = get_index_in_chunk(p_coords);
+	if (!chunk->is_used(index)) {
+		return nullptr;
+	}
+	return &chunk->cells[index];
+}
+
+RTileMapCell *RTileMapCellStorage::get_cell_ptr(const Vector2i &p_coords) {
+	Chunk *chunk = _get_chunk(get_chunk_coords(p_coords));
+	if (!chunk) {
+		return nullptr;
+	}
+	uint32_t index = get_index_in_chunk(p_coords);
+	if (!chunk->is_used(index)) {
+		return nullptr;
+	}
+	return &_get_writable_data(chunk)->cells[index];
+}
+
+bool RTileMapCellStorage::has_cell(const Vector2i &p_coords) const {
+	return get_cell(p_coords) != nullptr;
+}
+
+RTileMapCell *RTileMapCellStorage::insert_cell(const Vector2i &p_coords, const RTileMapCell &p_cell) {
+	Vector2i chunk_coords = get_chunk_coords(p_coords);
+	Chunk *chunk = _get_chunk(chunk_coords);
+	if (!chunk) {
+		chunk = _create_chunk(chunk_coords);
+	}
+
+	ChunkData *data = _get_writable_data(chunk);
+	uint32_t index = get_index_in_chunk(p_coords);
+	if (!chunk->is_used(index)) {
+		data->occupancy[index >> 6] |= uint64_t(1) << (index & 63);
+		chunk->used_count++;
+		cells_count++;
+	}
+	data->cells[index] = p_cell;
+	return &data->cells[index];
+}
+
+bool RTileMapCellStorage::erase_cell(const Vector2i &p_coords) {
+	Vector2i chunk_coords = get_chunk_coords(p_coords);
+	Chunk *chunk = _get_chunk(chunk_coords);
+	if (!chunk) {
+		return false;
+	}
+
+	uint32_t index = get_index_in_chunk(p_coords);
+	if (!chunk->is_used(index)) {
+		return false;
+	}
+
+	if (chunk->used_count == 1) {
+		// Last cell, no need to copy the chunk out of the base.
+		cells_count--;
+		_erase_chunk(chunk_coords);
+		return true;
+	}
+
+	ChunkData *data = _get_writable_data(chunk);
+	data->occupancy[index >> 6] &= ~(uint64_t(1) << (index & 63));
+	data->cells[index] = RTileMapCell();
+	chunk->used_count--;
+	cells_count--;
+	return true;
+}
+
+void RTileMapCellStorage::clear() {
+	for (uint32_t i = 0; i < chunks.size(); i++) {
+		memdelete(chunks[i]);
+	}
+	chunks.clear();
+	chunks_indices.clear();
+	cells_count = 0;
+
+	if (base_file) {
+		memdelete(base_file);
+		base_file = nullptr;
+	}
+	base_chunks_coords.clear();
+	base_opened = false;
+}
+
+void RTileMapCellStorage::set_chunk(const Vector2i &p_chunk_coords, const uint64_t *p_occupancy, const RTileMapCell *p_cells) {
+	uint32_t used_count = 0;
+	for (int i = 0; i < CHUNK_OCCUPANCY_WORDS; i++) {
+		for (uint64_t word = p_occupancy[i]; word; word &= word - 1) {
+			used_count++;
+		}
+	}
+
+	Chunk *chunk = _get_chunk(p_chunk_coords);
+	if (chunk) {
+		cells_count -= chunk->used_count;
+		if (used_count == 0) {
+			_erase_chunk(p_chunk_coords);
+			return;
+		}
+	} else {
+		if (used_count == 0) {
+			return;
+		}
+		chunk = _create_chunk(p_chunk_coords);
+	}
+
+	ChunkData *data = _get_writable_data(chunk);
+	for (int i = 0; i < CHUNK_OCCUPANCY_WORDS; i++) {
+		data->occupancy[i] = p_occupancy[i];
+	}
+	for (uint32_t i = 0; i < CHUNK_CELLS_COUNT; i++) {
+		data->cells[i] = chunk->is_used(i) ? p_cells[i] : RTileMapCell();
+	}
+	chunk->used_count = used_count;
+	cells_count += used_count;
+}
+
+void RTileMapCellStorage::get_sorted_cells(LocalVector<Vector2i> &r_coords) const {
+	LocalVector<const Chunk *> sorted_chunks;
+	_get_sorted_chunks(sorted_chunks);
+
+	r_coords.clear();
+	r_coords.reserve(cells_count);
+
+	// Coords are sorted by x then y, so each column of chunks is walked one column of cells at a time.
+	uint32_t column_begin = 0;
+	while (column_begin < sorted_chunks.size()) {
+		uint32_t column_end = column_begin + 1;
+		while (column_end < sorted_chunks.size() && sorted_chunks[column_end]->coords.x == sorted_chunks[column_begin]->coords.x) {
+			column_end++;
+		}
+		for (uint32_t x = 0; x < CHUNK_SIZE; x++) {
+			for (uint32_t chunk_index = column_begin; chunk_index < column_end; chunk_index++) {
+				const Chunk *chunk = sorted_chunks[chunk_index];
+				for (uint32_t y = 0; y < CHUNK_SIZE; y++) {
+					uint32_t index = y << CHUNK_SHIFT | x;
+					if (chunk->is_used(index)) {
+						r_coords.push_back(chunk->get_cell_coords(index));
+					}
+				}
+			}
+		}
+		column_begin = column_end;
+	}
+}
+
+Rect2i RTileMapCellStorage::get_used_rect() const {
+	Rect2i rect;
+	bool first = true;
+	for (uint32_t chunk_index = 0; chunk_index < chunks.size(); chunk_index++) {
+		const Chunk *chunk = chunks[chunk_index];
+
+		// Skip chunks that cannot grow the rect.
+		if (!first) {
+			Vector2i chunk_begin = chunk->coords * CHUNK_SIZE;
+			Vector2i chunk_end = chunk_begin + Vector2i(CHUNK_SIZE - 1, CHUNK_SIZE - 1);
+			Vector2i rect_end = rect.position + rect.size;
+			if (chunk_begin.x >= rect.position.x && chunk_begin.y >= rect.position.y && chunk_end.x <= rect_end.x && chunk_end.y <= rect_end.y) {
+				continue;
+			}
+		}
+
+		for (uint32_t i = 0; i < CHUNK_CELLS_COUNT; i++) {
+			if (!chunk->is_used(i)) {
+				continue;
+			}
+			Vector2i coords = chunk->get_cell_coords(i);
+			if (first) {
+				rect = Rect2i(coords, Vector2i());
+				first = false;
+			} else {
+				rect.expand_to(coords);
+			}
+		}
+	}
+	return rect;
+}
+
+// Layout, little endian:
+// - Header: uint8 chunk shift, uint8 compression mode (0xFF if none), uint16 reserved, uint32 chunks count.
+// - Per chunk: int32 chunk x, int32 chunk y, uint32 raw size, uint32 stored size, then the stored block.
+// - Raw block: uint16 palette size, the palette cells (uint16 source, int16 atlas x, int16 atlas y, uint16 alternative),
+//   the occupancy bitmap, then one palette index per used cell in chunk order (uint8, or uint16 for palettes over 256 cells).
+// A chunk without cells erases the chunk of the base file.
+static const int ENCODED_HEADER_SIZE = 8;
+static const int ENCODED_CHUNK_HEADER_SIZE = 16;
+static const int ENCODED_CELL_SIZE = 8;
+static const uint8_t ENCODED_NO_COMPRESSION = 0xFF;
+
+Vector<uint8_t> RTileMapCellStorage::encode(int p_compression_mode) const {
+	ERR_FAIL_COND_V(p_compression_mode < -1 || p_compression_mode > Compression::MODE_GZIP, Vector<uint8_t>());
+
+	// Only the changes to the base file are encoded, in coords order so the same cells give the same data.
+	LocalVector<const Chunk *> sorted_chunks;
+	_get_sorted_chunks(sorted_chunks);
+	LocalVector<const Chunk *> encoded_chunks;
+	for (uint32_t chunk_index = 0; chunk_index < sorted_chunks.size(); chunk_index++) {
+		if (!sorted_chunks[chunk_index]->in_base) {
+			encoded_chunks.push_back(sorted_chunks[chunk_index]);
+		}
+	}
+	LocalVector<Vector2i> erased_chunks;
+	for (uint32_t i = 0; i < base_chunks_coords.size(); i++) {
+		if (!chunks_indices.has(base_chunks_coords[i])) {
+			erased_chunks.push_back(base_chunks_coords[i]);
+		}
+	}
+
+	Vector<uint8_t> data;
+	data.resize(ENCODED_HEADER_SIZE);
+	uint8_t *w = data.ptrw();
+	w[0] = CHUNK_SHIFT;
+	w[1] = p_compression_mode < 0 ? ENCODED_NO_COMPRESSION : uint8_t(p_compression_mode);
+	encode_uint16(0, &w[2]);
+	encode_uint32(encoded_chunks.size() + erased_chunks.size(), &w[4]);
+
+	LocalVector<RTileMapCell> palette;
+	HashMap<uint64_t, uint16_t> palette_indices;
+	LocalVector<uint16_t> indices;
+	Vector<uint8_t> raw;
+	Vector<uint8_t> compressed;
+	const uint64_t empty_occupancy[CHUNK_OCCUPANCY_WORDS] = {};
+	for (uint32_t chunk_index = 0; chunk_index < encoded_chunks.size() + erased_chunks.size(); chunk_index++) {
+		const Chunk *chunk = chunk_index < encoded_chunks.size() ? encoded_chunks[chunk_index] : nullptr;
+		Vector2i chunk_coords = chunk ? chunk->coords : erased_chunks[chunk_index - encoded_chunks.size()];
+		const uint64_t *occupancy = chunk ? chunk->occupancy : empty_occupancy;
+
+		// Index the distinct cells of the chunk.
+		palette.clear();
+		palette_indices.clear();
+		indices.clear();
+		for (uint32_t i = 0; i < CHUNK_CELLS_COUNT; i++) {
+			if (!(occupancy[i >> 6] & (uint64_t(1) << (i & 63)))) {
+				continue;
+			}
+			const uint16_t *index = palette_indices.getptr(chunk->cells[i]._u64t);
+			if (!index) {
+				palette_indices.set(chunk->cells[i]._u64t, palette.size());
+				index = palette_indices.getptr(chunk->cells[i]._u64t);
+				palette.push_back(chunk->cells[i]);
+			}
+			indices.push_back(*index);
+		}
+		int index_size = palette.size() > 256 ? 2 : 1;
+
+		raw.resize(2 + palette.size() * ENCODED_CELL_SIZE + CHUNK_OCCUPANCY_WORDS * 8 + indices.size() * index_size);
+		uint8_t *r = raw.ptrw();
+		int offset = 0;
+		offset += encode_uint16(palette.size(), &r[offset]);
+		for (uint32_t i = 0; i < palette.size(); i++) {
+			offset += encode_uint16(palette[i].source_id, &r[offset]);
+			offset += encode_uint16(palette[i].coord_x, &r[offset]);
+			offset += encode_uint16(palette[i].coord_y, &r[offset]);
+			offset += encode_uint16(palette[i].alternative_tile, &r[offset]);
+		}
+		for (int i = 0; i < CHUNK_OCCUPANCY_WORDS; i++) {
+			offset += encode_uint64(occupancy[i], &r[offset]);
+		}
+		for (uint32_t i = 0; i < indices.size(); i++) {
+			if (index_size == 2) {
+				offset += encode_uint16(indices[i], &r[offset]);
+			} else {
+				r[offset++] = indices[i];
+			}
+		}
+
+		const uint8_t *stored = r;
+		int stored_size = raw.size();
+		if (p_compression_mode >= 0) {
+			compressed.resize(Compression::get_max_compressed_buffer_size(raw.size(), Compression::Mode(p_compression_mode)));
+			stored_size = Compression::compress(compressed.ptrw(), raw.ptr(), raw.size(), Compression::Mode(p_compression_mode));
+			ERR_FAIL_COND_V(stored_size < 0, Vector<uint8_t>());
+			stored = compressed.ptr();
+		}
+
+		int chunk_offset = data.size();
+		data.resize(chunk_offset + ENCODED_CHUNK_HEADER_SIZE + stored_size);
+		w = data.ptrw() + chunk_offset;
+		encode_uint32(uint32_t(chunk_coords.x), &w[0]);
+		encode_uint32(uint32_t(chunk_coords.y), &w[4]);
+		encode_uint32(raw.size(), &w[8]);
+		encode_uint32(stored_size, &w[12]);
+		memcpy(&w[ENCODED_CHUNK_HEADER_SIZE], stored, stored_size);
+	}
+
+	return data;
+}
+
+Error RTileMapCellStorage::decode(const Vector<uint8_t> &p_data) {
+	ERR_FAIL_COND_V_MSG(p_data.size() < ENCODED_HEADER_SIZE, ERR_INVALID_DATA, "Corrupted tile data.");
+	const uint8_t *r = p_data.ptr();
+	int chunk_shift = r[0];
+	int compression_mode = r[1] == ENCODED_NO_COMPRESSION ? -1 : r[1];
+	uint32_t chunks_count = decode_uint32(&r[4]);
+	ERR_FAIL_COND_V_MSG(chunk_shift > 7 || compression_mode > Compression::MODE_GZIP, ERR_INVALID_DATA, "Corrupted tile data.");
+
+	int chunk_size = 1 << chunk_shift;
+	int chunk_cells_count = chunk_size * chunk_size;
+	int occupancy_words = (chunk_cells_count + 63) / 64;
+	// A full palette and 16 bits indices, the largest block a chunk can be saved into.
+	int max_raw_size = 2 + chunk_cells_count * ENCODED_CELL_SIZE + occupancy_words * 8 + chunk_cells_count * 2;
+
+	LocalVector<uint64_t> occupancy;
+	LocalVector<RTileMapCell> cells;
+	LocalVector<RTileMapCell> palette;
+	occupancy.resize(occupancy_words);
+	cells.resize(chunk_cells_count);
+	Vector<uint8_t> decompressed;
+
+	int offset = ENCODED_HEADER_SIZE;
+	for (uint32_t chunk_index = 0; chunk_index < chunks_count; chunk_index++) {
+		ERR_FAIL_COND_V_MSG(offset + ENCODED_CHUNK_HEADER_SIZE > p_data.size(), ERR_INVALID_DATA, "Corrupted tile data.");
+		Vector2i chunk_coords = Vector2i(int32_t(decode_uint32(&r[offset])), int32_t(decode_uint32(&r[offset + 4])));
+		int raw_size = decode_uint32(&r[offset + 8]);
+		int stored_size = decode_uint32(&r[offset + 12]);
+		offset += ENCODED_CHUNK_HEADER_SIZE;
+		ERR_FAIL_COND_V_MSG(raw_size < 2 || raw_size > max_raw_size || stored_size < 0 || offset + stored_size > p_data.size(), ERR_INVALID_DATA, "Corrupted tile data.");
+
+		const uint8_t *block = &r[offset];
+		offset += stored_size;
+		if (compression_mode >= 0) {
+			decompressed.resize(raw_size);
+			int size = Compression::decompress(decompressed.ptrw(), raw_size, block, stored_size, Compression::Mode(compression_mode));
+			ERR_FAIL_COND_V_MSG(size != raw_size, ERR_INVALID_DATA, "Corrupted tile data.");
+			block = decompressed.ptr();
+		} else {
+			ERR_FAIL_COND_V_MSG(raw_size != stored_size, ERR_INVALID_DATA, "Corrupted tile data.");
+		}
+
+		// Palette.
+		int block_offset = 0;
+		uint32_t palette_size = decode_uint16(&block[block_offset]);
+		block_offset += 2;
+		int index_size = palette_size > 256 ? 2 : 1;
+		ERR_FAIL_COND_V_MSG(block_offset + int(palette_size) * ENCODED_CELL_SIZE + occupancy_words * 8 > raw_size, ERR_INVALID_DATA, "Corrupted tile data.");
+		palette.resize(palette_size);
+		for (uint32_t i = 0; i < palette_size; i++) {
+			palette[i].source_id = int16_t(decode_uint16(&block[block_offset]));
+			palette[i].coord_x = int16_t(decode_uint16(&block[block_offset + 2]));
+			palette[i].coord_y = int16_t(decode_uint16(&block[block_offset + 4]));
+			palette[i].alternative_tile = int16_t(decode_uint16(&block[block_offset + 6]));
+			block_offset += ENCODED_CELL_SIZE;
+		}
+
+		// Cells.
+		for (int i = 0; i < occupancy_words; i++) {
+			occupancy[i] = decode_uint64(&block[block_offset]);
+			block_offset += 8;
+		}
+		for (int i = 0; i < chunk_cells_count; i++) {
+			if (!(occupancy[i >> 6] & (uint64_t(1) << (i & 63)))) {
+				continue;
+			}
+			ERR_FAIL_COND_V_MSG(block_offset + index_size > raw_size, ERR_INVALID_DATA, "Corrupted tile data.");
+			uint32_t index = index_size == 2 ? decode_uint16(&block[block_offset]) : block[block_offset];
+			block_offset += index_size;
+			ERR_FAIL_COND_V_MSG(index >= palette_size, ERR_INVALID_DATA, "Corrupted tile data.");
+			cells[i] = palette[index];
+		}
+
+		const Chunk *chunk = _get_chunk(chunk_coords);
+		if (chunk_shift == CHUNK_SHIFT && (!chunk || chunk->in_base)) {
+			// Same chunks as the storage, copy the whole chunk.
+			set_chunk(chunk_coords, occupancy.ptr(), cells.ptr());
+		} else {
+			for (int i = 0; i < chunk_cells_count; i++) {
+				if (occupancy[i >> 6] & (uint64_t(1) << (i & 63))) {
+					insert_cell(Vector2i(chunk_coords.x * chunk_size + (i & (chunk_size - 1)), chunk_coords.y * chunk_size + (i >> chunk_shift)), cells[i]);
+				}
+			}
+		}
+	}
+
+	return OK;
+}
+
+void RTileMapCellStorage::operator=(const RTileMapCellStorage &p_other) {
+	if (this == &p_other) {
+		return;
+	}
+	clear();
+	for (uint32_t i = 0; i < p_other.chunks.size(); i++) {
+		const Chunk *other_chunk = p_other.chunks[i];
+		Chunk *chunk = _create_chunk(other_chunk->coords);
+		memcpy(chunk->owned_data->occupancy, other_chunk->occupancy, sizeof(chunk->owned_data->occupancy));
+		memcpy(chunk->owned_data->cells, other_chunk->cells, sizeof(chunk->owned_data->cells));
+		chunk->used_count = other_chunk->used_count;
+		chunk->in_base = other_chunk->in_base;
+	}
+	cells_count = p_other.cells_count;
+	base_opened = p_other.base_opened;
+	base_chunks_coords = p_other.base_chunks_coords;
+}
+
+// Base files layout, little endian:
+// - Header: "RTMC", uint32 version, uint32 chunk shift, uint32 chunks count.
+// - Index: per chunk, int32 chunk x, int32 chunk y, uint32 used cells count, uint32 reserved.
+// - Data: per chunk in the index order, the occupancy bitmap then the cells (int16 source, int16 atlas x, int16 atlas y, int16 alternative).
+// The data starts 8 bytes aligned, so the chunks can be read in place when RTileMapCell has the same layout in memory.
+static const uint32_t BASE_FILE_VERSION = 1;
+static const int BASE_HEADER_SIZE = 16;
+static const int BASE_INDEX_ENTRY_SIZE = 16;
+
+static bool _is_cell_layout_little_endian() {
+	RTileMapCell cell(0x0102, Vector2i(0x0304, 0x0506), 0x0708);
+	const uint8_t expected[8] = { 0x02, 0x01, 0x04, 0x03, 0x06, 0x05, 0x08, 0x07 };
+	return sizeof(RTileMapCell) == 8 && memcmp(&cell, expected, 8) == 0;
+}
+
+Error RTileMapCellStorage::open_base(const String &p_path) {
+	clear();
+
+	RTileMapMappedFile *file = memnew(RTileMapMappedFile);
+	Error err = file->open(p_path);
+	if (err != OK) {
+		memdelete(file);
+		return err;
+	}
+
+	const uint8_t *r = file->get_data();
+	uint64_t size = file->get_size();
+	uint32_t chunks_count = size >= BASE_HEADER_SIZE ? decode_uint32(&r[12]) : 0;
+	uint64_t data_offset = BASE_HEADER_SIZE + uint64_t(chunks_count) * BASE_INDEX_ENTRY_SIZE;
+	if (size < BASE_HEADER_SIZE || memcmp(r, "RTMC", 4) != 0 || decode_uint32(&r[4]) != BASE_FILE_VERSION || decode_uint32(&r[8]) != CHUNK_SHIFT || data_offset + uint64_t(chunks_count) * sizeof(ChunkData) > size) {
+		memdelete(file);
+		ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, vformat("Invalid TileMap base file: %s.", p_path));
+	}
+
+	// Read the chunks in place if possible, otherwise convert them into owned ones.
+	bool in_place = file->is_mapped() && _is_cell_layout_little_endian();
+	for (uint32_t i = 0; i < chunks_count; i++) {
+		const uint8_t *entry = &r[BASE_HEADER_SIZE + i * BASE_INDEX_ENTRY_SIZE];
+		Vector2i chunk_coords = Vector2i(int32_t(decode_uint32(&entry[0])), int32_t(decode_uint32(&entry[4])));
+		uint32_t used_count = decode_uint32(&entry[8]);
+		const uint8_t *chunk_data = &r[data_offset + i * sizeof(ChunkData)];
+
+		// The cells count of the index must match the occupancy bitmap, the storage relies on it.
+		uint32_t occupied_count = 0;
+		for (int j = 0; j < CHUNK_OCCUPANCY_WORDS; j++) {
+			for (uint64_t word = decode_uint64(&chunk_data[j * 8]); word; word &= word - 1) {
+				occupied_count++;
+			}
+		}
+		ERR_CONTINUE_MSG(used_count == 0 || used_count != occupied_count || chunks_indices.has(chunk_coords), vformat("Invalid chunk in TileMap base file: %s.", p_path));
+
+		Chunk *chunk = nullptr;
+		if (in_place) {
+			chunk = memnew(Chunk);
+			chunk->coords = chunk_coords;
+			chunk->occupancy = (const uint64_t *)chunk_data;
+			chunk->cells = (const RTileMapCell *)(chunk_data + sizeof(ChunkData::occupancy));
+			_add_chunk(chunk);
+		} else {
+			chunk = _create_chunk(chunk_coords);
+			ChunkData *data = chunk->owned_data;
+			for (int j = 0; j < CHUNK_OCCUPANCY_WORDS; j++) {
+				data->occupancy[j] = decode_uint64(&chunk_data[j * 8]);
+			}
+			const uint8_t *cells_data = chunk_data + sizeof(ChunkData::occupancy);
+			for (int j = 0; j < CHUNK_CELLS_COUNT; j++) {
+				data->cells[j].source_id = int16_t(decode_uint16(&cells_data[j * 8]));
+				data->cells[j].coord_x = int16_t(decode_uint16(&cells_data[j * 8 + 2]));
+				data->cells[j].coord_y = int16_t(decode_uint16(&cells_data[j * 8 + 4]));
+				data->cells[j].alternative_tile = int16_t(decode_uint16(&cells_data[j * 8 + 6]));
+			}
+		}
+		chunk->used_count = used_count;
+		chunk->in_base = true;
+		cells_count += used_count;
+		base_chunks_coords.push_back(chunk_coords);
+	}
+
+	if (in_place) {
+		base_file = file;
+	} else {
+		memdelete(file);
+	}
+	base_opened = true;
+	return OK;
+}
+
+Error RTileMapCellStorage::save_base(const String &p_path) const {
+	Error err;
+	FileAccess *f = FileAccess::open(p_path, FileAccess::WRITE, &err);
+	ERR_FAIL_COND_V_MSG(!f, err, vformat("Cannot write TileMap base file: %s.", p_path));
+
+	LocalVector<const Chunk *> sorted_chunks;
+	_get_sorted_chunks(sorted_chunks);
+
+	f->store_buffer((const uint8_t *)"RTMC", 4);
+	f->store_32(BASE_FILE_VERSION);
+	f->store_32(CHUNK_SHIFT);
+	f->store_32(chunks.size());
+	for (uint32_t chunk_index = 0; chunk_index < sorted_chunks.size(); chunk_index++) {
+		const Chunk *chunk = sorted_chunks[chunk_index];
+		f->store_32(uint32_t(chunk->coords.x));
+		f->store_32(uint32_t(chunk->coords.y));
+		f->store_32(chunk->used_count);
+		f->store_32(0);
+	}
+	for (uint32_t chunk_index = 0; chunk_index < sorted_chunks.size(); chunk_index++) {
+		const Chunk *chunk = sorted_chunks[chunk_index];
+		for (int i = 0; i < CHUNK_OCCUPANCY_WORDS; i++) {
+			f->store_64(chunk->occupancy[i]);
+		}
+		for (int i = 0; i < CHUNK_CELLS_COUNT; i++) {
+			f->store_16(uint16_t(chunk->cells[i].source_id));
+			f->store_16(uint16_t(chunk->cells[i].coord_x));
+			f->store_16(uint16_t(chunk->cells[i].coord_y));
+			f->store_16(uint16_t(chunk->cells[i].alternative_tile));
+		}
+	}
+	memdelete(f);
+	return OK;
+}
+
+bool RTileMapCellStorage::is_base_mapped() const {
+	return base_file != nullptr;
+}
+
+RTileMapCellStorage::RTileMapCellStorage(const RTileMapCellStorage &p_other) {
+	*this = p_other;
+}
+
+RTileMapCellStorage::~RTileMapCellStorage() {
+	clear();
+}
@@ -0,0 +1,181 @@
+/*************************************************************************/
+/*  rtile_map_cell_storage.h                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#ifndef RTILE_MAP_CELL_STORAGE_H
+#define RTILE_MAP_CELL_STORAGE_H
+
+#include "core/hash_map.h"
+#include "core/hashfuncs.h"
+#include "core/local_vector.h"
+#include "core/math/rect2.h"
+#include "core/vector.h"
+
+#include "rtile_set.h"
+
+class RTileMapMappedFile;
+
+struct RTileMapCoordsHasher {
+	static _FORCE_INLINE_ uint32_t hash(const Vector2i &p_coords) {
+		uint32_t h = hash_djb2_one_32(uint32_t(p_coords.x));
+		return hash_djb2_one_32(uint32_t(p_coords.y), h);
+	}
+};
+
+// Dense storage for the cells of a TileMap layer.
+// Cells are grouped into fixed-size square chunks, each holding a flat array of packed RTileMapCell
+// and an occupancy bitmap. Chunks are looked up through a hash map and kept in a contiguous list for iteration.
+class RTileMapCellStorage {
+public:
+	enum {
+		CHUNK_SHIFT = 4,
+		CHUNK_SIZE = 1 << CHUNK_SHIFT,
+		CHUNK_MASK = CHUNK_SIZE - 1,
+		CHUNK_CELLS_COUNT = CHUNK_SIZE * CHUNK_SIZE,
+		CHUNK_OCCUPANCY_WORDS = CHUNK_CELLS_COUNT / 64,
+	};
+
+	// The cells of a chunk, laid out as in the base files.
+	struct ChunkData {
+		uint64_t occupancy[CHUNK_OCCUPANCY_WORDS];
+		RTileMapCell cells[CHUNK_CELLS_COUNT];
+
+		ChunkData() {
+			for (int i = 0; i < CHUNK_OCCUPANCY_WORDS; i++) {
+				occupancy[i] = 0;
+			}
+		}
+	};
+
+	struct Chunk {
+		Vector2i coords;
+		uint32_t used_count = 0;
+		// Point to the owned data, or straight into the mapped base file until the chunk is first written.
+		const uint64_t *occupancy = nullptr;
+		const RTileMapCell *cells = nullptr;
+		ChunkData *owned_data = nullptr;
+		bool in_base = false; // Same cells as in the base file.
+
+		_FORCE_INLINE_ bool is_used(uint32_t p_index) const {
+			return occupancy[p_index >> 6] & (uint64_t(1) << (p_index & 63));
+		}
+
+		_FORCE_INLINE_ Vector2i get_cell_coords(uint32_t p_index) const {
+			return Vector2i(coords.x * CHUNK_SIZE + int(p_index & CHUNK_MASK), coords.y * CHUNK_SIZE + int(p_index >> CHUNK_SHIFT));
+		}
+
+		Chunk() {}
+		Chunk(const Chunk &p_other) = delete;
+		Chunk &operator=(const Chunk &p_other) = delete;
+		~Chunk() {
+			if (owned_data) {
+				memdelete(owned_data);
+			}
+		}
+	};
+
+private:
+	LocalVector<Chunk *> chunks;
+	HashMap<Vector2i, uint32_t, RTileMapCoordsHasher> chunks_indices;
+	uint32_t cells_count = 0;
+
+	// Read-only base the storage was opened from.
+	bool base_opened = false;
+	RTileMapMappedFile *base_file = nullptr; // Only kept while chunks are read from its mapping.
+	LocalVector<Vector2i> base_chunks_coords;
+
+	Chunk *_get_chunk(const Vector2i &p_chunk_coords) const;
+	Chunk *_create_chunk(const Vector2i &p_chunk_coords);
+	void _add_chunk(Chunk *p_chunk);
+	void _erase_chunk(const Vector2i &p_chunk_coords);
+	ChunkData *_get_writable_data(Chunk *p_chunk);
+
+	struct ChunkCoordsComparator {
+		_FORCE_INLINE_ bool operator()(const Chunk *p_a, const Chunk *p_b) const {
+			return p_a->coords < p_b->coords;
+		}
+	};
+	void _get_sorted_chunks(LocalVector<const Chunk *> &r_chunks) const;
+
+public:
+	static _FORCE_INLINE_ Vector2i get_chunk_coords(const Vector2i &p_coords) {
+		// Arithmetic shift, rounds towards negative infinity.
+		return Vector2i(p_coords.x >> CHUNK_SHIFT, p_coords.y >> CHUNK_SHIFT);
+	}
+
+	static _FORCE_INLINE_ uint32_t get_index_in_chunk(const Vector2i &p_coords) {
+		return (uint32_t(p_coords.y) & CHUNK_MASK) << CHUNK_SHIFT | (uint32_t(p_coords.x) & CHUNK_MASK);
+	}
+
+	// Cells accessors. Returned pointers stay valid until the containing chunk is erased or, for get_cell(), written.
+	const RTileMapCell *get_cell(const Vector2i &p_coords) const;
+	RTileMapCell *get_cell_ptr(const Vector2i &p_coords); // Copies the chunk out of the base file first.
+	bool has_cell(const Vector2i &p_coords) const;
+	RTileMapCell *insert_cell(const Vector2i &p_coords, const RTileMapCell &p_cell);
+	bool erase_cell(const Vector2i &p_coords);
+
+	uint32_t size() const { return cells_count; }
+	bool empty() const { return cells_count == 0; }
+	void clear(); // Also closes the base file.
+
+	// Chunks iteration. The order depends on the edits history.
+	uint32_t get_chunks_count() const { return chunks.size(); }
+	const Chunk *get_chunk_by_index(uint32_t p_index) const { return chunks[p_index]; }
+
+	// Coords of the used cells in increasing order, for results and saved data that only depend on the cells.
+	void get_sorted_cells(LocalVector<Vector2i> &r_coords) const;
+
+	// Replaces the cells of a whole chunk, erasing it if no cell is used.
+	void set_chunk(const Vector2i &p_chunk_coords, const uint64_t *p_occupancy, const RTileMapCell *p_cells);
+
+	Rect2i get_used_rect() const; // Returns an empty rect if no cells are used.
+
+	// Binary serialization, one block per chunk: the chunk coords, then a palette of the distinct cells of the chunk,
+	// the occupancy bitmap and one palette index per used cell. Blocks are optionally compressed, p_compression_mode
+	// being a Compression::Mode or -1.
+	// With a base file, only the chunks differing from it are encoded, the base chunks erased as empty ones.
+	Vector<uint8_t> encode(int p_compression_mode = -1) const;
+	Error decode(const Vector<uint8_t> &p_data); // Adds the cells to the storage, replacing the chunks unchanged from the base file.
+
+	// Base files hold the chunks as laid out in memory, behind an index. When the platform allows it, they are memory mapped
+	// and the cells are read from the mapping, so opening them costs no copy and the pages are shared with other processes.
+	// Written chunks are copied to the heap first, forming a copy-on-write overlay over the base.
+	Error open_base(const String &p_path); // Replaces the cells of the storage.
+	Error save_base(const String &p_path) const;
+	bool has_base() const { return base_opened; }
+	bool is_base_mapped() const;
+
+	void operator=(const RTileMapCellStorage &p_other); // Copies hold their cells on the heap.
+	RTileMapCellStorage(const RTileMapCellStorage &p_other);
+	RTileMapCellStorage() {}
+	~RTileMapCellStorage();
+};
+
+#endif // RTILE_MAP_CELL_STORAGE_H
@@ -0,0 +1,774 @@
+/*************************************************************************/
+/*  rtile_map_pathfinding.cpp                                            */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+
+#include "rtile_map_pathfinding.h"
+
+#include "rtile_map.h"
+
+bool RTileMapPathfinding::TransitionComparator::operator()(const Transition &p_a, const Transition &p_b) const {
+	return p_a.from < p_b.from || (p_a.from == p_b.from && p_a.to < p_b.to);
+}
+
+Vector2i RTileMapPathfinding::_get_neighbor(const Vector2i &p_coords, int p_neighbor_index) const {
+	return tile_map->get_neighbor_cell(p_coords, neighbors[p_neighbor_index]);
+}
+
+real_t RTileMapPathfinding::_get_heuristic(const Vector2i &p_from, const Vector2i &p_to) const {
+	// A lower bound of the steps count, each step costing at least the cheapest walkable cell.
+	return tile_map->map_to_world(p_from).distance_to(tile_map->map_to_world(p_to)) / max_step_length * min_cell_cost;
+}
+
+void RTileMapPathfinding::_push_open_cell(LocalVector<OpenCell> &r_open, const OpenCell &p_cell) {
+	// Binary min-heap on the priority.
+	uint32_t index = r_open.size();
+	r_open.push_back(p_cell);
+	while (index > 0) {
+		uint32_t parent = (index - 1) / 2;
+		if (r_open[parent].priority <= r_open[index].priority) {
+			break;
+		}
+		SWAP(r_open[parent], r_open[index]);
+		index = parent;
+	}
+}
+
+RTileMapPathfinding::OpenCell RTileMapPathfinding::_pop_open_cell(LocalVector<OpenCell> &r_open) {
+	OpenCell top = r_open[0];
+	r_open[0] = r_open[r_open.size() - 1];
+	r_open.resize(r_open.size() - 1);
+
+	uint32_t index = 0;
+	while (true) {
+		uint32_t smallest = index;
+		uint32_t left = index * 2 + 1;
+		uint32_t right = left + 1;
+		if (left < r_open.size() && r_open[left].priority < r_open[smallest].priority) {
+			smallest = left;
+		}
+		if (right < r_open.size() && r_open[right].priority < r_open[smallest].priority) {
+			smallest = right;
+		}
+		if (smallest == index) {
+			break;
+		}
+		SWAP(r_open[smallest], r_open[index]);
+		index = smallest;
+	}
+	return top;
+}
+
+bool RTileMapPathfinding::_search(const Vector2i &p_from, const Vector2i *p_goal, const Vector2i *p_cluster, SearchCells &r_cells) const {
+	LocalVector<OpenCell> open;
+
+	SearchCell start;
+	start.parent = p_from;
+	r_cells.set(p_from, start);
+
+	OpenCell open_start;
+	open_start.coords = p_from;
+	open_start.priority = p_goal ? _get_heuristic(p_from, *p_goal) : 0.0;
+	_push_open_cell(open, open_start);
+
+	while (!open.empty()) {
+		OpenCell current = _pop_open_cell(open);
+		SearchCell *current_cell = r_cells.getptr(current.coords);
+		if (current_cell->closed) {
+			continue; // Outdated entry, the cell was reached again with a lower cost.
+		}
+		current_cell->closed = true;
+		if (p_goal && current.coords == *p_goal) {
+			return true;
+		}
+
+		real_t current_cost = current_cell->cost;
+		real_t current_cell_cost = get_cell_cost(current.coords);
+		for (uint32_t i = 0; i < neighbors.size(); i++) {
+			Vector2i neighbor = _get_neighbor(current.coords, i);
+			if (p_cluster && _get_cluster(neighbor) != *p_cluster) {
+				continue;
+			}
+			real_t neighbor_cell_cost = get_cell_cost(neighbor);
+			if (neighbor_cell_cost <= 0.0) {
+				continue;
+			}
+
+			// Moving between two cells costs the average of their costs.
+			real_t cost = current_cost + (current_cell_cost + neighbor_cell_cost) / 2.0;
+			SearchCell *neighbor_cell = r_cells.getptr(neighbor);
+			if (neighbor_cell && (neighbor_cell->closed || neighbor_cell->cost <= cost)) {
+				continue;
+			}
+			SearchCell reached;
+			reached.parent = current.coords;
+			reached.cost = cost;
+			r_cells.set(neighbor, reached);
+
+			OpenCell open_cell;
+			open_cell.coords = neighbor;
+			open_cell.priority = cost + (p_goal ? _get_heuristic(neighbor, *p_goal) : 0.0);
+			_push_open_cell(open, open_cell);
+		}
+	}
+	return !p_goal;
+}
+
+Vector<Vector2i> RTileMapPathfinding::_get_search_path(const SearchCells &p_cells, const Vector2i &p_from, const Vector2i &p_to, bool p_reversed) {
+	// Follows the parents from p_to back to p_from. The start cell is not included.
+	Vector<Vector2i> path;
+	Vector2i coords = p_to;
+	while (coords != p_from) {
+		path.push_back(coords);
+		coords = p_cells.getptr(coords)->parent;
+	}
+	if (p_reversed) {
+		// From p_to, the parents lead to p_from: give the cells after p_to up to p_from instead.
+		path.remove(0);
+		path.push_back(p_from);
+		return path;
+	}
+	path.invert();
+	return path;
+}
+
+void RTileMapPathfinding::_rebuild_cluster(const Vector2i &p_cluster, bool p_cells_changed) {
+	// Walkable cells leading to another cluster, grouped per neighbor cluster.
+	Map<Vector2i, LocalVector<Transition>> candidates;
+	Vector2i first_cell = Vector2i(p_cluster.x * cluster_size, p_cluster.y * cluster_size);
+	for (int y = 0; y < cluster_size; y++) {
+		for (int x = 0; x < cluster_size; x++) {
+			Vector2i coords = Vector2i(first_cell.x + x, first_cell.y + y);
+			real_t cost = get_cell_cost(coords);
+			if (cost <= 0.0) {
+				continue;
+			}
+			min_cell_cost = MIN(min_cell_cost, cost);
+			for (uint32_t i = 0; i < neighbors.size(); i++) {
+				Vector2i neighbor = _get_neighbor(coords, i);
+				Vector2i neighbor_cluster = _get_cluster(neighbor);
+				if (neighbor_cluster != p_cluster && get_cell_cost(neighbor) > 0.0) {
+					Transition transition;
+					transition.from = coords;
+					transition.to = neighbor;
+					candidates[neighbor_cluster].push_back(transition);
+				}
+			}
+		}
+	}
+
+	// Contiguous transitions form an entrance, crossed at its middle transition.
+	// The transitions are ordered the same way from both sides, so that both clusters pick the same one.
+	Cluster cluster;
+	for (Map<Vector2i, LocalVector<Transition>>::Element *E = candidates.front(); E; E = E->next()) {
+		LocalVector<Transition> &transitions = E->get();
+		bool cluster_first = p_cluster < E->key();
+
+		LocalVector<int> entrance;
+		entrance.resize(transitions.size());
+		for (uint32_t i = 0; i < transitions.size(); i++) {
+			entrance[i] = i;
+		}
+		for (uint32_t i = 0; i < transitions.size(); i++) {
+			for (uint32_t j = i + 1; j < transitions.size(); j++) {
+				bool from_adjacent = false;
+				bool to_adjacent = transitions[i].to == transitions[j].to;
+				for (uint32_t k = 0; k < neighbors.size(); k++) {
+					from_adjacent = from_adjacent || transitions[i].from == transitions[j].from || _get_neighbor(transitions[i].from, k) == transitions[j].from;
+					to_adjacent = to_adjacent || _get_neighbor(transitions[i].to, k) == transitions[j].to;
+				}
+				if (from_adjacent && to_adjacent) {
+					// Merge the two entrances.
+					int old_entrance = entrance[j];
+					for (uint32_t l = 0; l < transitions.size(); l++) {
+						if (entrance[l] == old_entrance) {
+							entrance[l] = entrance[i];
+						}
+					}
+				}
+			}
+		}
+
+		Set<int> entrances;
+		for (uint32_t i = 0; i < transitions.size(); i++) {
+			entrances.insert(entrance[i]);
+		}
+		for (Set<int>::Element *F = entrances.front(); F; F = F->next()) {
+			// Sorted from the cluster with the lowest coordinates.
+			Vector<Transition> sorted;
+			for (uint32_t i = 0; i < transitions.size(); i++) {
+				if (entrance[i] == F->get()) {
+					Transition transition = transitions[i];
+					if (!cluster_first) {
+						SWAP(transition.from, transition.to);
+					}
+					sorted.push_back(transition);
+				}
+			}
+			sorted.sort_custom<TransitionComparator>();
+
+			Transition middle = sorted[sorted.size() / 2];
+			if (!cluster_first) {
+				SWAP(middle.from, middle.to);
+			}
+			cluster.transitions.push_back(middle);
+		}
+	}
+
+	for (uint32_t i = 0; i < cluster.transitions.size(); i++) {
+		if (cluster.nodes.find(cluster.transitions[i].from) < 0) {
+			cluster.nodes.push_back(cluster.transitions[i].from);
+		}
+	}
+
+	Cluster *old_cluster = clusters.getptr(p_cluster);
+	bool same_nodes = !p_cells_changed && old_cluster && old_cluster->nodes.size() == cluster.nodes.size();
+	for (uint32_t i = 0; same_nodes && i < cluster.nodes.size(); i++) {
+		same_nodes = old_cluster->nodes[i] == cluster.nodes[i];
+	}
+
+	if (same_nodes) {
+		// The paths inside the cluster did not change, only the edges leaving it are replaced.
+		for (uint32_t i = 0; i < cluster.nodes.size(); i++) {
+			LocalVector<Edge> &edges = nodes.getptr(cluster.nodes[i])->edges;
+			for (int j = int(edges.size()) - 1; j >= 0; j--) {
+				if (edges[j].leaves_cluster) {
+					edges.remove(j);
+				}
+			}
+		}
+	} else {
+		if (old_cluster) {
+			for (uint32_t i = 0; i < old_cluster->nodes.size(); i++) {
+				nodes.erase(old_cluster->nodes[i]);
+			}
+		}
+
+		// Link the nodes with the paths inside the cluster.
+		for (uint32_t i = 0; i < cluster.nodes.size(); i++) {
+			nodes.set(cluster.nodes[i], Node());
+		}
+		for (uint32_t i = 0; i < cluster.nodes.size(); i++) {
+			SearchCells search;
+			_search(cluster.nodes[i], nullptr, &p_cluster, search);
+			for (uint32_t j = 0; j < cluster.nodes.size(); j++) {
+				const SearchCell *reached = search.getptr(cluster.nodes[j]);
+				if (i == j || !reached) {
+					continue;
+				}
+				Edge edge;
+				edge.to = cluster.nodes[j];
+				edge.cost = reached->cost;
+				edge.path = _get_search_path(search, cluster.nodes[i], cluster.nodes[j], false);
+				nodes.getptr(cluster.nodes[i])->edges.push_back(edge);
+			}
+		}
+	}
+
+	for (uint32_t i = 0; i < cluster.transitions.size(); i++) {
+		const Transition &transition = cluster.transitions[i];
+		Edge edge;
+		edge.to = transition.to;
+		edge.cost = (get_cell_cost(transition.from) + get_cell_cost(transition.to)) / 2.0;
+		edge.leaves_cluster = true;
+		edge.path.push_back(transition.to);
+		nodes.getptr(transition.from)->edges.push_back(edge);
+	}
+
+	if (cluster.nodes.empty()) {
+		clusters.erase(p_cluster);
+	} else {
+		clusters.set(p_cluster, cluster);
+	}
+}
+
+void RTileMapPathfinding::_update() {
+	// The transitions of the surrounding clusters depend on the cells of the changed ones.
+	int radius = (2 + cluster_size - 1) / cluster_size;
+	Map<Vector2i, bool> to_rebuild;
+	for (Set<Vector2i>::Element *E = dirty_clusters.front(); E; E = E->next()) {
+		for (int y = -radius; y <= radius; y++) {
+			for (int x = -radius; x <= radius; x++) {
+				Vector2i cluster = Vector2i(E->get().x + x, E->get().y + y);
+				if (!to_rebuild.has(cluster)) {
+					to_rebuild[cluster] = false;
+				}
+			}
+		}
+		to_rebuild[E->get()] = true;
+	}
+	dirty_clusters.clear();
+
+	for (Map<Vector2i, bool>::Element *E = to_rebuild.front(); E; E = E->next()) {
+		_rebuild_cluster(E->key(), E->get());
+	}
+}
+
+void RTileMapPathfinding::_compute_flow_field(FlowField *p_field, bool p_full) const {
+	// Multi-source Dijkstra from the goals. A partial update resets the cells whose way to a goal goes through a
+	// changed cluster, then propagates again from the cells around them. Lower costs reaching the other cells through
+	// the changed clusters are propagated too.
+	const Rect2i &region = p_field->region;
+	int width = region.size.x;
+	int cells_count = region.size.x * region.size.y;
+	LocalVector<OpenCell> open;
+
+	if (p_full) {
+		p_field->integration.resize(cells_count);
+		p_field->directions.resize(cells_count);
+		for (int i = 0; i < cells_count; i++) {
+			p_field->integration[i] = Math_INF;
+			p_field->directions[i] = FLOW_FIELD_NO_DIRECTION;
+		}
+	} else {
+		// 0: unknown, 1: valid, 2: reset.
+		LocalVector<uint8_t> state;
+		state.resize(cells_count);
+		for (int i = 0; i < cells_count; i++) {
+			state[i] = 0;
+		}
+		LocalVector<int> chain;
+		for (int i = 0; i < cells_count; i++) {
+			// Follow the directions until a cell with a known state.
+			int index = i;
+			uint8_t chain_state = 1;
+			while (state[index] == 0) {
+				Vector2i coords = Vector2i(region.position.x + index % width, region.position.y + index / width);
+				if (p_field->dirty_clusters.has(_get_cluster(coords))) {
+					chain_state = 2;
+				}
+				chain.push_back(index);
+				uint8_t direction = p_field->directions[index];
+				if (direction == FLOW_FIELD_NO_DIRECTION) {
+					break;
+				}
+				Vector2i next = tile_map->get_neighbor_cell(coords, RTileSet::CellNeighbor(direction));
+				index = (next.y - region.position.y) * width + (next.x - region.position.x);
+			}
+			if (state[index] == 2) {
+				chain_state = 2;
+			}
+			for (uint32_t j = 0; j < chain.size(); j++) {
+				state[chain[j]] = chain_state;
+			}
+			chain.clear();
+		}
+
+		for (int i = 0; i < cells_count; i++) {
+			if (state[i] == 2) {
+				p_field->integration[i] = Math_INF;
+				p_field->directions[i] = FLOW_FIELD_NO_DIRECTION;
+			}
+		}
+
+		// Start again from the valid cells next to the reset ones.
+		for (int i = 0; i < cells_count; i++) {
+			if (state[i] != 1 || p_field->integration[i] == Math_INF) {
+				continue;
+			}
+			Vector2i coords = Vector2i(region.position.x + i % width, region.position.y + i / width);
+			for (uint32_t j = 0; j < neighbors.size(); j++) {
+				Vector2i neighbor = _get_neighbor(coords, j);
+				if (region.has_point(neighbor) && state[(neighbor.y - region.position.y) * width + (neighbor.x - region.position.x)] == 2) {
+					OpenCell open_cell;
+					open_cell.coords = coords;
+					open_cell.priority = p_field->integration[i];
+					_push_open_cell(open, open_cell);
+					break;
+				}
+			}
+		}
+	}
+	p_field->dirty_clusters.clear();
+
+	for (int i = 0; i < p_field->goals.size(); i++) {
+		const Vector2i &goal = p_field->goals[i];
+		int index = (goal.y - region.position.y) * width + (goal.x - region.position.x);
+		if (p_field->integration[index] == 0.0 || get_cell_cost(goal) <= 0.0) {
+			continue;
+		}
+		p_field->integration[index] = 0.0;
+		p_field->directions[index] = FLOW_FIELD_NO_DIRECTION;
+
+		OpenCell open_cell;
+		open_cell.coords = goal;
+		_push_open_cell(open, open_cell);
+	}
+
+	while (!open.empty()) {
+		OpenCell current = _pop_open_cell(open);
+		int current_index = (current.coords.y - region.position.y) * width + (current.coords.x - region.position.x);
+		if (current.priority > p_field->integration[current_index]) {
+			continue; // Outdated entry.
+		}
+
+		real_t current_cell_cost = get_cell_cost(current.coords);
+		for (uint32_t i = 0; i < neighbors.size(); i++) {
+			Vector2i neighbor = _get_neighbor(current.coords, i);
+			if (!region.has_point(neighbor)) {
+				continue;
+			}
+			real_t neighbor_cell_cost = get_cell_cost(neighbor);
+			if (neighbor_cell_cost <= 0.0) {
+				continue;
+			}
+			int neighbor_index = (neighbor.y - region.position.y) * width + (neighbor.x - region.position.x);
+			real_t cost = current.priority + (current_cell_cost + neighbor_cell_cost) / 2.0;
+			if (cost >= p_field->integration[neighbor_index]) {
+				continue;
+			}
+			// Opposite neighbors are half a turn apart in the CellNeighbor enum.
+			p_field->integration[neighbor_index] = cost;
+			p_field->directions[neighbor_index] = (neighbors[i] + RTileSet::CELL_NEIGHBOR_MAX / 2) % RTileSet::CELL_NEIGHBOR_MAX;
+
+			OpenCell open_cell;
+			open_cell.coords = neighbor;
+			open_cell.priority = cost;
+			_push_open_cell(open, open_cell);
+		}
+	}
+}
+
+real_t RTileMapPathfinding::get_cell_cost(const Vector2i &p_coords) const {
+	// Zero for cells that cannot be walked through.
+	const RTileMapCell *cell = cells->get_cell(p_coords);
+	if (!cell) {
+		return 0.0;
+	}
+	const RTileSet::TileResolution *resolution = tile_set->resolve_tile(*cell);
+	if (!resolution || !resolution->tile_data) {
+		return 0.0;
+	}
+
+	if (custom_data_layer >= 0) {
+		Variant value = resolution->tile_data->get_custom_data_by_layer_id(custom_data_layer);
+		switch (value.get_type()) {
+			case Variant::BOOL:
+				return bool(value) ? 1.0 : 0.0;
+			case Variant::INT:
+			case Variant::REAL:
+				return MAX(real_t(value), 0.0);
+			default:
+				return 0.0;
+		}
+	}
+
+	for (int i = 0; i < tile_set->get_navigation_layers_count(); i++) {
+		if (resolution->tile_data->get_navigation_polygon(i).is_valid()) {
+			return 1.0;
+		}
+	}
+	return 0.0;
+}
+
+void RTileMapPathfinding::make_cell_dirty(const Vector2i &p_coords) {
+	Vector2i cluster = _get_cluster(p_coords);
+	dirty_clusters.insert(cluster);
+	dirty.set();
+
+	MutexLock lock(flow_fields_mutex);
+	for (uint32_t i = 0; i < flow_fields.size(); i++) {
+		if (flow_fields[i]->region.has_point(p_coords)) {
+			flow_fields[i]->dirty_clusters.insert(cluster);
+		}
+	}
+}
+
+void RTileMapPathfinding::prepare_queries() {
+	// Rebuilt on the first query after a change, on the main thread.
+	if (dirty.is_set()) {
+		_update();
+		dirty.clear();
+	}
+}
+
+PoolVector2Array RTileMapPathfinding::find_path(const Vector2i &p_from, const Vector2i &p_to) {
+	prepare_queries();
+
+	PoolVector2Array output;
+	if (get_cell_cost(p_from) <= 0.0 || get_cell_cost(p_to) <= 0.0) {
+		return output;
+	}
+	if (p_from == p_to) {
+		output.push_back(p_from);
+		return output;
+	}
+
+	// Paths inside a single cluster are searched directly.
+	Vector2i from_cluster = _get_cluster(p_from);
+	Vector2i to_cluster = _get_cluster(p_to);
+	if (from_cluster == to_cluster) {
+		SearchCells search;
+		if (_search(p_from, &p_to, &from_cluster, search)) {
+			output.push_back(p_from);
+			Vector<Vector2i> path = _get_search_path(search, p_from, p_to, false);
+			for (int i = 0; i < path.size(); i++) {
+				output.push_back(path[i]);
+			}
+			return output;
+		}
+	}
+
+	// Temporary edges from the start to the nodes of its cluster, and from the nodes of the goal cluster to the goal.
+	// Costs are symmetric, so the second search starts from the goal.
+	SearchCells from_search;
+	_search(p_from, nullptr, &from_cluster, from_search);
+	SearchCells to_search;
+	_search(p_to, nullptr, &to_cluster, to_search);
+
+	struct AbstractState {
+		Vector2i parent;
+		real_t cost = 0.0;
+		bool closed = false;
+		const Edge *edge = nullptr; // Null when coming from the start, or going to the goal.
+		bool to_goal = false;
+	};
+	HashMap<Vector2i, AbstractState, RTileMapCoordsHasher> states;
+	LocalVector<OpenCell> open;
+
+	const Cluster *start_cluster = clusters.getptr(from_cluster);
+	if (!start_cluster) {
+		return output;
+	}
+	for (uint32_t i = 0; i < start_cluster->nodes.size(); i++) {
+		const SearchCell *reached = from_search.getptr(start_cluster->nodes[i]);
+		if (!reached) {
+			continue;
+		}
+		AbstractState state;
+		state.parent = p_from;
+		state.cost = reached->cost;
+		states.set(start_cluster->nodes[i], state);
+
+		OpenCell open_cell;
+		open_cell.coords = start_cluster->nodes[i];
+		open_cell.priority = state.cost + _get_heuristic(open_cell.coords, p_to);
+		_push_open_cell(open, open_cell);
+	}
+
+	bool found = false;
+	while (!open.empty()) {
+		OpenCell current = _pop_open_cell(open);
+		AbstractState *current_state = states.getptr(current.coords);
+		if (current_state->closed) {
+			continue;
+		}
+		current_state->closed = true;
+		if (current.coords == p_to) {
+			found = true;
+			break;
+		}
+		real_t current_cost = current_state->cost;
+
+		// Candidate moves: the edges of the node, then the goal itself from its cluster.
+		const Node *node = nodes.getptr(current.coords);
+		uint32_t edges_count = node ? node->edges.size() : 0;
+		for (uint32_t i = 0; i <= edges_count; i++) {
+			const Edge *edge = nullptr;
+			bool to_goal = false;
+			Vector2i to;
+			real_t cost;
+			if (i < edges_count) {
+				edge = &node->edges[i];
+				to = edge->to;
+				cost = current_cost + edge->cost;
+			} else {
+				const SearchCell *reached = to_search.getptr(current.coords);
+				if (!reached || _get_cluster(current.coords) != to_cluster) {
+					continue;
+				}
+				to = p_to;
+				to_goal = true;
+				cost = current_cost + reached->cost;
+			}
+
+			AbstractState *state = states.getptr(to);
+			if (state && (state->closed || state->cost <= cost)) {
+				continue;
+			}
+			AbstractState new_state;
+			new_state.parent = current.coords;
+			new_state.cost = cost;
+			new_state.edge = edge;
+			new_state.to_goal = to_goal;
+			states.set(to, new_state);
+
+			OpenCell open_cell;
+			open_cell.coords = to;
+			open_cell.priority = cost + _get_heuristic(to, p_to);
+			_push_open_cell(open, open_cell);
+		}
+	}
+	if (!found) {
+		return output;
+	}
+
+	// Expand the abstract path into cells, from the goal back to the start.
+	Vector<Vector<Vector2i>> segments;
+	Vector2i coords = p_to;
+	while (coords != p_from) {
+		const AbstractState *state = states.getptr(coords);
+		if (state->edge) {
+			segments.push_back(state->edge->path);
+		} else if (state->to_goal) {
+			segments.push_back(_get_search_path(to_search, p_to, state->parent, true));
+		} else {
+			segments.push_back(_get_search_path(from_search, p_from, coords, false));
+		}
+		coords = state->parent;
+	}
+
+	output.push_back(p_from);
+	for (int i = segments.size() - 1; i >= 0; i--) {
+		for (int j = 0; j < segments[i].size(); j++) {
+			output.push_back(segments[i][j]);
+		}
+	}
+	return output;
+}
+
+void RTileMapPathfinding::get_flow_field(const Rect2i &p_region, const Vector<Vector2i> &p_goals, PoolByteArray *r_directions, PoolRealArray *r_integration) {
+	ERR_FAIL_COND(p_region.size.x <= 0 || p_region.size.y <= 0);
+
+	Vector<Vector2i> goals;
+	for (int i = 0; i < p_goals.size(); i++) {
+		if (p_region.has_point(p_goals[i]) && goals.find(p_goals[i]) < 0) {
+			goals.push_back(p_goals[i]);
+		}
+	}
+	goals.sort();
+
+	MutexLock lock(flow_fields_mutex);
+	FlowField *field = nullptr;
+	for (uint32_t i = 0; i < flow_fields.size() && !field; i++) {
+		if (flow_fields[i]->region != p_region || flow_fields[i]->goals.size() != goals.size()) {
+			continue;
+		}
+		field = flow_fields[i];
+		for (int j = 0; j < goals.size(); j++) {
+			if (field->goals[j] != goals[j]) {
+				field = nullptr;
+				break;
+			}
+		}
+	}
+
+	if (field) {
+		if (!field->dirty_clusters.empty()) {
+			_compute_flow_field(field, false);
+		}
+	} else {
+		if (flow_fields.size() >= FLOW_FIELDS_CACHE_SIZE) {
+			// Replace the least recently used field.
+			uint32_t oldest = 0;
+			for (uint32_t i = 1; i < flow_fields.size(); i++) {
+				if (flow_fields[i]->last_used < flow_fields[oldest]->last_used) {
+					oldest = i;
+				}
+			}
+			memdelete(flow_fields[oldest]);
+			flow_fields.remove(oldest);
+		}
+		field = memnew(FlowField);
+		field->region = p_region;
+		field->goals = goals;
+		flow_fields.push_back(field);
+		_compute_flow_field(field, true);
+	}
+	field->last_used = ++flow_fields_uses;
+
+	int cells_count = field->directions.size();
+	if (r_directions) {
+		r_directions->resize(cells_count);
+		PoolByteArray::Write w = r_directions->write();
+		for (int i = 0; i < cells_count; i++) {
+			w[i] = field->directions[i];
+		}
+	}
+	if (r_integration) {
+		r_integration->resize(cells_count);
+		PoolRealArray::Write w = r_integration->write();
+		for (int i = 0; i < cells_count; i++) {
+			w[i] = field->integration[i];
+		}
+	}
+}
+
+void RTileMapPathfinding::process_query(uint32_t p_index, PathQuery *p_queries) {
+	p_queries[p_index].path = find_path(p_queries[p_index].from, p_queries[p_index].to);
+}
+
+RTileMapPathfinding::RTileMapPathfinding(const RTileMap *p_tile_map, const RTileMapCellStorage *p_cells, int p_custom_data_layer) {
+	tile_map = p_tile_map;
+	tile_set = *p_tile_map->get_tileset();
+	cells = p_cells;
+	cluster_size = MAX(p_tile_map->get_quadrant_size(), 1);
+	custom_data_layer = p_custom_data_layer;
+
+	// Moves go through the sides of the cells only.
+	for (int i = 0; i < RTileSet::CELL_NEIGHBOR_MAX; i++) {
+		RTileSet::CellNeighbor neighbor = RTileSet::CellNeighbor(i);
+		bool is_side = i % 2 == 0;
+		if (is_side && p_tile_map->is_existing_neighbor(neighbor)) {
+			neighbors.push_back(neighbor);
+		}
+	}
+
+	// The longest step, measured on a few cells as offset layouts alternate.
+	max_step_length = 0.0;
+	for (int y = 0; y < 2; y++) {
+		for (int x = 0; x < 2; x++) {
+			Vector2i coords = Vector2i(x, y);
+			for (uint32_t i = 0; i < neighbors.size(); i++) {
+				max_step_length = MAX(max_step_length, p_tile_map->map_to_world(coords).distance_to(p_tile_map->map_to_world(_get_neighbor(coords, i))));
+			}
+		}
+	}
+	if (max_step_length <= 0.0) {
+		max_step_length = 1.0;
+	}
+
+	// Every used cell is part of a cluster to build.
+	for (uint32_t i = 0; i < cells->get_chunks_count(); i++) {
+		const RTileMapCellStorage::Chunk *chunk = cells->get_chunk_by_index(i);
+		for (uint32_t j = 0; j < RTileMapCellStorage::CHUNK_CELLS_COUNT; j++) {
+			if (chunk->is_used(j)) {
+				dirty_clusters.insert(_get_cluster(chunk->get_cell_coords(j)));
+			}
+		}
+	}
+	dirty.set();
+}
+
+RTileMapPathfinding::~RTileMapPathfinding() {
+	for (uint32_t i = 0; i < flow_fields.size(); i++) {
+		memdelete(flow_fields[i]);
+	}
+}
@@ -0,0 +1,170 @@
+/*************************************************************************/
+/*  rtile_map_pathfinding.h                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#ifndef RTILE_MAP_PATHFINDING_H
+#define RTILE_MAP_PATHFINDING_H
+
+#include "core/hash_map.h"
+#include "core/local_vector.h"
+#include "core/os/mutex.h"
+#include "core/safe_refcount.h"
+#include "core/set.h"
+
+#include "rtile_map_cell_storage.h"
+#include "rtile_set.h"
+
+class RTileMap;
+
+// Grid pathfinding over the cells of a TileMap layer, moving between side neighbors.
+// The layer is split into square clusters of the quadrant size. The border cells of a cluster leading to another cluster
+// are the nodes of an abstract graph, linked by the cost of the paths between them inside each cluster. Long paths are
+// searched on the abstract graph first, then expanded into cells (HPA*).
+// Clusters are rebuilt before the next query when their cells change. Queries are made from the main thread, like the
+// edits. Batched queries then run on worker threads, which only read the graph.
+class RTileMapPathfinding {
+public:
+	enum {
+		FLOW_FIELD_NO_DIRECTION = 255,
+		FLOW_FIELDS_CACHE_SIZE = 16,
+	};
+
+	struct PathQuery {
+		Vector2i from;
+		Vector2i to;
+		PoolVector2Array path;
+	};
+
+private:
+	struct Edge {
+		Vector2i to;
+		real_t cost = 0.0;
+		bool leaves_cluster = false;
+		Vector<Vector2i> path; // The cells after the start one, up to the end one.
+	};
+
+	struct Node {
+		LocalVector<Edge> edges;
+	};
+
+	struct Transition {
+		Vector2i from; // In the cluster.
+		Vector2i to; // In the neighbor cluster.
+	};
+
+	struct TransitionComparator {
+		bool operator()(const Transition &p_a, const Transition &p_b) const;
+	};
+
+	struct Cluster {
+		LocalVector<Vector2i> nodes;
+		LocalVector<Transition> transitions;
+	};
+
+	struct SearchCell {
+		Vector2i parent;
+		real_t cost = 0.0;
+		bool closed = false;
+	};
+	typedef HashMap<Vector2i, SearchCell, RTileMapCoordsHasher> SearchCells;
+
+	// Costs to the closest goal over a region, and the neighbor to move to from each cell.
+	struct FlowField {
+		Rect2i region;
+		Vector<Vector2i> goals; // Sorted.
+		LocalVector<real_t> integration; // Infinite when no goal can be reached.
+		LocalVector<uint8_t> directions; // A CellNeighbor, or FLOW_FIELD_NO_DIRECTION on goals and unreachable cells.
+		Set<Vector2i> dirty_clusters;
+		uint64_t last_used = 0;
+	};
+
+	struct OpenCell {
+		real_t priority = 0.0;
+		Vector2i coords;
+	};
+
+	const RTileMap *tile_map = nullptr;
+	const RTileSet *tile_set = nullptr;
+	const RTileMapCellStorage *cells = nullptr;
+	int cluster_size = 16;
+	int custom_data_layer = -1; // Cells are walkable if they have a navigation polygon when negative.
+	LocalVector<RTileSet::CellNeighbor> neighbors;
+	real_t max_step_length = 1.0;
+	real_t min_cell_cost = 1.0; // Never above the cost of a walkable cell seen so far.
+
+	HashMap<Vector2i, Cluster, RTileMapCoordsHasher> clusters;
+	HashMap<Vector2i, Node, RTileMapCoordsHasher> nodes;
+	Set<Vector2i> dirty_clusters;
+	SafeFlag dirty;
+
+	LocalVector<FlowField *> flow_fields;
+	uint64_t flow_fields_uses = 0;
+	Mutex flow_fields_mutex;
+
+	_FORCE_INLINE_ Vector2i _get_cluster(const Vector2i &p_coords) const {
+		// Rounding down, like quadrant coordinates.
+		return Vector2i(
+				p_coords.x >= 0 ? p_coords.x / cluster_size : (p_coords.x - (cluster_size - 1)) / cluster_size,
+				p_coords.y >= 0 ? p_coords.y / cluster_size : (p_coords.y - (cluster_size - 1)) / cluster_size);
+	}
+	Vector2i _get_neighbor(const Vector2i &p_coords, int p_neighbor_index) const;
+	real_t _get_heuristic(const Vector2i &p_from, const Vector2i &p_to) const;
+
+	static void _push_open_cell(LocalVector<OpenCell> &r_open, const OpenCell &p_cell);
+	static OpenCell _pop_open_cell(LocalVector<OpenCell> &r_open);
+
+	// A* towards p_goal, or Dijkstra over the whole cluster without goal. Restricted to p_cluster when given.
+	bool _search(const Vector2i &p_from, const Vector2i *p_goal, const Vector2i *p_cluster, SearchCells &r_cells) const;
+	static Vector<Vector2i> _get_search_path(const SearchCells &p_cells, const Vector2i &p_from, const Vector2i &p_to, bool p_reversed);
+
+	void _rebuild_cluster(const Vector2i &p_cluster, bool p_cells_changed);
+	void _compute_flow_field(FlowField *p_field, bool p_full) const;
+	void _update();
+
+public:
+	real_t get_cell_cost(const Vector2i &p_coords) const;
+
+	void make_cell_dirty(const Vector2i &p_coords);
+
+	PoolVector2Array find_path(const Vector2i &p_from, const Vector2i &p_to);
+	void process_query(uint32_t p_index, PathQuery *p_queries);
+	void prepare_queries(); // Updates the graph before running queries on worker threads.
+
+	// Cached per region and goals, and recomputed around the changed clusters only.
+	void get_flow_field(const Rect2i &p_region, const Vector<Vector2i> &p_goals, PoolByteArray *r_directions, PoolRealArray *r_integration);
+
+	int get_clusters_count() const { return clusters.size(); }
+	int get_nodes_count() const { return nodes.size(); }
+
+	RTileMapPathfinding(const RTileMap *p_tile_map, const RTileMapCellStorage *p_cells, int p_custom_data_layer);
+	~RTileMapPathfinding();
+};
+
+#endif // RTILE_MAP_PATHFINDING_H
@@ -0,0 +1,195 @@
+/*************************************************************************/
+/*  rtile_map_streaming.cpp                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#include "rtile_map_streaming.h"
+
+#include "core/os/dir_access.h"
+#include "core/os/file_access.h"
+#include "core/os/os.h"
+
+// Region files: the "RTMR" magic, a uint32 version, a uint32 layers count, then each layer as a uint32 size and its encoded cells.
+static const uint32_t REGION_FILE_VERSION = 1;
+
+void RTileMapRegionStreamer::_thread_func(void *p_userdata) {
+	RTileMapRegionStreamer *streamer = (RTileMapRegionStreamer *)p_userdata;
+	while (true) {
+		streamer->semaphore.wait();
+
+		streamer->mutex.lock();
+		if (streamer->requests.empty()) {
+			streamer->mutex.unlock();
+			if (streamer->exit.is_set()) {
+				break;
+			}
+			continue;
+		}
+		Request request = streamer->requests.front()->get();
+		streamer->requests.pop_front();
+		streamer->mutex.unlock();
+
+		if (request.save) {
+			streamer->_save(request);
+		} else {
+			streamer->_load(request);
+		}
+		streamer->pending_count.decrement();
+	}
+}
+
+void RTileMapRegionStreamer::_load(const Request &p_request) {
+	LoadedRegion region;
+	region.coords = p_request.coords;
+
+	String path = get_region_path(p_request.coords);
+	if (FileAccess::exists(path)) {
+		Error err;
+		FileAccess *f = FileAccess::open(path, FileAccess::READ, &err);
+		if (f) {
+			uint8_t magic[4];
+			f->get_buffer(magic, 4);
+			uint32_t version = f->get_32();
+			if (magic[0] == 'R' && magic[1] == 'T' && magic[2] == 'M' && magic[3] == 'R' && version == REGION_FILE_VERSION) {
+				uint32_t layers_count = f->get_32();
+				Vector<uint8_t> data;
+				for (uint32_t layer = 0; layer < layers_count && !f->eof_reached(); layer++) {
+					uint32_t size = f->get_32();
+					data.resize(size);
+					if (f->get_buffer(data.ptrw(), size) != size) {
+						ERR_PRINT(vformat("Truncated TileMap region file: %s.", path));
+						break;
+					}
+					RTileMapCellStorage *storage = memnew(RTileMapCellStorage);
+					if (storage->decode(data) != OK) {
+						ERR_PRINT(vformat("Corrupted TileMap region file: %s.", path));
+						storage->clear();
+					}
+					region.layers.push_back(storage);
+				}
+			} else {
+				ERR_PRINT(vformat("Invalid TileMap region file: %s.", path));
+			}
+			memdelete(f);
+		} else {
+			ERR_PRINT(vformat("Cannot open TileMap region file: %s.", path));
+		}
+	}
+
+	MutexLock lock(mutex);
+	loaded_regions.push_back(region);
+}
+
+void RTileMapRegionStreamer::_save(const Request &p_request) {
+	String path = get_region_path(p_request.coords);
+
+	Error err;
+	FileAccess *f = FileAccess::open(path, FileAccess::WRITE, &err);
+	ERR_FAIL_COND_MSG(!f, vformat("Cannot write TileMap region file: %s.", path));
+
+	const uint8_t magic[4] = { 'R', 'T', 'M', 'R' };
+	f->store_buffer(magic, 4);
+	f->store_32(REGION_FILE_VERSION);
+	f->store_32(p_request.layers_data.size());
+	for (uint32_t layer = 0; layer < p_request.layers_data.size(); layer++) {
+		const Vector<uint8_t> &data = p_request.layers_data[layer];
+		f->store_32(data.size());
+		f->store_buffer(data.ptr(), data.size());
+	}
+	memdelete(f);
+}
+
+String RTileMapRegionStreamer::get_region_path(const Vector2i &p_coords) const {
+	return directory.plus_file(vformat("region_%d_%d.rtmr", p_coords.x, p_coords.y));
+}
+
+void RTileMapRegionStreamer::request_load(const Vector2i &p_coords) {
+	Request request;
+	request.coords = p_coords;
+
+	pending_count.increment();
+	mutex.lock();
+	requests.push_back(request);
+	mutex.unlock();
+	semaphore.post();
+}
+
+void RTileMapRegionStreamer::request_save(const Vector2i &p_coords, const LocalVector<Vector<uint8_t>> &p_layers_data) {
+	Request request;
+	request.save = true;
+	request.coords = p_coords;
+	request.layers_data = p_layers_data;
+
+	pending_count.increment();
+	mutex.lock();
+	requests.push_back(request);
+	mutex.unlock();
+	semaphore.post();
+}
+
+void RTileMapRegionStreamer::take_loaded_regions(LocalVector<LoadedRegion> &r_regions) {
+	MutexLock lock(mutex);
+	for (uint32_t i = 0; i < loaded_regions.size(); i++) {
+		r_regions.push_back(loaded_regions[i]);
+	}
+	loaded_regions.clear();
+}
+
+void RTileMapRegionStreamer::wait_for_requests() {
+	while (pending_count.get() > 0) {
+		OS::get_singleton()->delay_usec(100);
+	}
+}
+
+RTileMapRegionStreamer::RTileMapRegionStreamer(const String &p_directory) {
+	directory = p_directory;
+
+	DirAccess *da = DirAccess::create_for_path(directory);
+	if (da) {
+		if (!da->dir_exists(directory)) {
+			da->make_dir_recursive(directory);
+		}
+		memdelete(da);
+	}
+
+	thread.start(&RTileMapRegionStreamer::_thread_func, this);
+}
+
+RTileMapRegionStreamer::~RTileMapRegionStreamer() {
+	exit.set();
+	semaphore.post();
+	thread.wait_to_finish();
+
+	// Regions loaded but never taken.
+	for (uint32_t i = 0; i < loaded_regions.size(); i++) {
+		for (uint32_t layer = 0; layer < loaded_regions[i].layers.size(); layer++) {
+			memdelete(loaded_regions[i].layers[layer]);
+		}
+	}
+}
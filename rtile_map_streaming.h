@@ -0,0 +1,89 @@
+/*************************************************************************/
+/*  rtile_map_streaming.h                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#ifndef RTILE_MAP_STREAMING_H
+#define RTILE_MAP_STREAMING_H
+
+#include "core/list.h"
+#include "core/local_vector.h"
+#include "core/os/mutex.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
+#include "core/safe_refcount.h"
+#include "core/ustring.h"
+
+#include "rtile_map_cell_storage.h"
+
+// Reads and writes the region files of a streamed TileMap on a background thread.
+// A region file holds, for each layer, the cells of a block of quadrants encoded by RTileMapCellStorage::encode().
+// Requests are processed in order, so a region saved then loaded again reads what was saved.
+class RTileMapRegionStreamer {
+public:
+	struct LoadedRegion {
+		Vector2i coords;
+		LocalVector<RTileMapCellStorage *> layers; // Owned by the receiver. Empty if the region has no file yet.
+	};
+
+private:
+	struct Request {
+		bool save = false;
+		Vector2i coords;
+		LocalVector<Vector<uint8_t>> layers_data; // Encoded layers to save.
+	};
+
+	String directory;
+
+	Thread thread;
+	Semaphore semaphore;
+	SafeFlag exit;
+	SafeNumeric<uint32_t> pending_count;
+
+	Mutex mutex;
+	List<Request> requests;
+	LocalVector<LoadedRegion> loaded_regions;
+
+	static void _thread_func(void *p_userdata);
+	void _load(const Request &p_request);
+	void _save(const Request &p_request);
+
+public:
+	String get_region_path(const Vector2i &p_coords) const;
+
+	void request_load(const Vector2i &p_coords);
+	void request_save(const Vector2i &p_coords, const LocalVector<Vector<uint8_t>> &p_layers_data);
+	void take_loaded_regions(LocalVector<LoadedRegion> &r_regions);
+	void wait_for_requests(); // Blocks until the queued requests are processed.
+
+	RTileMapRegionStreamer(const String &p_directory);
+	~RTileMapRegionStreamer(); // Processes the queued requests first.
+};
+
+#endif // RTILE_MAP_STREAMING_H
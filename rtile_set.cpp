@@ -455,6 +455,110 @@ void RTileSet::_update_terrains_cache() {
 			empty_cell.alternative_tile = RTileSetSource::INVALID_TILE_ALTERNATIVE;
 			per_terrain_pattern_tiles[i][empty_pattern].insert(empty_cell);
 		}
+
+		// Index the patterns of each terrain set.
+		per_terrain_set_patterns_table.resize(terrain_sets.size());
+		for (int terrain_set = 0; terrain_set < terrain_sets.size(); terrain_set++) {
+			TerrainsPatternsTable &table = per_terrain_set_patterns_table[terrain_set];
+			table.patterns.clear();
+			table.patterns_terrains_counts.clear();
+			table.bits.clear();
+			for (const Map<RTileSet::TerrainsPattern, Set<RTileMapCell>>::Element *kv = per_terrain_pattern_tiles[terrain_set].front(); kv; kv = kv->next()) {
+				table.patterns.push_back(kv->key());
+			}
+			for (int i = 0; i < RTileSet::CELL_NEIGHBOR_MAX; i++) {
+				if (is_valid_peering_bit_terrain(terrain_set, CellNeighbor(i))) {
+					table.bits.push_back(CellNeighbor(i));
+				}
+			}
+			table.words_count = MAX((table.patterns.size() + 63) / 64, 1u);
+			table.terrains_count = terrain_sets[terrain_set].terrains.size() + 1;
+
+			table.masks.resize(RTileSet::CELL_NEIGHBOR_MAX * table.terrains_count * table.words_count);
+			for (uint32_t i = 0; i < table.masks.size(); i++) {
+				table.masks[i] = 0;
+			}
+			table.patterns_terrains_counts.resize(table.patterns.size());
+			for (uint32_t pattern_index = 0; pattern_index < table.patterns.size(); pattern_index++) {
+				Set<int> terrains;
+				for (uint32_t i = 0; i < table.bits.size(); i++) {
+					int terrain = table.patterns[pattern_index].get_terrain(table.bits[i]);
+					terrains.insert(terrain);
+					uint64_t *mask = const_cast<uint64_t *>(table.get_mask(table.bits[i], terrain));
+					if (mask) {
+						mask[pattern_index / 64] |= uint64_t(1) << (pattern_index % 64);
+					}
+				}
+				table.patterns_terrains_counts[pattern_index] = terrains.size();
+			}
+
+			// Alias tables over the probabilities of the tiles of each pattern (Vose's method).
+			table.patterns_tiles_offsets.clear();
+			table.tiles.clear();
+			table.tiles_thresholds.clear();
+			table.tiles_aliases.clear();
+			LocalVector<double> weights;
+			LocalVector<uint32_t> small;
+			LocalVector<uint32_t> large;
+			for (uint32_t pattern_index = 0; pattern_index < table.patterns.size(); pattern_index++) {
+				uint32_t offset = table.tiles.size();
+				table.patterns_tiles_offsets.push_back(offset);
+
+				double sum = 0.0;
+				weights.clear();
+				const Set<RTileMapCell> &pattern_tiles = per_terrain_pattern_tiles[terrain_set][table.patterns[pattern_index]];
+				for (const Set<RTileMapCell>::Element *E = pattern_tiles.front(); E; E = E->next()) {
+					double weight = 1.0;
+					if (E->get().source_id >= 0) {
+						Ref<RTileSetAtlasSource> atlas_source = sources[E->get().source_id];
+						if (atlas_source.is_valid()) {
+							RTileData *tile_data = Object::cast_to<RTileData>(atlas_source->get_tile_data(E->get().get_atlas_coords(), E->get().alternative_tile));
+							weight = tile_data->get_probability();
+						}
+					}
+					table.tiles.push_back(E->get());
+					weights.push_back(weight);
+					sum += weight;
+				}
+
+				uint32_t count = weights.size();
+				table.tiles_thresholds.resize(offset + count);
+				table.tiles_aliases.resize(offset + count);
+				small.clear();
+				large.clear();
+				for (uint32_t i = 0; i < count; i++) {
+					// Scaled so that the average is 1. Tiles all with a null probability are equally likely.
+					weights[i] = sum > 0.0 ? weights[i] * count / sum : 1.0;
+					if (weights[i] < 1.0) {
+						small.push_back(i);
+					} else {
+						large.push_back(i);
+					}
+				}
+				while (!small.empty() && !large.empty()) {
+					uint32_t less = small[small.size() - 1];
+					uint32_t more = large[large.size() - 1];
+					small.resize(small.size() - 1);
+					table.tiles_thresholds[offset + less] = weights[less];
+					table.tiles_aliases[offset + less] = more;
+					weights[more] = weights[more] + weights[less] - 1.0;
+					if (weights[more] < 1.0) {
+						large.resize(large.size() - 1);
+						small.push_back(more);
+					}
+				}
+				// What remains is 1, up to rounding errors.
+				for (uint32_t i = 0; i < large.size(); i++) {
+					table.tiles_thresholds[offset + large[i]] = 1.0;
+					table.tiles_aliases[offset + large[i]] = large[i];
+				}
+				for (uint32_t i = 0; i < small.size(); i++) {
+					table.tiles_thresholds[offset + small[i]] = 1.0;
+					table.tiles_aliases[offset + small[i]] = small[i];
+				}
+			}
+			table.patterns_tiles_offsets.push_back(table.tiles.size());
+		}
 		terrains_cache_dirty = false;
 	}
 }
@@ -1130,18 +1234,45 @@ Variant::Type RTileSet::get_custom_data_type(int p_layer_id) const {
 	return custom_data_layers[p_layer_id].type;
 }
 
+uint64_t RTileSet::_get_coords_level_proxy_key(int p_source, const Vector2i &p_coords) {
+	return RTileMapCell(p_source, p_coords, RTileSetSource::INVALID_TILE_ALTERNATIVE)._u64t;
+}
+
+Vector<RTileMapCell> RTileSet::_get_sorted_proxy_keys(const HashMap<uint64_t, RTileMapCell> &p_proxies) {
+	Vector<RTileMapCell> keys;
+	const uint64_t *key = nullptr;
+	while ((key = p_proxies.next(key))) {
+		RTileMapCell cell;
+		cell._u64t = *key;
+		keys.push_back(cell);
+	}
+	keys.sort();
+	return keys;
+}
+
+Vector<int> RTileSet::_get_sorted_source_level_proxy_keys() const {
+	Vector<int> keys;
+	const int *key = nullptr;
+	while ((key = source_level_proxies.next(key))) {
+		keys.push_back(*key);
+	}
+	keys.sort();
+	return keys;
+}
+
 void RTileSet::set_source_level_tile_proxy(int p_source_from, int p_source_to) {
 	ERR_FAIL_COND(p_source_from == RTileSet::INVALID_SOURCE || p_source_to == RTileSet::INVALID_SOURCE);
 
-	source_level_proxies[p_source_from] = p_source_to;
+	source_level_proxies.set(p_source_from, p_source_to);
 
 	emit_changed();
 }
 
 int RTileSet::get_source_level_tile_proxy(int p_source_from) {
-	ERR_FAIL_COND_V(!source_level_proxies.has(p_source_from), RTileSet::INVALID_SOURCE);
+	const int *source_to = source_level_proxies.getptr(p_source_from);
+	ERR_FAIL_COND_V(!source_to, RTileSet::INVALID_SOURCE);
 
-	return source_level_proxies[p_source_from];
+	return *source_to;
 }
 
 bool RTileSet::has_source_level_tile_proxy(int p_source_from) {
@@ -1163,42 +1294,27 @@ void RTileSet::set_coords_level_tile_proxy(int p_source_from, Vector2 p_coords_f
 	ERR_FAIL_COND(p_source_from == RTileSet::INVALID_SOURCE || p_source_to == RTileSet::INVALID_SOURCE);
 	ERR_FAIL_COND(p_coords_from == RTileSetSource::INVALID_ATLAS_COORDS || p_coords_to == RTileSetSource::INVALID_ATLAS_COORDS);
 
-	Array from;
-	from.push_back(p_source_from);
-	from.push_back(p_coords_from_v);
-
-	Array to;
-	to.push_back(p_source_to);
-	to.push_back(p_coords_to_v);
-
-	coords_level_proxies[from] = to;
+	coords_level_proxies.set(_get_coords_level_proxy_key(p_source_from, p_coords_from), RTileMapCell(p_source_to, p_coords_to, RTileSetSource::INVALID_TILE_ALTERNATIVE));
 
 	emit_changed();
 }
 
 Array RTileSet::get_coords_level_tile_proxy(int p_source_from, Vector2 p_coords_from) {
-	Array from;
-	from.push_back(p_source_from);
-	from.push_back(p_coords_from);
-
-	ERR_FAIL_COND_V(!coords_level_proxies.has(from), Array());
+	const RTileMapCell *to = coords_level_proxies.getptr(_get_coords_level_proxy_key(p_source_from, p_coords_from));
+	ERR_FAIL_COND_V(!to, Array());
 
-	return coords_level_proxies[from];
+	Array output;
+	output.push_back(to->source_id);
+	output.push_back(to->get_atlas_coords());
+	return output;
 }
 
 bool RTileSet::has_coords_level_tile_proxy(int p_source_from, Vector2 p_coords_from) {
-	Array from;
-	from.push_back(p_source_from);
-	from.push_back(p_coords_from);
-
-	return coords_level_proxies.has(from);
+	return coords_level_proxies.has(_get_coords_level_proxy_key(p_source_from, p_coords_from));
 }
 
 void RTileSet::remove_coords_level_tile_proxy(int p_source_from, Vector2 p_coords_from) {
-	Array from;
-	from.push_back(p_source_from);
-	from.push_back(p_coords_from);
-
+	uint64_t from = _get_coords_level_proxy_key(p_source_from, p_coords_from);
 	ERR_FAIL_COND(!coords_level_proxies.has(from));
 
 	coords_level_proxies.erase(from);
@@ -1210,47 +1326,28 @@ void RTileSet::set_alternative_level_tile_proxy(int p_source_from, Vector2 p_coo
 	ERR_FAIL_COND(p_source_from == RTileSet::INVALID_SOURCE || p_source_to == RTileSet::INVALID_SOURCE);
 	ERR_FAIL_COND(p_coords_from == RTileSetSource::INVALID_ATLAS_COORDS || p_coords_to == RTileSetSource::INVALID_ATLAS_COORDS);
 
-	Array from;
-	from.push_back(p_source_from);
-	from.push_back(p_coords_from);
-	from.push_back(p_alternative_from);
-
-	Array to;
-	to.push_back(p_source_to);
-	to.push_back(p_coords_to);
-	to.push_back(p_alternative_to);
-
-	alternative_level_proxies[from] = to;
+	alternative_level_proxies.set(RTileMapCell(p_source_from, p_coords_from, p_alternative_from)._u64t, RTileMapCell(p_source_to, p_coords_to, p_alternative_to));
 
 	emit_changed();
 }
 
 Array RTileSet::get_alternative_level_tile_proxy(int p_source_from, Vector2 p_coords_from, int p_alternative_from) {
-	Array from;
-	from.push_back(p_source_from);
-	from.push_back(p_coords_from);
-	from.push_back(p_alternative_from);
-
-	ERR_FAIL_COND_V(!alternative_level_proxies.has(from), Array());
+	const RTileMapCell *to = alternative_level_proxies.getptr(RTileMapCell(p_source_from, p_coords_from, p_alternative_from)._u64t);
+	ERR_FAIL_COND_V(!to, Array());
 
-	return alternative_level_proxies[from];
+	Array output;
+	output.push_back(to->source_id);
+	output.push_back(to->get_atlas_coords());
+	output.push_back(to->alternative_tile);
+	return output;
 }
 
 bool RTileSet::has_alternative_level_tile_proxy(int p_source_from, Vector2 p_coords_from, int p_alternative_from) {
-	Array from;
-	from.push_back(p_source_from);
-	from.push_back(p_coords_from);
-	from.push_back(p_alternative_from);
-
-	return alternative_level_proxies.has(from);
+	return alternative_level_proxies.has(RTileMapCell(p_source_from, p_coords_from, p_alternative_from)._u64t);
 }
 
 void RTileSet::remove_alternative_level_tile_proxy(int p_source_from, Vector2 p_coords_from, int p_alternative_from) {
-	Array from;
-	from.push_back(p_source_from);
-	from.push_back(p_coords_from);
-	from.push_back(p_alternative_from);
-
+	uint64_t from = RTileMapCell(p_source_from, p_coords_from, p_alternative_from)._u64t;
 	ERR_FAIL_COND(!alternative_level_proxies.has(from));
 
 	alternative_level_proxies.erase(from);
@@ -1261,10 +1358,11 @@ void RTileSet::remove_alternative_level_tile_proxy(int p_source_from, Vector2 p_
 Array RTileSet::get_source_level_tile_proxies() const {
 	Array output;
 
-	for (const Map<int, int>::Element *E = source_level_proxies.front(); E; E = E->next()) {
+	Vector<int> keys = _get_sorted_source_level_proxy_keys();
+	for (int i = 0; i < keys.size(); i++) {
 		Array proxy;
-		proxy.push_back(E->key());
-		proxy.push_back(E->value());
+		proxy.push_back(keys[i]);
+		proxy.push_back(source_level_proxies[keys[i]]);
 		output.push_back(proxy);
 	}
 	return output;
@@ -1273,10 +1371,14 @@ Array RTileSet::get_source_level_tile_proxies() const {
 Array RTileSet::get_coords_level_tile_proxies() const {
 	Array output;
 
-	for (const Map<Array, Array>::Element *E = coords_level_proxies.front(); E; E = E->next()) {
+	Vector<RTileMapCell> keys = _get_sorted_proxy_keys(coords_level_proxies);
+	for (int i = 0; i < keys.size(); i++) {
+		const RTileMapCell &to = coords_level_proxies[keys[i]._u64t];
 		Array proxy;
-		proxy.append_array(E->key());
-		proxy.append_array(E->value());
+		proxy.push_back(keys[i].source_id);
+		proxy.push_back(keys[i].get_atlas_coords());
+		proxy.push_back(to.source_id);
+		proxy.push_back(to.get_atlas_coords());
 		output.push_back(proxy);
 	}
 	return output;
@@ -1285,97 +1387,89 @@ Array RTileSet::get_coords_level_tile_proxies() const {
 Array RTileSet::get_alternative_level_tile_proxies() const {
 	Array output;
 
-	for (const Map<Array, Array>::Element *E = alternative_level_proxies.front(); E; E = E->next()) {
+	Vector<RTileMapCell> keys = _get_sorted_proxy_keys(alternative_level_proxies);
+	for (int i = 0; i < keys.size(); i++) {
+		const RTileMapCell &to = alternative_level_proxies[keys[i]._u64t];
 		Array proxy;
-		proxy.append_array(E->key());
-		proxy.append_array(E->value());
+		proxy.push_back(keys[i].source_id);
+		proxy.push_back(keys[i].get_atlas_coords());
+		proxy.push_back(keys[i].alternative_tile);
+		proxy.push_back(to.source_id);
+		proxy.push_back(to.get_atlas_coords());
+		proxy.push_back(to.alternative_tile);
 		output.push_back(proxy);
 	}
 	return output;
 }
 
 Array RTileSet::map_tile_proxy(int p_source_from, Vector2 p_coords_from, int p_alternative_from) const {
-	Array from;
-	from.push_back(p_source_from);
-	from.push_back(p_coords_from);
-	from.push_back(p_alternative_from);
+	RTileMapCell to = map_tile_proxy_fast(RTileMapCell(p_source_from, p_coords_from, p_alternative_from));
+
+	Array output;
+	output.push_back(to.source_id);
+	output.push_back(to.get_atlas_coords());
+	output.push_back(to.alternative_tile);
+	return output;
+}
 
+RTileMapCell RTileSet::map_tile_proxy_fast(const RTileMapCell &p_cell) const {
 	// Check if the tile is valid, and if so, don't map the tile and return the input.
-	if (has_source(p_source_from)) {
-		Ref<RTileSetSource> source = get_source(p_source_from);
-		if (source->has_tile(p_coords_from) && source->has_alternative_tile(p_coords_from, p_alternative_from)) {
-			return from;
-		}
+	const Map<int, Ref<RTileSetSource>>::Element *E = sources.find(p_cell.source_id);
+	if (E && E->get()->has_tile(p_cell.get_atlas_coords()) && E->get()->has_alternative_tile(p_cell.get_atlas_coords(), p_cell.alternative_tile)) {
+		return p_cell;
 	}
 
 	// Source, coords and alternative match.
-	if (alternative_level_proxies.has(from)) {
-		return alternative_level_proxies[from].duplicate();
+	const RTileMapCell *alternative_to = alternative_level_proxies.getptr(p_cell._u64t);
+	if (alternative_to) {
+		return *alternative_to;
 	}
 
 	// Source and coords match.
-	from.pop_back();
-	if (coords_level_proxies.has(from)) {
-		Array output = coords_level_proxies[from].duplicate();
-		output.push_back(p_alternative_from);
+	const RTileMapCell *coords_to = coords_level_proxies.getptr(_get_coords_level_proxy_key(p_cell.source_id, p_cell.get_atlas_coords()));
+	if (coords_to) {
+		RTileMapCell output = *coords_to;
+		output.alternative_tile = p_cell.alternative_tile;
 		return output;
 	}
 
 	// Source matches.
-	if (source_level_proxies.has(p_source_from)) {
-		Array output;
-		output.push_back(source_level_proxies[p_source_from]);
-		output.push_back(p_coords_from);
-		output.push_back(p_alternative_from);
+	const int *source_to = source_level_proxies.getptr(p_cell.source_id);
+	if (source_to) {
+		RTileMapCell output = p_cell;
+		output.source_id = *source_to;
 		return output;
 	}
 
-	Array output;
-	output.push_back(p_source_from);
-	output.push_back(p_coords_from);
-	output.push_back(p_alternative_from);
-	return output;
+	return p_cell;
 }
 
 void RTileSet::cleanup_invalid_tile_proxies() {
 	// Source level.
-	Vector<int> source_to_remove;
-
-	for (const Map<int, int>::Element *E = source_level_proxies.front(); E; E = E->next()) {
-		if (has_source(E->key())) {
-			source_to_remove.push_back(E->key());
+	Vector<int> source_keys = _get_sorted_source_level_proxy_keys();
+	for (int i = 0; i < source_keys.size(); i++) {
+		if (has_source(source_keys[i])) {
+			remove_source_level_tile_proxy(source_keys[i]);
 		}
 	}
-	for (int i = 0; i < source_to_remove.size(); i++) {
-		remove_source_level_tile_proxy(source_to_remove[i]);
-	}
 
 	// Coords level.
-	Vector<Array> coords_to_remove;
-
-	for (const Map<Array, Array>::Element *E = coords_level_proxies.front(); E; E = E->next()) {
-		Array a = E->key();
-		if (has_source(a[0]) && get_source(a[0])->has_tile(a[1])) {
-			coords_to_remove.push_back(a);
+	Vector<RTileMapCell> coords_keys = _get_sorted_proxy_keys(coords_level_proxies);
+	for (int i = 0; i < coords_keys.size(); i++) {
+		const RTileMapCell &from = coords_keys[i];
+		if (has_source(from.source_id) && get_source(from.source_id)->has_tile(from.get_atlas_coords())) {
+			remove_coords_level_tile_proxy(from.source_id, from.get_atlas_coords());
 		}
 	}
-	for (int i = 0; i < coords_to_remove.size(); i++) {
-		Array a = coords_to_remove[i];
-		remove_coords_level_tile_proxy(a[0], a[1]);
-	}
 
 	// Alternative level.
-	Vector<Array> alternative_to_remove;
-	for (const Map<Array, Array>::Element *E = alternative_level_proxies.front(); E; E = E->next()) {
-		Array a = E->key();
-		if (has_source(a[0]) && get_source(a[0])->has_tile(a[1]) && get_source(a[0])->has_alternative_tile(a[1], a[2])) {
-			alternative_to_remove.push_back(a);
+	Vector<RTileMapCell> alternative_keys = _get_sorted_proxy_keys(alternative_level_proxies);
+	for (int i = 0; i < alternative_keys.size(); i++) {
+		const RTileMapCell &from = alternative_keys[i];
+		if (has_source(from.source_id) && get_source(from.source_id)->has_tile(from.get_atlas_coords()) && get_source(from.source_id)->has_alternative_tile(from.get_atlas_coords(), from.alternative_tile)) {
+			remove_alternative_level_tile_proxy(from.source_id, from.get_atlas_coords(), from.alternative_tile);
 		}
 	}
-	for (int i = 0; i < alternative_to_remove.size(); i++) {
-		Array a = alternative_to_remove[i];
-		remove_alternative_level_tile_proxy(a[0], a[1], a[2]);
-	}
 }
 
 void RTileSet::clear_tile_proxies() {
@@ -1386,6 +1480,120 @@ void RTileSet::clear_tile_proxies() {
 	emit_changed();
 }
 
+void RTileSet::_invalidate_tile_resolution_cache() {
+	MutexLock lock(tile_resolution_cache_mutex);
+	tile_resolution_cache_dirty.set();
+	tile_resolution_cache_version++;
+}
+
+void RTileSet::_add_proxied_tile_resolution(const RTileMapCell &p_from, const RTileMapCell &p_to) const {
+	// Valid tiles are never proxied, and proxies pointing to invalid tiles resolve to nothing.
+	if (tile_resolution_cache.has(p_from._u64t)) {
+		return;
+	}
+	const TileResolution *target = tile_resolution_cache.getptr(p_to._u64t);
+	if (!target || target->cell._u64t != p_to._u64t) {
+		return;
+	}
+	tile_resolution_cache.set(p_from._u64t, *target);
+}
+
+void RTileSet::_rebuild_tile_resolution_cache() const {
+	tile_resolution_cache.clear();
+
+	// Valid tiles resolve to themselves.
+	for (const Map<int, Ref<RTileSetSource>>::Element *E = sources.front(); E; E = E->next()) {
+		RTileSetSource *source = *E->get();
+		RTileSetAtlasSource *atlas_source = Object::cast_to<RTileSetAtlasSource>(source);
+		for (int tile_index = 0; tile_index < source->get_tiles_count(); tile_index++) {
+			Vector2 atlas_coords = source->get_tile_id(tile_index);
+			for (int alternative_index = 0; alternative_index < source->get_alternative_tiles_count(atlas_coords); alternative_index++) {
+				TileResolution resolution;
+				resolution.cell = RTileMapCell(E->key(), atlas_coords, source->get_alternative_tile_id(atlas_coords, alternative_index));
+				resolution.source = source;
+				if (atlas_source) {
+					resolution.atlas_source = atlas_source;
+					resolution.tile_data = Object::cast_to<RTileData>(atlas_source->get_tile_data(atlas_coords, resolution.cell.alternative_tile));
+					resolution.texture_region = atlas_source->get_runtime_tile_texture_region(atlas_coords, 0);
+				}
+				tile_resolution_cache.set(resolution.cell._u64t, resolution);
+			}
+		}
+	}
+
+	// Proxied tiles, with the same priorities as map_tile_proxy_fast().
+	const uint64_t *key = nullptr;
+	while ((key = alternative_level_proxies.next(key))) {
+		RTileMapCell from;
+		from._u64t = *key;
+		_add_proxied_tile_resolution(from, alternative_level_proxies[*key]);
+	}
+
+	key = nullptr;
+	while ((key = coords_level_proxies.next(key))) {
+		const RTileMapCell &to = coords_level_proxies[*key];
+		const Map<int, Ref<RTileSetSource>>::Element *E = sources.find(to.source_id);
+		if (!E || !E->get()->has_tile(to.get_atlas_coords())) {
+			continue;
+		}
+
+		// Alternative level proxies win over coords level ones, even when they are invalid.
+		RTileMapCell from;
+		from._u64t = *key;
+		for (int alternative_index = 0; alternative_index < E->get()->get_alternative_tiles_count(to.get_atlas_coords()); alternative_index++) {
+			int alternative = E->get()->get_alternative_tile_id(to.get_atlas_coords(), alternative_index);
+			from.alternative_tile = alternative;
+			if (alternative_level_proxies.has(from._u64t)) {
+				continue;
+			}
+			_add_proxied_tile_resolution(from, RTileMapCell(to.source_id, to.get_atlas_coords(), alternative));
+		}
+	}
+
+	const int *source_from = nullptr;
+	while ((source_from = source_level_proxies.next(source_from))) {
+		int source_to = source_level_proxies[*source_from];
+		const Map<int, Ref<RTileSetSource>>::Element *E = sources.find(source_to);
+		if (!E) {
+			continue;
+		}
+		const Ref<RTileSetSource> &source = E->get();
+
+		for (int tile_index = 0; tile_index < source->get_tiles_count(); tile_index++) {
+			Vector2 atlas_coords = source->get_tile_id(tile_index);
+
+			// Coords and alternative level proxies win over source level ones, even when they are invalid.
+			if (coords_level_proxies.has(_get_coords_level_proxy_key(*source_from, atlas_coords))) {
+				continue;
+			}
+			for (int alternative_index = 0; alternative_index < source->get_alternative_tiles_count(atlas_coords); alternative_index++) {
+				int alternative = source->get_alternative_tile_id(atlas_coords, alternative_index);
+				RTileMapCell from(*source_from, atlas_coords, alternative);
+				if (alternative_level_proxies.has(from._u64t)) {
+					continue;
+				}
+				_add_proxied_tile_resolution(from, RTileMapCell(source_to, atlas_coords, alternative));
+			}
+		}
+	}
+}
+
+const RTileSet::TileResolution *RTileSet::resolve_tile(const RTileMapCell &p_cell) const {
+	// Rebuilt on the first lookup after a change. Lookups may come from several threads at once.
+	if (tile_resolution_cache_dirty.is_set()) {
+		MutexLock lock(tile_resolution_cache_mutex);
+		if (tile_resolution_cache_dirty.is_set()) {
+			_rebuild_tile_resolution_cache();
+			tile_resolution_cache_dirty.clear();
+		}
+	}
+	return tile_resolution_cache.getptr(p_cell._u64t);
+}
+
+uint32_t RTileSet::get_tile_resolution_cache_version() const {
+	return tile_resolution_cache_version;
+}
+
 int RTileSet::add_pattern(Ref<RTileMapPattern> p_pattern, int p_index) {
 	ERR_FAIL_COND_V(!p_pattern.is_valid(), -1);
 	ERR_FAIL_COND_V_MSG(p_pattern->is_empty(), -1, "Cannot add an empty pattern to the TileSet.");
@@ -1422,66 +1630,83 @@ Set<RTileSet::TerrainsPattern> RTileSet::get_terrains_pattern_set(int p_terrain_
 
 	Set<RTileSet::TerrainsPattern> output;
 
-	for (const Map<RTileSet::TerrainsPattern, Set<RTileMapCell>>::Element *kv = per_terrain_pattern_tiles[p_terrain_set].front(); kv; kv = kv->next()) {
-		output.insert(kv->key());
+	const TerrainsPatternsTable &table = per_terrain_set_patterns_table[p_terrain_set];
+	for (uint32_t i = 0; i < table.patterns.size(); i++) {
+		output.insert(table.patterns[i]);
 	}
 	return output;
 }
 
-Set<RTileMapCell> RTileSet::get_tiles_for_terrains_pattern(int p_terrain_set, TerrainsPattern p_terrain_tile_pattern) {
-	ERR_FAIL_INDEX_V(p_terrain_set, terrain_sets.size(), Set<RTileMapCell>());
+const RTileSet::TerrainsPatternsTable *RTileSet::get_terrains_patterns_table(int p_terrain_set) {
+	ERR_FAIL_INDEX_V(p_terrain_set, terrain_sets.size(), nullptr);
 	_update_terrains_cache();
-	return per_terrain_pattern_tiles[p_terrain_set][p_terrain_tile_pattern];
+	return &per_terrain_set_patterns_table[p_terrain_set];
 }
 
-RTileMapCell RTileSet::get_random_tile_from_terrains_pattern(int p_terrain_set, RTileSet::TerrainsPattern p_terrain_tile_pattern) {
-	ERR_FAIL_INDEX_V(p_terrain_set, terrain_sets.size(), RTileMapCell());
-	_update_terrains_cache();
+void RTileSet::TerrainsPatternsTable::fill(uint64_t *r_patterns) const {
+	for (int i = 0; i < words_count; i++) {
+		r_patterns[i] = 0;
+	}
+	for (uint32_t pattern_index = 0; pattern_index < patterns.size(); pattern_index++) {
+		r_patterns[pattern_index / 64] |= uint64_t(1) << (pattern_index % 64);
+	}
+}
 
-	// Count the sum of probabilities.
-	double sum = 0.0;
-	Set<RTileMapCell> set = per_terrain_pattern_tiles[p_terrain_set][p_terrain_tile_pattern];
-	for (Set<RTileMapCell>::Element *E = set.front(); E; E = E->next()) {
-		if (E->get().source_id >= 0) {
-			Ref<RTileSetSource> source = sources[E->get().source_id];
-			Ref<RTileSetAtlasSource> atlas_source = source;
-			if (atlas_source.is_valid()) {
-				RTileData *tile_data = Object::cast_to<RTileData>(atlas_source->get_tile_data(E->get().get_atlas_coords(), E->get().alternative_tile));
-				sum += tile_data->get_probability();
-			} else {
-				sum += 1.0;
-			}
+int RTileSet::TerrainsPatternsTable::find_pattern(const TerrainsPattern &p_pattern) const {
+	// The patterns are sorted.
+	int low = 0;
+	int high = patterns.size();
+	while (low < high) {
+		int middle = (low + high) / 2;
+		if (patterns[middle] < p_pattern) {
+			low = middle + 1;
 		} else {
-			sum += 1.0;
+			high = middle;
 		}
 	}
+	if (low < (int)patterns.size() && patterns[low] == p_pattern) {
+		return low;
+	}
+	return -1;
+}
 
-	// Generate a random number.
-	double count = 0.0;
-	double picked = Math::random(0.0, sum);
+RTileMapCell RTileSet::TerrainsPatternsTable::pick_random_tile(int p_pattern_index, RandomPCG *p_rng) const {
+	ERR_FAIL_INDEX_V(p_pattern_index, (int)patterns.size(), RTileMapCell());
 
-	// Pick the tile.
-	for (Set<RTileMapCell>::Element *E = set.front(); E; E = E->next()) {
-		if (E->get().source_id >= 0) {
-			Ref<RTileSetSource> source = sources[E->get().source_id];
+	uint32_t offset = patterns_tiles_offsets[p_pattern_index];
+	uint32_t count = patterns_tiles_offsets[p_pattern_index + 1] - offset;
+	ERR_FAIL_COND_V(count == 0, RTileMapCell());
 
-			Ref<RTileSetAtlasSource> atlas_source = source;
-			if (atlas_source.is_valid()) {
-				RTileData *tile_data = Object::cast_to<RTileData>(atlas_source->get_tile_data(E->get().get_atlas_coords(), E->get().alternative_tile));
-				count += tile_data->get_probability();
-			} else {
-				count += 1.0;
-			}
-		} else {
-			count += 1.0;
-		}
+	uint32_t drawn = (p_rng ? p_rng->rand() : Math::rand()) % count;
+	float kept = p_rng ? p_rng->randf() : Math::randf();
+	if (kept >= tiles_thresholds[offset + drawn]) {
+		drawn = tiles_aliases[offset + drawn];
+	}
+	return tiles[offset + drawn];
+}
 
-		if (count >= picked) {
-			return E->get();
-		}
+void RTileSet::TerrainsPatternsTable::constrain(uint64_t *r_patterns, CellNeighbor p_bit, int p_terrain) const {
+	// Keeps the patterns with the given terrain on the bit. No pattern has a terrain out of the terrain set.
+	const uint64_t *mask = get_mask(p_bit, p_terrain);
+	for (int i = 0; i < words_count; i++) {
+		r_patterns[i] &= mask ? mask[i] : 0;
 	}
+}
+
+Set<RTileMapCell> RTileSet::get_tiles_for_terrains_pattern(int p_terrain_set, TerrainsPattern p_terrain_tile_pattern) {
+	ERR_FAIL_INDEX_V(p_terrain_set, terrain_sets.size(), Set<RTileMapCell>());
+	_update_terrains_cache();
+	return per_terrain_pattern_tiles[p_terrain_set][p_terrain_tile_pattern];
+}
+
+RTileMapCell RTileSet::get_random_tile_from_terrains_pattern(int p_terrain_set, RTileSet::TerrainsPattern p_terrain_tile_pattern, RandomPCG *p_rng) {
+	ERR_FAIL_INDEX_V(p_terrain_set, terrain_sets.size(), RTileMapCell());
+	_update_terrains_cache();
 
-	ERR_FAIL_V(RTileMapCell());
+	const TerrainsPatternsTable &table = per_terrain_set_patterns_table[p_terrain_set];
+	int pattern_index = table.find_pattern(p_terrain_tile_pattern);
+	ERR_FAIL_COND_V(pattern_index < 0, RTileMapCell());
+	return table.pick_random_tile(pattern_index, p_rng);
 }
 
 Vector<Vector2> RTileSet::get_tile_shape_polygon() {
@@ -1811,8 +2036,57 @@ Vector<Vector<Ref<Texture>>> RTileSet::generate_terrains_icons(Size2i p_size) {
 }
 
 void RTileSet::_source_changed() {
-	terrains_cache_dirty = true;
+	// Log the tile level changes. Any other change of a source is a full change.
+	LocalVector<RTileSetSource::TileChange> source_changes;
+	uint32_t aspects = 0;
+	for (const Map<int, Ref<RTileSetSource>>::Element *E = sources.front(); E; E = E->next()) {
+		source_changes.clear();
+		E->value()->take_pending_tile_changes(source_changes);
+		for (uint32_t i = 0; i < source_changes.size(); i++) {
+			if (tile_changes.size() >= TILE_CHANGES_MAX) {
+				// Too many changes to track, readers will do a full update.
+				tile_changes.clear();
+				tile_changes_full_version = tile_changes_version;
+			}
+			TileChange change;
+			change.tile = RTileMapCell(E->key(), source_changes[i].atlas_coords, source_changes[i].alternative_tile);
+			change.aspects = source_changes[i].aspects;
+			tile_changes.push_back(change);
+			tile_changes_version++;
+			aspects |= change.aspects;
+		}
+	}
+
+	if (aspects == 0 || (aspects & TILE_CHANGE_TERRAINS)) {
+		terrains_cache_dirty = true;
+	}
+	tile_changes_recorded = aspects != 0;
 	emit_changed();
+	tile_changes_recorded = false;
+}
+
+void RTileSet::_record_full_change() {
+	if (tile_changes_recorded) {
+		return; // Already logged by _source_changed().
+	}
+	tile_changes.clear();
+	tile_changes_version++;
+	tile_changes_full_version = tile_changes_version;
+}
+
+uint64_t RTileSet::get_tile_changes_version() const {
+	return tile_changes_version;
+}
+
+bool RTileSet::get_tile_changes_since(uint64_t p_version, LocalVector<TileChange> &r_changes) const {
+	// Fails when a full change happened since the given version, or when the changes are not logged anymore.
+	if (p_version < tile_changes_full_version || p_version + tile_changes.size() < tile_changes_version) {
+		return false;
+	}
+	for (uint32_t i = tile_changes.size() - (tile_changes_version - p_version); i < tile_changes.size(); i++) {
+		r_changes.push_back(tile_changes[i]);
+	}
+	return true;
 }
 
 Vector<Point2> RTileSet::_get_square_corner_or_side_terrain_bit_polygon(Vector2 p_size, RTileSet::CellNeighbor p_bit) {
@@ -3115,25 +3389,44 @@ bool RTileSet::_get(const StringName &p_name, Variant &r_ret) const {
 	} else if (components.size() == 2 && components[0] == "tile_proxies") {
 		if (components[1] == "source_level") {
 			Array a;
-			for (const Map<int, int>::Element *E = source_level_proxies.front(); E; E = E->next()) {
-				a.push_back(E->key());
-				a.push_back(E->value());
+			Vector<int> keys = _get_sorted_source_level_proxy_keys();
+			for (int i = 0; i < keys.size(); i++) {
+				a.push_back(keys[i]);
+				a.push_back(source_level_proxies[keys[i]]);
 			}
 			r_ret = a;
 			return true;
 		} else if (components[1] == "coords_level") {
 			Array a;
-			for (const Map<Array, Array>::Element *E = coords_level_proxies.front(); E; E = E->next()) {
-				a.push_back(E->key());
-				a.push_back(E->value());
+			Vector<RTileMapCell> keys = _get_sorted_proxy_keys(coords_level_proxies);
+			for (int i = 0; i < keys.size(); i++) {
+				const RTileMapCell &to = coords_level_proxies[keys[i]._u64t];
+				Array from_array;
+				from_array.push_back(keys[i].source_id);
+				from_array.push_back(keys[i].get_atlas_coords());
+				Array to_array;
+				to_array.push_back(to.source_id);
+				to_array.push_back(to.get_atlas_coords());
+				a.push_back(from_array);
+				a.push_back(to_array);
 			}
 			r_ret = a;
 			return true;
 		} else if (components[1] == "alternative_level") {
 			Array a;
-			for (const Map<Array, Array>::Element *E = alternative_level_proxies.front(); E; E = E->next()) {
-				a.push_back(E->key());
-				a.push_back(E->value());
+			Vector<RTileMapCell> keys = _get_sorted_proxy_keys(alternative_level_proxies);
+			for (int i = 0; i < keys.size(); i++) {
+				const RTileMapCell &to = alternative_level_proxies[keys[i]._u64t];
+				Array from_array;
+				from_array.push_back(keys[i].source_id);
+				from_array.push_back(keys[i].get_atlas_coords());
+				from_array.push_back(keys[i].alternative_tile);
+				Array to_array;
+				to_array.push_back(to.source_id);
+				to_array.push_back(to.get_atlas_coords());
+				to_array.push_back(to.alternative_tile);
+				a.push_back(from_array);
+				a.push_back(to_array);
 			}
 			r_ret = a;
 			return true;
@@ -3352,6 +3645,8 @@ void RTileSet::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_patterns_count"), &RTileSet::get_patterns_count);
 
 	ClassDB::bind_method(D_METHOD("_source_changed"), &RTileSet::_source_changed);
+	ClassDB::bind_method(D_METHOD("_invalidate_tile_resolution_cache"), &RTileSet::_invalidate_tile_resolution_cache);
+	ClassDB::bind_method(D_METHOD("_record_full_change"), &RTileSet::_record_full_change);
 
 	ADD_GROUP("Rendering", "");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "uv_clipping"), "set_uv_clipping", "is_uv_clipping");
@@ -3415,6 +3710,11 @@ RTileSet::RTileSet() {
 	// Instantiate the tile meshes.
 	tile_lines_mesh.instance();
 	tile_filled_mesh.instance();
+
+	// Any change may invalidate the resolved tiles.
+	tile_resolution_cache_dirty.set();
+	connect(CoreStringNames::get_singleton()->changed, this, "_invalidate_tile_resolution_cache");
+	connect(CoreStringNames::get_singleton()->changed, this, "_record_full_change");
 }
 
 RTileSet::~RTileSet() {
@@ -3434,6 +3734,22 @@ void RTileSetSource::set_tile_set(const RTileSet *p_tile_set) {
 	tile_set = p_tile_set;
 }
 
+void RTileSetSource::_notify_tile_changed(const Vector2i &p_atlas_coords, int p_alternative_tile, uint32_t p_aspects) {
+	TileChange change;
+	change.atlas_coords = p_atlas_coords;
+	change.alternative_tile = p_alternative_tile;
+	change.aspects = p_aspects;
+	pending_tile_changes.push_back(change);
+	emit_signal("changed");
+}
+
+void RTileSetSource::take_pending_tile_changes(LocalVector<TileChange> &r_changes) {
+	for (uint32_t i = 0; i < pending_tile_changes.size(); i++) {
+		r_changes.push_back(pending_tile_changes[i]);
+	}
+	pending_tile_changes.clear();
+}
+
 void RTileSetSource::_bind_methods() {
 	// Base tiles
 	ClassDB::bind_method(D_METHOD("get_tiles_count"), &RTileSetSource::get_tiles_count);
@@ -3785,6 +4101,7 @@ bool RTileSetAtlasSource::_set(const StringName &p_name, const Variant &p_value)
 						tiles[coords].alternatives[alternative_id] = memnew(RTileData);
 						tiles[coords].alternatives[alternative_id]->set_tile_set(tile_set);
 						tiles[coords].alternatives[alternative_id]->set_allow_transform(alternative_id > 0);
+						tiles[coords].alternatives[alternative_id]->connect("changed", this, "_tile_data_changed", varray(tiles[coords].alternatives[alternative_id]));
 						tiles[coords].alternatives_ids.push_back(alternative_id);
 					}
 					if (components.size() >= 3) {
@@ -3961,7 +4278,7 @@ void RTileSetAtlasSource::create_tile(const Vector2 p_atlas_coords, const Vector
 	tad.alternatives[0] = memnew(RTileData);
 	tad.alternatives[0]->set_tile_set(tile_set);
 	tad.alternatives[0]->set_allow_transform(false);
-	tad.alternatives[0]->connect("changed", this, "emit_changed");
+	tad.alternatives[0]->connect("changed", this, "_tile_data_changed", varray(tad.alternatives[0]));
 	tad.alternatives[0]->property_list_changed_notify();
 	tad.alternatives_ids.push_back(0);
 
@@ -4132,6 +4449,38 @@ real_t RTileSetAtlasSource::get_tile_animation_total_duration(const Vector2 p_at
 	return sum;
 }
 
+int RTileSetAtlasSource::get_tile_animation_frame_at_time(const Vector2 p_atlas_coords, double p_time, double *r_time_left) const {
+	ERR_FAIL_COND_V_MSG(!tiles.has(p_atlas_coords), 0, vformat("TileSetAtlasSource has no tile at %s.", Vector2(p_atlas_coords)));
+	const TileAlternativesData &tad = tiles[p_atlas_coords];
+
+	// The remaining time is negative when the visible frame never changes.
+	if (r_time_left) {
+		*r_time_left = -1.0;
+	}
+	real_t total_duration = get_tile_animation_total_duration(p_atlas_coords);
+	if (tad.animation_frames_durations.size() <= 1 || tad.animation_speed <= 0.0 || total_duration <= 0.0) {
+		return 0;
+	}
+
+	double time = Math::fmod(p_time, (double)(total_duration / tad.animation_speed));
+	for (int frame = 0; frame < (int)tad.animation_frames_durations.size(); frame++) {
+		double frame_duration = tad.animation_frames_durations[frame] / tad.animation_speed;
+		if (time < frame_duration) {
+			if (r_time_left) {
+				*r_time_left = frame_duration - time;
+			}
+			return frame;
+		}
+		time -= frame_duration;
+	}
+
+	// Rounding errors, the animation is about to loop.
+	if (r_time_left) {
+		*r_time_left = 0.0;
+	}
+	return tad.animation_frames_durations.size() - 1;
+}
+
 Vector2 RTileSetAtlasSource::get_tile_size_in_atlas(Vector2 p_atlas_coords) const {
 	ERR_FAIL_COND_V_MSG(!tiles.has(p_atlas_coords), Vector2(-1, -1), vformat("TileSetAtlasSource has no tile at %s.", String(p_atlas_coords)));
 
@@ -4304,6 +4653,7 @@ int RTileSetAtlasSource::create_alternative_tile(const Vector2 p_atlas_coords, i
 	tiles[p_atlas_coords].alternatives[new_alternative_id] = memnew(RTileData);
 	tiles[p_atlas_coords].alternatives[new_alternative_id]->set_tile_set(tile_set);
 	tiles[p_atlas_coords].alternatives[new_alternative_id]->set_allow_transform(true);
+	tiles[p_atlas_coords].alternatives[new_alternative_id]->connect("changed", this, "_tile_data_changed", varray(tiles[p_atlas_coords].alternatives[new_alternative_id]));
 	tiles[p_atlas_coords].alternatives[new_alternative_id]->property_list_changed_notify();
 	tiles[p_atlas_coords].alternatives_ids.push_back(new_alternative_id);
 	tiles[p_atlas_coords].alternatives_ids.sort();
@@ -4432,6 +4782,7 @@ void RTileSetAtlasSource::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_runtime_tile_texture_region", "atlas_coords", "frame"), &RTileSetAtlasSource::get_runtime_tile_texture_region);
 
 	ClassDB::bind_method(D_METHOD("_queue_update_padded_texture"), &RTileSetAtlasSource::_queue_update_padded_texture);
+	ClassDB::bind_method(D_METHOD("_tile_data_changed", "tile_data"), &RTileSetAtlasSource::_tile_data_changed);
 }
 
 RTileSetAtlasSource::~RTileSetAtlasSource() {
@@ -4518,6 +4869,19 @@ void RTileSetAtlasSource::_clear_tiles_outside_texture() {
 	}
 }
 
+void RTileSetAtlasSource::_tile_data_changed(Object *p_tile_data) {
+	// Find which tile changed. Tiles may have moved since the signal was connected.
+	for (const Map<Vector2i, TileAlternativesData>::Element *E_tile = tiles.front(); E_tile; E_tile = E_tile->next()) {
+		for (const Map<int, RTileData *>::Element *E_alternative = E_tile->value().alternatives.front(); E_alternative; E_alternative = E_alternative->next()) {
+			if (E_alternative->value() == p_tile_data) {
+				_notify_tile_changed(E_tile->key(), E_alternative->key(), E_alternative->value()->get_changed_aspects());
+				return;
+			}
+		}
+	}
+	emit_signal("changed");
+}
+
 void RTileSetAtlasSource::_queue_update_padded_texture() {
 	padded_texture_needs_update = true;
 	call_deferred("_update_padded_texture");
@@ -4672,7 +5036,7 @@ void RTileSetScenesCollectionSource::set_scene_tile_scene(int p_id, Ref<PackedSc
 	} else {
 		scenes[p_id].scene = Ref<PackedScene>();
 	}
-	emit_signal("changed");
+	_notify_tile_changed(Vector2i(), p_id, RTileSet::TILE_CHANGE_SCENES);
 }
 
 Ref<PackedScene> RTileSetScenesCollectionSource::get_scene_tile_scene(int p_id) const {
@@ -4685,7 +5049,7 @@ void RTileSetScenesCollectionSource::set_scene_tile_display_placeholder(int p_id
 
 	scenes[p_id].display_placeholder = p_display_placeholder;
 
-	emit_signal("changed");
+	_notify_tile_changed(Vector2i(), p_id, RTileSet::TILE_CHANGE_SCENES);
 }
 
 bool RTileSetScenesCollectionSource::get_scene_tile_display_placeholder(int p_id) const {
@@ -4773,6 +5137,16 @@ void RTileSetScenesCollectionSource::_bind_methods() {
 
 /////////////////////////////// TileData //////////////////////////////////////
 
+void RTileData::_emit_changed(uint32_t p_aspects) {
+	changed_aspects = p_aspects;
+	emit_signal("changed");
+	changed_aspects = RTileSet::TILE_CHANGE_ALL;
+}
+
+uint32_t RTileData::get_changed_aspects() const {
+	return changed_aspects;
+}
+
 void RTileData::set_tile_set(const RTileSet *p_tile_set) {
 	tile_set = p_tile_set;
 	notify_tile_data_properties_should_change();
@@ -5012,7 +5386,7 @@ RTileData *RTileData::duplicate() {
 void RTileData::set_flip_h(bool p_flip_h) {
 	ERR_FAIL_COND_MSG(!allow_transform && p_flip_h, "Transform is only allowed for alternative tiles (with its alternative_id != 0)");
 	flip_h = p_flip_h;
-	emit_signal("changed");
+	_emit_changed(RTileSet::TILE_CHANGE_RENDERING);
 }
 bool RTileData::get_flip_h() const {
 	return flip_h;
@@ -5021,7 +5395,7 @@ bool RTileData::get_flip_h() const {
 void RTileData::set_flip_v(bool p_flip_v) {
 	ERR_FAIL_COND_MSG(!allow_transform && p_flip_v, "Transform is only allowed for alternative tiles (with its alternative_id != 0)");
 	flip_v = p_flip_v;
-	emit_signal("changed");
+	_emit_changed(RTileSet::TILE_CHANGE_RENDERING);
 }
 
 bool RTileData::get_flip_v() const {
@@ -5031,7 +5405,7 @@ bool RTileData::get_flip_v() const {
 void RTileData::set_transpose(bool p_transpose) {
 	ERR_FAIL_COND_MSG(!allow_transform && p_transpose, "Transform is only allowed for alternative tiles (with its alternative_id != 0)");
 	transpose = p_transpose;
-	emit_signal("changed");
+	_emit_changed(RTileSet::TILE_CHANGE_RENDERING);
 }
 bool RTileData::get_transpose() const {
 	return transpose;
@@ -5039,7 +5413,7 @@ bool RTileData::get_transpose() const {
 
 void RTileData::set_texture_offset(Vector2 p_texture_offset) {
 	tex_offset = p_texture_offset;
-	emit_signal("changed");
+	_emit_changed(RTileSet::TILE_CHANGE_RENDERING);
 }
 
 Vector2 RTileData::get_texture_offset() const {
@@ -5048,7 +5422,7 @@ Vector2 RTileData::get_texture_offset() const {
 
 void RTileData::set_material(Ref<ShaderMaterial> p_material) {
 	material = p_material;
-	emit_signal("changed");
+	_emit_changed(RTileSet::TILE_CHANGE_RENDERING);
 }
 Ref<ShaderMaterial> RTileData::get_material() const {
 	return material;
@@ -5056,7 +5430,7 @@ Ref<ShaderMaterial> RTileData::get_material() const {
 
 void RTileData::set_modulate(Color p_modulate) {
 	modulate = p_modulate;
-	emit_signal("changed");
+	_emit_changed(RTileSet::TILE_CHANGE_RENDERING);
 }
 Color RTileData::get_modulate() const {
 	return modulate;
@@ -5064,7 +5438,7 @@ Color RTileData::get_modulate() const {
 
 void RTileData::set_z_index(int p_z_index) {
 	z_index = p_z_index;
-	emit_signal("changed");
+	_emit_changed(RTileSet::TILE_CHANGE_RENDERING);
 }
 int RTileData::get_z_index() const {
 	return z_index;
@@ -5072,7 +5446,7 @@ int RTileData::get_z_index() const {
 
 void RTileData::set_y_sort_origin(int p_y_sort_origin) {
 	y_sort_origin = p_y_sort_origin;
-	emit_signal("changed");
+	_emit_changed(RTileSet::TILE_CHANGE_RENDERING);
 }
 int RTileData::get_y_sort_origin() const {
 	return y_sort_origin;
@@ -5081,7 +5455,7 @@ int RTileData::get_y_sort_origin() const {
 void RTileData::set_occluder(int p_layer_id, Ref<OccluderPolygon2D> p_occluder_polygon) {
 	ERR_FAIL_INDEX(p_layer_id, occluders.size());
 	occluders.write[p_layer_id] = p_occluder_polygon;
-	emit_signal("changed");
+	_emit_changed(RTileSet::TILE_CHANGE_RENDERING);
 }
 
 Ref<OccluderPolygon2D> RTileData::get_occluder(int p_layer_id) const {
@@ -5093,7 +5467,7 @@ Ref<OccluderPolygon2D> RTileData::get_occluder(int p_layer_id) const {
 void RTileData::set_constant_linear_velocity(int p_layer_id, const Vector2 &p_velocity) {
 	ERR_FAIL_INDEX(p_layer_id, physics.size());
 	physics.write[p_layer_id].linear_velocity = p_velocity;
-	emit_signal("changed");
+	_emit_changed(RTileSet::TILE_CHANGE_PHYSICS);
 }
 
 Vector2 RTileData::get_constant_linear_velocity(int p_layer_id) const {
@@ -5104,7 +5478,7 @@ Vector2 RTileData::get_constant_linear_velocity(int p_layer_id) const {
 void RTileData::set_constant_angular_velocity(int p_layer_id, real_t p_velocity) {
 	ERR_FAIL_INDEX(p_layer_id, physics.size());
 	physics.write[p_layer_id].angular_velocity = p_velocity;
-	emit_signal("changed");
+	_emit_changed(RTileSet::TILE_CHANGE_PHYSICS);
 }
 
 real_t RTileData::get_constant_angular_velocity(int p_layer_id) const {
@@ -5120,7 +5494,7 @@ void RTileData::set_collision_polygons_count(int p_layer_id, int p_polygons_coun
 	}
 	physics.write[p_layer_id].polygons.resize(p_polygons_count);
 	property_list_changed_notify();
-	emit_signal("changed");
+	_emit_changed(RTileSet::TILE_CHANGE_PHYSICS);
 }
 
 int RTileData::get_collision_polygons_count(int p_layer_id) const {
@@ -5131,14 +5505,14 @@ int RTileData::get_collision_polygons_count(int p_layer_id) const {
 void RTileData::add_collision_polygon(int p_layer_id) {
 	ERR_FAIL_INDEX(p_layer_id, physics.size());
 	physics.write[p_layer_id].polygons.push_back(PhysicsLayerTileData::PolygonShapeTileData());
-	emit_signal("changed");
+	_emit_changed(RTileSet::TILE_CHANGE_PHYSICS);
 }
 
 void RTileData::remove_collision_polygon(int p_layer_id, int p_polygon_index) {
 	ERR_FAIL_INDEX(p_layer_id, physics.size());
 	ERR_FAIL_INDEX(p_polygon_index, physics[p_layer_id].polygons.size());
 	physics.write[p_layer_id].polygons.remove(p_polygon_index);
-	emit_signal("changed");
+	_emit_changed(RTileSet::TILE_CHANGE_PHYSICS);
 }
 
 void RTileData::set_collision_polygon_points(int p_layer_id, int p_polygon_index, Vector<Vector2> p_polygon) {
@@ -5162,7 +5536,7 @@ void RTileData::set_collision_polygon_points(int p_layer_id, int p_polygon_index
 		}
 	}
 	physics.write[p_layer_id].polygons.write[p_polygon_index].polygon = p_polygon;
-	emit_signal("changed");
+	_emit_changed(RTileSet::TILE_CHANGE_PHYSICS);
 }
 
 Vector<Vector2> RTileData::get_collision_polygon_points(int p_layer_id, int p_polygon_index) const {
@@ -5175,7 +5549,7 @@ void RTileData::set_collision_polygon_one_way(int p_layer_id, int p_polygon_inde
 	ERR_FAIL_INDEX(p_layer_id, physics.size());
 	ERR_FAIL_INDEX(p_polygon_index, physics[p_layer_id].polygons.size());
 	physics.write[p_layer_id].polygons.write[p_polygon_index].one_way = p_one_way;
-	emit_signal("changed");
+	_emit_changed(RTileSet::TILE_CHANGE_PHYSICS);
 }
 
 bool RTileData::is_collision_polygon_one_way(int p_layer_id, int p_polygon_index) const {
@@ -5188,7 +5562,7 @@ void RTileData::set_collision_polygon_one_way_margin(int p_layer_id, int p_polyg
 	ERR_FAIL_INDEX(p_layer_id, physics.size());
 	ERR_FAIL_INDEX(p_polygon_index, physics[p_layer_id].polygons.size());
 	physics.write[p_layer_id].polygons.write[p_polygon_index].one_way_margin = p_one_way_margin;
-	emit_signal("changed");
+	_emit_changed(RTileSet::TILE_CHANGE_PHYSICS);
 }
 
 float RTileData::get_collision_polygon_one_way_margin(int p_layer_id, int p_polygon_index) const {
@@ -5224,7 +5598,7 @@ void RTileData::set_terrain_set(int p_terrain_set) {
 	}
 	terrain_set = p_terrain_set;
 	property_list_changed_notify();
-	emit_signal("changed");
+	_emit_changed(RTileSet::TILE_CHANGE_TERRAINS);
 }
 
 int RTileData::get_terrain_set() const {
@@ -5240,7 +5614,7 @@ void RTileData::set_peering_bit_terrain(RTileSet::CellNeighbor p_peering_bit, in
 		ERR_FAIL_COND(!is_valid_peering_bit_terrain(p_peering_bit));
 	}
 	terrain_peering_bits[p_peering_bit] = p_terrain_index;
-	emit_signal("changed");
+	_emit_changed(RTileSet::TILE_CHANGE_TERRAINS);
 }
 
 int RTileData::get_peering_bit_terrain(RTileSet::CellNeighbor p_peering_bit) const {
@@ -5270,7 +5644,7 @@ RTileSet::TerrainsPattern RTileData::get_terrains_pattern() const {
 void RTileData::set_navigation_polygon(int p_layer_id, Ref<NavigationPolygon> p_navigation_polygon) {
 	ERR_FAIL_INDEX(p_layer_id, navigation.size());
 	navigation.write[p_layer_id] = p_navigation_polygon;
-	emit_signal("changed");
+	_emit_changed(RTileSet::TILE_CHANGE_NAVIGATION);
 }
 
 Ref<NavigationPolygon> RTileData::get_navigation_polygon(int p_layer_id) const {
@@ -5282,7 +5656,7 @@ Ref<NavigationPolygon> RTileData::get_navigation_polygon(int p_layer_id) const {
 void RTileData::set_probability(float p_probability) {
 	ERR_FAIL_COND(p_probability < 0.0);
 	probability = p_probability;
-	emit_signal("changed");
+	_emit_changed(RTileSet::TILE_CHANGE_TERRAINS);
 }
 float RTileData::get_probability() const {
 	return probability;
@@ -5306,7 +5680,7 @@ Variant RTileData::get_custom_data(String p_layer_name) const {
 void RTileData::set_custom_data_by_layer_id(int p_layer_id, Variant p_value) {
 	ERR_FAIL_INDEX(p_layer_id, custom_data.size());
 	custom_data.write[p_layer_id] = p_value;
-	emit_signal("changed");
+	_emit_changed(RTileSet::TILE_CHANGE_CUSTOM_DATA);
 }
 
 Variant RTileData::get_custom_data_by_layer_id(int p_layer_id) const {
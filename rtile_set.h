@@ -31,6 +31,9 @@
 #ifndef RTILE_SET_H
 #define RTILE_SET_H
 
+#include "core/hash_map.h"
+#include "core/math/random_pcg.h"
+#include "core/os/mutex.h"
 #include "core/resource.h"
 #include "core/object.h"
 #include "core/vector.h"
@@ -260,6 +263,23 @@ public:
 		Vector2 offset;
 	};
 
+	// What a change to a tile affects, so that maps only update what depends on it.
+	enum TileChangeAspect {
+		TILE_CHANGE_RENDERING = 1 << 0,
+		TILE_CHANGE_PHYSICS = 1 << 1,
+		TILE_CHANGE_NAVIGATION = 1 << 2,
+		TILE_CHANGE_TERRAINS = 1 << 3,
+		TILE_CHANGE_SCENES = 1 << 4,
+		TILE_CHANGE_CUSTOM_DATA = 1 << 5,
+		TILE_CHANGE_ALL = (1 << 6) - 1,
+	};
+
+	// A change to a single tile. An invalid alternative stands for all the alternatives of the tile.
+	struct TileChange {
+		RTileMapCell tile;
+		uint32_t aspects = TILE_CHANGE_ALL;
+	};
+
 	class TerrainsPattern {
 		bool valid = false;
 		int bits[RTileSet::CELL_NEIGHBOR_MAX];
@@ -284,6 +304,45 @@ public:
 		TerrainsPattern() {}
 	};
 
+	// A tile resolved from a packed cell value.
+	struct TileResolution {
+		RTileMapCell cell; // The tile the cell maps to, proxies applied.
+		RTileSetSource *source = nullptr;
+		RTileSetAtlasSource *atlas_source = nullptr; // nullptr if the source is not an atlas.
+		RTileData *tile_data = nullptr;
+		Rect2 texture_region; // Runtime texture region of the first frame.
+	};
+
+	// The patterns of a terrain set, indexed, with bitsets over the indices of the patterns having each terrain on each peering bit.
+	// Finding the patterns compatible with some constraints is a few bitwise ANDs.
+	struct TerrainsPatternsTable {
+		LocalVector<TerrainsPattern> patterns; // In the order of the pattern set.
+		LocalVector<int> patterns_terrains_counts; // The distinct terrains of each pattern, on the valid peering bits.
+		LocalVector<CellNeighbor> bits; // The valid peering bits.
+		int words_count = 1;
+		int terrains_count = 1; // Including the empty terrain (-1), at index 0.
+		LocalVector<uint64_t> masks; // Per peering bit, then terrain + 1, words_count words each. Zero for invalid bits.
+
+		// The tiles of each pattern, with an alias table over their probabilities.
+		LocalVector<uint32_t> patterns_tiles_offsets; // One more than the patterns, the tiles of a pattern are between two offsets.
+		LocalVector<RTileMapCell> tiles;
+		LocalVector<float> tiles_thresholds; // The probability to keep a drawn tile rather than its alias.
+		LocalVector<uint32_t> tiles_aliases;
+
+		// Null for terrains out of the terrain set.
+		_FORCE_INLINE_ const uint64_t *get_mask(CellNeighbor p_bit, int p_terrain) const {
+			if (p_terrain < -1 || p_terrain + 1 >= terrains_count) {
+				return nullptr;
+			}
+			return &masks[(int(p_bit) * terrains_count + p_terrain + 1) * words_count];
+		}
+
+		void fill(uint64_t *r_patterns) const;
+		void constrain(uint64_t *r_patterns, CellNeighbor p_bit, int p_terrain) const;
+		int find_pattern(const TerrainsPattern &p_pattern) const;
+		RTileMapCell pick_random_tile(int p_pattern_index, RandomPCG *p_rng = nullptr) const;
+	};
+
 protected:
 	bool _set(const StringName &p_name, const Variant &p_value);
 	bool _get(const StringName &p_name, Variant &r_ret) const;
@@ -334,6 +393,7 @@ private:
 	bool terrain_bits_meshes_dirty = true;
 
 	LocalVector<Map<RTileSet::TerrainsPattern, Set<RTileMapCell>>> per_terrain_pattern_tiles; // Cached data.
+	LocalVector<TerrainsPatternsTable> per_terrain_set_patterns_table; // Cached data.
 	bool terrains_cache_dirty = true;
 	void _update_terrains_cache();
 
@@ -362,10 +422,34 @@ private:
 	void _compute_next_source_id();
 	void _source_changed();
 
-	// Tile proxies
-	Map<int, int> source_level_proxies;
-	Map<Array, Array> coords_level_proxies;
-	Map<Array, Array> alternative_level_proxies;
+	// Log of the tile level changes, so that maps can update only the affected tiles.
+	// Any other change is a full change, which requires a full update of the maps.
+	static const uint32_t TILE_CHANGES_MAX = 1024;
+	LocalVector<TileChange> tile_changes; // The last changes, up to tile_changes_version.
+	uint64_t tile_changes_version = 0;
+	uint64_t tile_changes_full_version = 0; // The version of the last full change.
+	bool tile_changes_recorded = false; // Set while emitting a tile level change.
+
+	void _record_full_change();
+
+	// Tile proxies, keyed by packed cells. Coords level keys and values use INVALID_TILE_ALTERNATIVE as alternative.
+	HashMap<int, int> source_level_proxies;
+	HashMap<uint64_t, RTileMapCell> coords_level_proxies;
+	HashMap<uint64_t, RTileMapCell> alternative_level_proxies;
+
+	static uint64_t _get_coords_level_proxy_key(int p_source, const Vector2i &p_coords);
+	static Vector<RTileMapCell> _get_sorted_proxy_keys(const HashMap<uint64_t, RTileMapCell> &p_proxies);
+	Vector<int> _get_sorted_source_level_proxy_keys() const;
+
+	// Tiles resolution cache, keyed by the packed cell value.
+	mutable HashMap<uint64_t, TileResolution> tile_resolution_cache;
+	mutable SafeFlag tile_resolution_cache_dirty;
+	mutable Mutex tile_resolution_cache_mutex;
+	uint32_t tile_resolution_cache_version = 0;
+
+	void _invalidate_tile_resolution_cache();
+	void _rebuild_tile_resolution_cache() const;
+	void _add_proxied_tile_resolution(const RTileMapCell &p_from, const RTileMapCell &p_to) const;
 
 	// Helpers
 	Vector<Point2> _get_square_corner_or_side_terrain_bit_polygon(Vector2 p_size, RTileSet::CellNeighbor p_bit);
@@ -497,10 +581,19 @@ public:
 	Array get_alternative_level_tile_proxies() const;
 
 	Array map_tile_proxy(int p_source_from, Vector2 p_coords_from, int p_alternative_from) const;
+	RTileMapCell map_tile_proxy_fast(const RTileMapCell &p_cell) const;
+
+	// Changes log. Not exposed.
+	uint64_t get_tile_changes_version() const;
+	bool get_tile_changes_since(uint64_t p_version, LocalVector<TileChange> &r_changes) const;
 
 	void cleanup_invalid_tile_proxies();
 	void clear_tile_proxies();
 
+	// Tiles resolution.
+	const TileResolution *resolve_tile(const RTileMapCell &p_cell) const;
+	uint32_t get_tile_resolution_cache_version() const;
+
 	// Patterns.
 	int add_pattern(Ref<RTileMapPattern> p_pattern, int p_index = -1);
 	Ref<RTileMapPattern> get_pattern(int p_index);
@@ -509,8 +602,9 @@ public:
 
 	// Terrains.
 	Set<TerrainsPattern> get_terrains_pattern_set(int p_terrain_set);
+	const TerrainsPatternsTable *get_terrains_patterns_table(int p_terrain_set); // Not exposed.
 	Set<RTileMapCell> get_tiles_for_terrains_pattern(int p_terrain_set, TerrainsPattern p_terrain_tile_pattern);
-	RTileMapCell get_random_tile_from_terrains_pattern(int p_terrain_set, TerrainsPattern p_terrain_tile_pattern);
+	RTileMapCell get_random_tile_from_terrains_pattern(int p_terrain_set, TerrainsPattern p_terrain_tile_pattern, RandomPCG *p_rng = nullptr);
 
 	// Helpers
 	Vector<Vector2> get_tile_shape_polygon();
@@ -530,9 +624,20 @@ public:
 class RTileSetSource : public Resource {
 	GDCLASS(RTileSetSource, Resource);
 
+public:
+	struct TileChange {
+		Vector2i atlas_coords;
+		int alternative_tile = -1;
+		uint32_t aspects = RTileSet::TILE_CHANGE_ALL;
+	};
+
 protected:
 	const RTileSet *tile_set = nullptr;
 
+	// Tile level changes, taken by the TileSet when the source emits changed.
+	LocalVector<TileChange> pending_tile_changes;
+	void _notify_tile_changed(const Vector2i &p_atlas_coords, int p_alternative_tile, uint32_t p_aspects);
+
 	static void _bind_methods();
 
 public:
@@ -543,6 +648,7 @@ public:
 
 	// Not exposed.
 	virtual void set_tile_set(const RTileSet *p_tile_set);
+	void take_pending_tile_changes(LocalVector<TileChange> &r_changes);
 	virtual void notify_tile_data_properties_should_change(){};
 	virtual void add_occlusion_layer(int p_index){};
 	virtual void move_occlusion_layer(int p_from_index, int p_to_pos){};
@@ -620,6 +726,8 @@ private:
 	void _queue_update_padded_texture();
 	void _update_padded_texture();
 
+	void _tile_data_changed(Object *p_tile_data);
+
 protected:
 	bool _set(const StringName &p_name, const Variant &p_value);
 	bool _get(const StringName &p_name, Variant &r_ret) const;
@@ -692,6 +800,7 @@ public:
 	void set_tile_animation_frame_duration(const Vector2 p_atlas_coords, int p_frame_index, real_t p_duration);
 	real_t get_tile_animation_frame_duration(const Vector2 p_atlas_coords, int p_frame_index) const;
 	real_t get_tile_animation_total_duration(const Vector2 p_atlas_coords) const;
+	int get_tile_animation_frame_at_time(const Vector2 p_atlas_coords, double p_time, double *r_time_left = nullptr) const;
 
 	// Alternative tiles.
 	int create_alternative_tile(const Vector2 p_atlas_coords, int p_alternative_id_override = -1);
@@ -811,6 +920,10 @@ private:
 	// Custom data
 	Vector<Variant> custom_data;
 
+	// What the change being emitted affects.
+	uint32_t changed_aspects = RTileSet::TILE_CHANGE_ALL;
+	void _emit_changed(uint32_t p_aspects);
+
 protected:
 	bool _set(const StringName &p_name, const Variant &p_value);
 	bool _get(const StringName &p_name, Variant &r_ret) const;
@@ -820,6 +933,7 @@ protected:
 public:
 	// Not exposed.
 	void set_tile_set(const RTileSet *p_tile_set);
+	uint32_t get_changed_aspects() const;
 	void notify_tile_data_properties_should_change();
 	void add_occlusion_layer(int p_index);
 	void move_occlusion_layer(int p_from_index, int p_to_pos);
@@ -0,0 +1,504 @@
+# RTileMap tests. Run them with a Godot build including the module, from the engine source directory:
+#
+#     godot --no-window -s modules/rtile_map/tests/test_rtile_map.gd
+#
+# Every method starting with "test_" is run, in declaration order. The process exits with 1 if any check failed.
+extends SceneTree
+
+const SOURCE_ID = 0
+const COLLIDING_TILE = Vector2(0, 0)
+const PLAIN_TILE = Vector2(1, 0)
+
+var failures = 0
+var current_test = ""
+
+
+func _initialize():
+	call_deferred("_run_tests")
+
+
+func _run_tests():
+	for method in get_method_list():
+		if not method.name.begins_with("test_"):
+			continue
+		current_test = method.name
+		print("- ", current_test)
+		var state = call(current_test)
+		if state is GDScriptFunctionState:
+			yield(state, "completed")
+
+	if failures > 0:
+		printerr("%d check(s) failed." % failures)
+	else:
+		print("All tests passed.")
+	quit(1 if failures > 0 else 0)
+
+
+func _check(p_condition, p_message):
+	if not p_condition:
+		failures += 1
+		printerr("  FAILED in %s: %s" % [current_test, p_message])
+
+
+# Lets the deferred quadrant updates and the physics server run.
+func _wait_for_update():
+	for i in 3:
+		yield(self, "idle_frame")
+		yield(self, "physics_frame")
+
+
+# A tile set with 16x16 square tiles in one atlas. Only COLLIDING_TILE has a collision polygon, on collision layer 1.
+func _make_tile_set():
+	var tile_set = RTileSet.new()
+	tile_set.set_tile_size(Vector2(16, 16))
+	tile_set.add_physics_layer()
+	tile_set.set_physics_layer_collision_layer(0, 1)
+
+	var image = Image.new()
+	image.create(64, 16, false, Image.FORMAT_RGBA8)
+	var texture = ImageTexture.new()
+	texture.create_from_image(image)
+
+	var source = RTileSetAtlasSource.new()
+	source.set_texture(texture)
+	source.set_texture_region_size(Vector2(16, 16))
+	for x in 4:
+		source.create_tile(Vector2(x, 0))
+	tile_set.add_source(source, SOURCE_ID)
+
+	var tile_data = source.get_tile_data(COLLIDING_TILE, 0)
+	tile_data.set_collision_polygons_count(0, 1)
+	tile_data.set_collision_polygon_points(0, 0, PoolVector2Array([Vector2(-8, -8), Vector2(8, -8), Vector2(8, 8), Vector2(-8, 8)]))
+	return tile_set
+
+
+func _make_tile_map():
+	var tile_map = RTileMap.new()
+	tile_map.set_tileset(_make_tile_set())
+	root.add_child(tile_map)
+	return tile_map
+
+
+func _has_body_at(p_tile_map, p_coords):
+	var space_state = p_tile_map.get_world_2d().direct_space_state
+	return not space_state.intersect_point(p_tile_map.to_global(p_tile_map.map_to_world(p_coords))).empty()
+
+
+# The cells of the first layer, as strings in get_used_cells() order.
+func _describe_cells(p_tile_map):
+	var description = []
+	for coords in p_tile_map.get_used_cells(0):
+		description.append("%s:%d:%s:%d" % [coords, p_tile_map.get_cell_source_id(0, coords, false), p_tile_map.get_cell_atlas_coords(0, coords, false), p_tile_map.get_cell_alternative_tile(0, coords, false)])
+	return description
+
+
+# Cells over several chunks, on both sides of the origin, with many distinct cells per chunk.
+func _fill_cells(p_tile_map, p_reversed = false):
+	var cells = []
+	for y in range(-20, 20):
+		for x in range(-20, 20):
+			if (x * 7 + y * 3) % 5 != 0:
+				cells.append([Vector2(x, y), Vector2(posmod(x, 4), 0), posmod(x * 31 + y, 300)])
+	if p_reversed:
+		cells.invert()
+	for cell in cells:
+		p_tile_map.set_cell(0, cell[0], SOURCE_ID, cell[1], cell[2])
+
+
+# Cells storage.
+
+func test_used_cells_order():
+	var tile_map = RTileMap.new()
+	tile_map.set_tileset(_make_tile_set())
+	_fill_cells(tile_map)
+	var reversed = RTileMap.new()
+	reversed.set_tileset(tile_map.get_tileset())
+	_fill_cells(reversed, true)
+
+	var used_cells = tile_map.get_used_cells(0)
+	for i in range(1, used_cells.size()):
+		_check(used_cells[i - 1] < used_cells[i], "Used cells not in coordinates order at %s." % used_cells[i])
+	_check(_describe_cells(reversed) == _describe_cells(tile_map), "Used cells depend on the edits order.")
+
+	tile_map.free()
+	reversed.free()
+
+
+# Batched edits.
+
+func test_batch_with_cells_changed_several_times():
+	var tile_map = _make_tile_map()
+	tile_map.set_cell(0, Vector2(0, 0), SOURCE_ID, PLAIN_TILE, 0)
+	yield(_wait_for_update(), "completed")
+
+	tile_map.begin_batch()
+	tile_map.set_cell(0, Vector2(0, 0), SOURCE_ID, COLLIDING_TILE, 0)
+	tile_map.set_cell(0, Vector2(1, 0), SOURCE_ID, COLLIDING_TILE, 0)
+	tile_map.set_cell(0, Vector2(1, 0), -1, Vector2(-1, -1), -1)
+	tile_map.set_cell(0, Vector2(40, 0), SOURCE_ID, PLAIN_TILE, 0)
+	tile_map.set_cell(0, Vector2(40, 0), SOURCE_ID, COLLIDING_TILE, 0)
+	tile_map.end_batch()
+	yield(_wait_for_update(), "completed")
+
+	_check(tile_map.get_cell_atlas_coords(0, Vector2(0, 0), false) == COLLIDING_TILE, "Replaced cell not kept.")
+	_check(tile_map.get_cell_source_id(0, Vector2(1, 0), false) == -1, "Erased cell still set.")
+	_check(tile_map.get_cell_atlas_coords(0, Vector2(40, 0), false) == COLLIDING_TILE, "Last value of a new cell not kept.")
+	_check(_has_body_at(tile_map, Vector2(0, 0)), "No body for the replaced cell.")
+	_check(not _has_body_at(tile_map, Vector2(1, 0)), "Body left for the erased cell.")
+	_check(_has_body_at(tile_map, Vector2(40, 0)), "No body for the new quadrant.")
+
+	tile_map.free()
+
+
+func test_set_cells_packing():
+	var tile_map = RTileMap.new()
+	tile_map.set_tileset(_make_tile_set())
+	var coords = PoolVector2Array([Vector2(-3, 5), Vector2(7, -9), Vector2(2, 2)])
+	var cells = [[SOURCE_ID, Vector2(3, 0), 0], [SOURCE_ID, Vector2(-2, 300), 12], [-1, Vector2(-1, -1), -1]]
+	var packed_cells = PoolIntArray()
+	for cell in cells:
+		packed_cells.append((cell[0] & 0xFFFF) | ((int(cell[1].x) & 0xFFFF) << 16))
+		packed_cells.append((int(cell[1].y) & 0xFFFF) | ((cell[2] & 0xFFFF) << 16))
+	tile_map.set_cell(0, Vector2(2, 2), SOURCE_ID, PLAIN_TILE, 0)
+	tile_map.set_cells(0, coords, packed_cells)
+
+	for i in coords.size():
+		_check(tile_map.get_cell_source_id(0, coords[i], false) == cells[i][0], "Wrong source in cell %s." % coords[i])
+		_check(tile_map.get_cell_atlas_coords(0, coords[i], false) == cells[i][1], "Wrong atlas coords in cell %s." % coords[i])
+		_check(tile_map.get_cell_alternative_tile(0, coords[i], false) == cells[i][2], "Wrong alternative in cell %s." % coords[i])
+
+	tile_map.free()
+
+
+# Pathfinding.
+
+# Walkable tiles get their cost from the "cost" custom data layer. COLLIDING_TILE is a wall.
+func _make_pathfinding_tile_map():
+	var tile_set = _make_tile_set()
+	tile_set.add_custom_data_layer()
+	tile_set.set("custom_data_layer_0/name", "cost")
+	tile_set.set("custom_data_layer_0/type", TYPE_REAL)
+	var source = tile_set.get_source(SOURCE_ID)
+	source.get_tile_data(COLLIDING_TILE, 0).set_custom_data("cost", 0.0)
+	source.get_tile_data(PLAIN_TILE, 0).set_custom_data("cost", 1.0)
+	source.get_tile_data(Vector2(2, 0), 0).set_custom_data("cost", 3.0)
+
+	var tile_map = RTileMap.new()
+	tile_map.set_tileset(tile_set)
+	tile_map.set_pathfinding_custom_data_layer("cost")
+	return tile_map
+
+
+func test_flow_field_after_edits():
+	var region = Rect2(0, 0, 48, 48)
+	var goals = PoolVector2Array([Vector2(2, 3), Vector2(40, 44)])
+	var tile_map = _make_pathfinding_tile_map()
+	for y in 48:
+		for x in 48:
+			tile_map.set_cell(0, Vector2(x, y), SOURCE_ID, PLAIN_TILE, 0)
+	tile_map.get_flow_field_integration(0, region, goals)
+
+	# A wall with a gap and slower cells, over a few clusters of the cached field.
+	for y in range(0, 40):
+		tile_map.set_cell(0, Vector2(20, y), SOURCE_ID, COLLIDING_TILE, 0)
+	for x in range(24, 30):
+		tile_map.set_cell(0, Vector2(x, 10), SOURCE_ID, Vector2(2, 0), 0)
+	tile_map.set_cell(0, Vector2(5, 5), -1, Vector2(-1, -1), -1)
+
+	var fresh_map = _make_pathfinding_tile_map()
+	for coords in tile_map.get_used_cells(0):
+		fresh_map.set_cell(0, coords, SOURCE_ID, tile_map.get_cell_atlas_coords(0, coords, false), 0)
+	var expected = fresh_map.get_flow_field_integration(0, region, goals)
+	var integration = tile_map.get_flow_field_integration(0, region, goals)
+	_check(integration.size() == expected.size(), "Wrong flow field size.")
+	for i in min(integration.size(), expected.size()):
+		if integration[i] != expected[i]:
+			_check(false, "Cached flow field not updated at %s." % Vector2(i % 48, i / 48))
+			break
+
+	tile_map.free()
+	fresh_map.free()
+
+
+# Terrains.
+
+const TERRAIN_SIDES = [RTileSet.CELL_NEIGHBOR_RIGHT_SIDE, RTileSet.CELL_NEIGHBOR_BOTTOM_SIDE, RTileSet.CELL_NEIGHBOR_LEFT_SIDE, RTileSet.CELL_NEIGHBOR_TOP_SIDE]
+const TERRAIN_OFFSETS = [Vector2(1, 0), Vector2(0, 1), Vector2(-1, 0), Vector2(0, -1)]
+
+
+# Two terrains matched on the sides. The tile (i, 0) has the terrain (i >> side) & 1 on each side, so every combination exists.
+func _make_terrain_tile_set():
+	var tile_set = RTileSet.new()
+	tile_set.set_tile_size(Vector2(16, 16))
+	tile_set.add_terrain_set()
+	tile_set.set_terrain_set_mode(0, RTileSet.TERRAIN_MODE_MATCH_SIDES)
+	tile_set.add_terrain(0)
+	tile_set.add_terrain(0)
+
+	var image = Image.new()
+	image.create(256, 16, false, Image.FORMAT_RGBA8)
+	var texture = ImageTexture.new()
+	texture.create_from_image(image)
+
+	var source = RTileSetAtlasSource.new()
+	source.set_texture(texture)
+	source.set_texture_region_size(Vector2(16, 16))
+	tile_set.add_source(source, SOURCE_ID)
+	for i in 16:
+		source.create_tile(Vector2(i, 0))
+		var tile_data = source.get_tile_data(Vector2(i, 0), 0)
+		tile_data.set_terrain_set(0)
+		for side in TERRAIN_SIDES.size():
+			tile_data.set_peering_bit_terrain(TERRAIN_SIDES[side], (i >> side) & 1)
+	return tile_set
+
+
+func _get_side_terrain(p_tile_map, p_coords, p_side):
+	var tile_data = p_tile_map.get_tileset().get_source(SOURCE_ID).get_tile_data(p_tile_map.get_cell_atlas_coords(0, p_coords, false), 0)
+	return tile_data.get_peering_bit_terrain(TERRAIN_SIDES[p_side])
+
+
+# Fills the inside of a ring of fixed cells.
+func _fill_terrains(p_tile_map):
+	var inside = []
+	for y in range(0, 10):
+		for x in range(0, 10):
+			if x == 0 or y == 0 or x == 9 or y == 9:
+				p_tile_map.set_cell(0, Vector2(x, y), SOURCE_ID, Vector2(posmod(x * 5 + y * 3, 16), 0), 0)
+			else:
+				inside.append(Vector2(x, y))
+	p_tile_map.set_cells_from_surrounding_terrains(0, inside, 0)
+	return inside
+
+
+func test_terrains_fill():
+	var tile_map = RTileMap.new()
+	tile_map.set_tileset(_make_terrain_tile_set())
+	seed(1234)
+	var inside = _fill_terrains(tile_map)
+
+	for coords in inside:
+		_check(tile_map.get_cell_source_id(0, coords, false) == SOURCE_ID, "Cell %s not filled." % coords)
+		if tile_map.get_cell_source_id(0, coords, false) != SOURCE_ID:
+			continue
+		for side in TERRAIN_SIDES.size():
+			var neighbor = coords + TERRAIN_OFFSETS[side]
+			var neighbor_terrain = _get_side_terrain(tile_map, neighbor, (side + 2) % 4)
+			_check(_get_side_terrain(tile_map, coords, side) == neighbor_terrain, "Terrains differ between %s and %s." % [coords, neighbor])
+
+	# The same seed gives the same tiles.
+	var other = RTileMap.new()
+	other.set_tileset(tile_map.get_tileset())
+	seed(1234)
+	_fill_terrains(other)
+	_check(_describe_cells(other) == _describe_cells(tile_map), "Fill not reproducible with the same seed.")
+
+	tile_map.free()
+	other.free()
+
+
+# Batched edits over existing quadrants.
+
+func test_set_pattern_over_existing_tiles():
+	var tile_map = _make_tile_map()
+	for x in 4:
+		tile_map.set_cell(0, Vector2(x, 0), SOURCE_ID, COLLIDING_TILE, 0)
+	yield(_wait_for_update(), "completed")
+	for x in 4:
+		_check(_has_body_at(tile_map, Vector2(x, 0)), "No body for the painted cell %d." % x)
+
+	# Replaces the colliding tiles of existing quadrants, through a batch.
+	var pattern = RTileMapPattern.new()
+	for x in 2:
+		pattern.set_cell(Vector2(x, 0), SOURCE_ID, PLAIN_TILE, 0)
+	tile_map.set_pattern(0, Vector2(0, 0), pattern)
+	yield(_wait_for_update(), "completed")
+
+	for x in 4:
+		var expected_tile = PLAIN_TILE if x < 2 else COLLIDING_TILE
+		_check(tile_map.get_cell_atlas_coords(0, Vector2(x, 0), false) == expected_tile, "Wrong tile in cell %d after set_pattern()." % x)
+		_check(_has_body_at(tile_map, Vector2(x, 0)) == (x >= 2), "Collision not updated in cell %d after set_pattern()." % x)
+
+	tile_map.free()
+
+
+# Serialization.
+
+func _copy_tile_data(p_from, p_to):
+	p_to.set("format", p_from.get("format"))
+	p_to.set("layer_0/tile_data", p_from.get("layer_0/tile_data"))
+
+
+func test_tile_data_round_trip():
+	for compression in [RTileMap.TILE_DATA_COMPRESSION_NONE, RTileMap.TILE_DATA_COMPRESSION_DEFLATE, RTileMap.TILE_DATA_COMPRESSION_ZSTD]:
+		var tile_map = RTileMap.new()
+		tile_map.set_tileset(_make_tile_set())
+		tile_map.set_tile_data_compression(compression)
+		_fill_cells(tile_map)
+		tile_map.set_cell(0, Vector2(0, 0), -1, Vector2(-1, -1), -1)
+
+		var loaded = RTileMap.new()
+		loaded.set_tileset(tile_map.get_tileset())
+		_copy_tile_data(tile_map, loaded)
+		_check(_describe_cells(loaded) == _describe_cells(tile_map), "Cells differ after a round trip with compression %d." % compression)
+
+		# The saved data only depends on the cells, not on the order they were set in.
+		var reversed = RTileMap.new()
+		reversed.set_tileset(tile_map.get_tileset())
+		reversed.set_tile_data_compression(compression)
+		_fill_cells(reversed, true)
+		reversed.set_cell(0, Vector2(0, 0), -1, Vector2(-1, -1), -1)
+		_check(reversed.get("layer_0/tile_data") == tile_map.get("layer_0/tile_data"), "Saved data depends on the edits order, with compression %d." % compression)
+
+		tile_map.free()
+		loaded.free()
+		reversed.free()
+
+
+# Streaming.
+
+# Waits for the streamer to read the region of p_coords, until the cell has the expected source.
+func _wait_for_streamed_cell(p_tile_map, p_coords, p_source_id):
+	for i in 120:
+		if p_tile_map.get_cell_source_id(0, p_coords, false) == p_source_id:
+			break
+		yield(self, "idle_frame")
+	yield(_wait_for_update(), "completed")
+
+
+func _remove_directory(p_path):
+	var directory = Directory.new()
+	if directory.open(p_path) != OK:
+		return
+	directory.list_dir_begin(true)
+	var file_name = directory.get_next()
+	while file_name != "":
+		directory.remove(file_name)
+		file_name = directory.get_next()
+	directory.list_dir_end()
+	directory.remove(p_path)
+
+
+func _check_streamed_cells(p_tile_map, p_message):
+	_check(p_tile_map.get_cell_atlas_coords(0, Vector2(1, 1), false) == PLAIN_TILE, "Set cell lost %s." % p_message)
+	_check(p_tile_map.get_cell_atlas_coords(0, Vector2(-3, -2), false) == COLLIDING_TILE, "Set cell lost %s." % p_message)
+	_check(p_tile_map.get_cell_source_id(0, Vector2(5, 7), false) == -1, "Erased cell back %s." % p_message)
+
+
+func test_streaming_regions():
+	var path = "user://test_rtile_map_streaming"
+	_remove_directory(path)
+
+	# Only the regions around the origin are loaded.
+	var tile_map = _make_tile_map()
+	tile_map.set_use_update_focus_point(true)
+	tile_map.set_update_focus_point(Vector2())
+	tile_map.set_streaming_load_distance(256)
+	tile_map.set_streaming_unload_distance(256)
+	tile_map.set_streaming_directory(path)
+	_check(tile_map.is_streaming(), "Streaming not started.")
+
+	tile_map.set_cell(0, Vector2(1, 1), SOURCE_ID, PLAIN_TILE, 0)
+	tile_map.set_cell(0, Vector2(5, 7), SOURCE_ID, PLAIN_TILE, 0)
+	tile_map.set_cell(0, Vector2(-3, -2), SOURCE_ID, COLLIDING_TILE, 0)
+	yield(_wait_for_update(), "completed")
+	tile_map.set_cell(0, Vector2(5, 7), -1, Vector2(-1, -1), -1)
+	_check_streamed_cells(tile_map, "while streaming")
+
+	# Moving the focus away evicts the regions, moving it back reads them again.
+	tile_map.set_update_focus_point(Vector2(100000, 100000))
+	yield(_wait_for_streamed_cell(tile_map, Vector2(1, 1), -1), "completed")
+	_check(tile_map.get_cell_source_id(0, Vector2(1, 1), false) == -1, "Region not evicted.")
+	tile_map.set_update_focus_point(Vector2())
+	yield(_wait_for_streamed_cell(tile_map, Vector2(1, 1), SOURCE_ID), "completed")
+	_check_streamed_cells(tile_map, "after reloading the region")
+
+	# Stopping writes the regions back and drops the cells.
+	tile_map.set_streaming_directory("")
+	_check(not tile_map.is_streaming(), "Streaming not stopped.")
+	_check(tile_map.get_used_cells(0).empty(), "Streamed cells kept after stopping.")
+	tile_map.set_streaming_directory(path)
+	yield(_wait_for_streamed_cell(tile_map, Vector2(1, 1), SOURCE_ID), "completed")
+	_check_streamed_cells(tile_map, "after restarting the streaming")
+
+	tile_map.free()
+	_remove_directory(path)
+
+
+# Base files.
+
+func test_base_file_overlay():
+	var path = "user://test_rtile_map_base.rtmc"
+	var source_map = RTileMap.new()
+	source_map.set_tileset(_make_tile_set())
+	_fill_cells(source_map)
+	_check(source_map.save_layer_base_file(0, path) == OK, "Cannot save the base file.")
+
+	var tile_map = RTileMap.new()
+	tile_map.set_tileset(source_map.get_tileset())
+	tile_map.set_layer_base_file(0, path)
+	_check(tile_map.get("layer_0/base_file") == path, "Base file not saved with the layer.")
+	_check(_describe_cells(tile_map) == _describe_cells(source_map), "Cells differ from the saved base.")
+
+	# Overlay: a replaced cell, an erased cell, a fully erased base chunk and a new chunk.
+	tile_map.set_cell(0, Vector2(1, 1), SOURCE_ID, Vector2(3, 0), 7)
+	tile_map.set_cell(0, Vector2(-5, 3), -1, Vector2(-1, -1), -1)
+	for y in range(-16, 0):
+		for x in range(-16, 0):
+			tile_map.set_cell(0, Vector2(x, y), -1, Vector2(-1, -1), -1)
+	tile_map.set_cell(0, Vector2(100, 100), SOURCE_ID, PLAIN_TILE, 0)
+
+	var loaded = RTileMap.new()
+	loaded.set_tileset(source_map.get_tileset())
+	loaded.set_layer_base_file(0, path)
+	_copy_tile_data(tile_map, loaded)
+	_check(_describe_cells(loaded) == _describe_cells(tile_map), "Cells differ after reloading the overlay.")
+
+	# A corrupted overlay leaves the base cells.
+	var corrupted = RTileMap.new()
+	corrupted.set_tileset(source_map.get_tileset())
+	corrupted.set_layer_base_file(0, path)
+	corrupted.set("format", tile_map.get("format"))
+	var data = tile_map.get("layer_0/tile_data")
+	data.resize(data.size() - 5)
+	corrupted.set("layer_0/tile_data", data)
+	_check(_describe_cells(corrupted) == _describe_cells(source_map), "Corrupted overlay partially applied.")
+
+	source_map.free()
+	tile_map.free()
+	loaded.free()
+	corrupted.free()
+	Directory.new().remove(path)
+
+
+func test_base_file_overlays_in_a_row():
+	var path = "user://test_rtile_map_base_overlays.rtmc"
+	var source_map = RTileMap.new()
+	source_map.set_tileset(_make_tile_set())
+	_fill_cells(source_map)
+	_check(source_map.save_layer_base_file(0, path) == OK, "Cannot save the base file.")
+
+	# Two overlays changing different base cells.
+	var first = RTileMap.new()
+	first.set_tileset(source_map.get_tileset())
+	first.set_layer_base_file(0, path)
+	first.set_cell(0, Vector2(1, 2), SOURCE_ID, Vector2(3, 0), 7)
+	var second = RTileMap.new()
+	second.set_tileset(source_map.get_tileset())
+	second.set_layer_base_file(0, path)
+	second.set_cell(0, Vector2(3, 2), -1, Vector2(-1, -1), -1)
+
+	# Each overlay applies over the base alone.
+	var tile_map = RTileMap.new()
+	tile_map.set_tileset(source_map.get_tileset())
+	tile_map.set_layer_base_file(0, path)
+	_copy_tile_data(first, tile_map)
+	_check(_describe_cells(tile_map) == _describe_cells(first), "Cells differ after setting the first overlay.")
+	_copy_tile_data(second, tile_map)
+	_check(_describe_cells(tile_map) == _describe_cells(second), "The previous overlay is kept under the new one.")
+
+	source_map.free()
+	first.free()
+	second.free()
+	tile_map.free()
+	Directory.new().remove(path)
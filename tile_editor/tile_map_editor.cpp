@@ -3498,11 +3498,7 @@ void RTileMapEditor::_advanced_menu_button_id_pressed(int p_id) {
 			for (int i = 0; i < used_cells.size(); i++) {
 				Vector2i cell_coords = used_cells[i];
 				RTileMapCell from = tile_map->get_cell(layer_index, cell_coords);
-				Array to_array = tile_set->map_tile_proxy(from.source_id, from.get_atlas_coords(), from.alternative_tile);
-				RTileMapCell to;
-				to.source_id = to_array[0];
-				to.set_atlas_coords(to_array[1]);
-				to.alternative_tile = to_array[2];
+				RTileMapCell to = tile_set->map_tile_proxy_fast(from);
 				if (from != to) {
 					undo_redo->add_do_method(tile_map, "set_cell", tile_map_layer, Vector2(cell_coords), to.source_id, to.get_atlas_coords(), to.alternative_tile);
 					undo_redo->add_undo_method(tile_map, "set_cell", tile_map_layer, Vector2(cell_coords), from.source_id, from.get_atlas_coords(), from.alternative_tile);